@@ -0,0 +1,89 @@
+// Benchmark de buddy_alloc_batch / buddy_free_batch contra n llamadas sueltas
+// a buddy_alloc / buddy_free.
+//
+// Cada iteración pide n bloques del mismo tamaño, escribe un byte en cada uno
+// y los libera todos (como un handler que arma sus buffers y los suelta
+// juntos). Se mide en millones de bloques por segundo (alloc + free).
+//
+// Uso: ./buddy_batch_bench [bloques por tamaño]
+
+#define _POSIX_C_SOURCE 200809L // Para clock_gettime con -std=c11
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "buddy_system.h"
+
+#define MAX_BATCH 256
+
+static double now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Devuelve millones de bloques por segundo; -1 si algo falló
+static double run(buddy_system_t *buddy, size_t size, size_t n, long total, int batch) {
+    void *ptrs[MAX_BATCH];
+    long rounds = total / (long)n;
+    double start = now();
+    for (long r = 0; r < rounds; r++) {
+        if (batch) {
+            if (buddy_alloc_batch(buddy, size, n, ptrs) != n) return -1;
+        } else {
+            for (size_t i = 0; i < n; i++) {
+                ptrs[i] = buddy_alloc(buddy, size);
+                if (!ptrs[i]) return -1;
+            }
+        }
+        for (size_t i = 0; i < n; i++) *(volatile char*)ptrs[i] = (char)i;
+        if (batch) {
+            buddy_free_batch(buddy, ptrs, n);
+        } else {
+            for (size_t i = 0; i < n; i++) buddy_free(buddy, ptrs[i]);
+        }
+    }
+    return rounds * (double)n / (now() - start) / 1e6;
+}
+
+int main(int argc, char **argv) {
+    long total = argc > 1 ? atol(argv[1]) : 1000000;
+    static const size_t sizes[] = {32, 256, 4096};
+    static const size_t counts[] = {16, 64, 256};
+    static const char *modes[] = {"un hilo", "concurrente", "slabs"};
+
+    printf("=== Batch contra llamadas sueltas ===\n");
+    printf("%ld bloques por medicion (Mbloques/s)\n\n", total);
+    printf("%-12s %6s %5s %10s %10s %8s\n", "modo", "tamano", "n", "sueltas", "batch", "mejora");
+
+    int failed = 0;
+    for (int mode = 0; mode < 3; mode++) {
+        for (size_t si = 0; si < sizeof(sizes) / sizeof(sizes[0]); si++) {
+            for (size_t ci = 0; ci < sizeof(counts) / sizeof(counts[0]); ci++) {
+                buddy_config_t config = {.reserve_size = (size_t)1 << 30, .chunk_size = (size_t)1 << 22,
+                                         .concurrent = mode == 1, .slabs = mode == 2};
+                buddy_system_t *buddy = buddy_init_ex(&config);
+                if (!buddy) {
+                    printf("Error: No se pudo inicializar el buddy system\n");
+                    return 1;
+                }
+                // Una pasada de calentamiento para que la arena ya haya crecido
+                run(buddy, sizes[si], counts[ci], counts[ci] * 4, 1);
+                double single = run(buddy, sizes[si], counts[ci], total, 0);
+                double batch = run(buddy, sizes[si], counts[ci], total, 1);
+                buddy_stats_t stats;
+                buddy_get_stats(buddy, &stats);
+                if (single < 0 || batch < 0 || stats.allocs != stats.frees || stats.bad_frees) failed = 1;
+                printf("%-12s %6zu %5zu %10.2f %10.2f %7.2fx\n", modes[mode], sizes[si], counts[ci],
+                       single, batch, batch / single);
+                buddy_destroy(buddy);
+            }
+        }
+    }
+    if (failed) {
+        printf("\nFALLO: alguna asignacion no se pudo hacer o no cuadraron los contadores\n");
+        return 1;
+    }
+    return 0;
+}
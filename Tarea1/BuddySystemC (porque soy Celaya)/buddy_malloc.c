@@ -0,0 +1,504 @@
+// Reemplazo de malloc/free sobre el buddy system, para cargar en cualquier
+// programa sin recompilarlo:
+//
+//   LD_PRELOAD=./libbuddymalloc.so BUDDY_MALLOC_STATS=1 programa
+//
+// Todo sale de una sola arena concurrente (con slabs) que se crea en el
+// primer malloc. Los pedidos de BUDDY_MALLOC_MMAP_THRESHOLD bytes o más, y
+// los que no entran en la arena, van directo a mmap con un header de 16
+// bytes antes del puntero. Como en glibc, todo pedido de más de 8 bytes
+// sale alineado a 16.
+//
+// Arranque: crear la arena no llama a malloc, pero por las dudas una llamada
+// que entre mientras se crea (desde el mismo hilo) se sirve con mmap directo;
+// los demás hilos esperan a que termine. Si la arena no se puede crear, todo
+// va a mmap.
+//
+// Variables de entorno (se leen en el primer malloc):
+//   BUDDY_MALLOC_RESERVE          Tamaño de la arena, potencia de 2 (4G)
+//   BUDDY_MALLOC_MMAP_THRESHOLD   Desde cuántos bytes se usa mmap (1M)
+//   BUDDY_MALLOC_SLABS=0          Sin slabs
+//   BUDDY_MALLOC_HUGE=1           Páginas grandes transparentes
+//   BUDDY_MALLOC_STATS=1|archivo  Al salir, estadísticas en stderr o al
+//                                 final del archivo
+//   BUDDY_MALLOC_TRACE=archivo    Graba una traza para buddy_trace en
+//                                 archivo.<pid> (cada proceso la suya).
+//                                 Mientras graba, las operaciones van de a una.
+// Los tamaños aceptan sufijo K, M o G.
+
+#define _GNU_SOURCE // mremap
+
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include "buddy_system.h"
+
+#define EXPORT __attribute__((visibility("default")))
+#define LOCAL_TLS __thread __attribute__((tls_model("initial-exec")))
+
+#define DEFAULT_RESERVE ((size_t)4 << 30)
+#define DEFAULT_CHUNK ((size_t)4 << 20)
+#define DEFAULT_MMAP_THRESHOLD ((size_t)1 << 20)
+#define TRACE_BUFFER 65536
+#define TRACE_THREADS 64      // buddy_trace reproduce hasta 64 hilos
+
+enum { HEAP_UNINIT, HEAP_STARTING, HEAP_READY, HEAP_FAILED };
+
+static buddy_system_t *heap;
+static _Atomic int heap_state;
+static size_t mmap_threshold = DEFAULT_MMAP_THRESHOLD;
+static size_t page_size = 4096;
+static LOCAL_TLS int in_init;
+
+// Pedidos servidos directo con mmap
+static _Atomic uint64_t big_live, big_bytes, big_peak, big_total;
+
+// Grabación de trazas
+static int trace_fd = -1;
+static pthread_mutex_t trace_lock = PTHREAD_MUTEX_INITIALIZER;
+static char trace_buf[TRACE_BUFFER];
+static size_t trace_len;
+static _Atomic int trace_threads;
+static LOCAL_TLS int trace_tid = -1;
+
+static int stats_fd = -1;
+
+// --- mmap directo ---
+// Antes del puntero va dónde empieza el mapeo y cuánto mide
+
+typedef struct {
+    size_t length;
+    size_t offset;  // Del inicio del mapeo al puntero
+} big_header_t;
+
+static void big_account(int64_t blocks, int64_t bytes) {
+    atomic_fetch_add_explicit(&big_live, (uint64_t)blocks, memory_order_relaxed);
+    uint64_t now = atomic_fetch_add_explicit(&big_bytes, (uint64_t)bytes, memory_order_relaxed) + (uint64_t)bytes;
+    uint64_t peak = atomic_load_explicit(&big_peak, memory_order_relaxed);
+    while (bytes > 0 && now > peak &&
+           !atomic_compare_exchange_weak_explicit(&big_peak, &peak, now, memory_order_relaxed, memory_order_relaxed)) {
+    }
+}
+
+static void* big_alloc(size_t size, size_t align) {
+    if (align < sizeof(big_header_t)) align = sizeof(big_header_t);
+    size_t slack = align > page_size ? align : 0;
+    if (size > SIZE_MAX - slack - align - page_size) return NULL;
+    size_t length = (size + align + slack + page_size - 1) & ~(page_size - 1);
+    uint8_t *base = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (base == MAP_FAILED) return NULL;
+    // base está alineado a página: con align <= página alcanza con saltear align
+    uint8_t *ptr = (uint8_t*)(((uintptr_t)base + sizeof(big_header_t) + align - 1) & ~(uintptr_t)(align - 1));
+    big_header_t *h = (big_header_t*)ptr - 1;
+    h->length = length;
+    h->offset = (size_t)(ptr - base);
+    big_account(1, (int64_t)length);
+    atomic_fetch_add_explicit(&big_total, 1, memory_order_relaxed);
+    return ptr;
+}
+
+static big_header_t* big_header(void *ptr) {
+    return (big_header_t*)ptr - 1;
+}
+
+static size_t big_usable(void *ptr) {
+    big_header_t *h = big_header(ptr);
+    return h->length - h->offset;
+}
+
+static void big_free(void *ptr) {
+    big_header_t *h = big_header(ptr);
+    size_t length = h->length;
+    big_account(-1, -(int64_t)length);
+    munmap((uint8_t*)ptr - h->offset, length);
+}
+
+// mremap mueve el mapeo entero, así el header y el desplazamiento se conservan
+static void* big_realloc(void *ptr, size_t size) {
+    big_header_t *h = big_header(ptr);
+    size_t offset = h->offset, length = h->length;
+    if (size > SIZE_MAX - offset - page_size) return NULL;
+    size_t new_length = (offset + size + page_size - 1) & ~(page_size - 1);
+    if (new_length == length) return ptr;
+    uint8_t *base = mremap((uint8_t*)ptr - offset, length, new_length, MREMAP_MAYMOVE);
+    if (base == MAP_FAILED) return NULL;
+    ((big_header_t*)(base + offset) - 1)->length = new_length;
+    big_account(0, (int64_t)new_length - (int64_t)length);
+    return base + offset;
+}
+
+// --- Arranque ---
+
+static size_t env_size(const char *name, size_t fallback) {
+    const char *value = getenv(name);
+    if (!value || !*value) return fallback;
+    char *end;
+    unsigned long long n = strtoull(value, &end, 10);
+    if (*end == 'K' || *end == 'k') n <<= 10;
+    else if (*end == 'M' || *end == 'm') n <<= 20;
+    else if (*end == 'G' || *end == 'g') n <<= 30;
+    return n ? (size_t)n : fallback;
+}
+
+static void atfork_prepare(void) {
+    pthread_mutex_lock(&trace_lock);
+    buddy_atfork_prepare(heap);
+}
+
+static void atfork_parent(void) {
+    buddy_atfork_parent(heap);
+    pthread_mutex_unlock(&trace_lock);
+}
+
+// El hijo no graba: escribiría en el mismo archivo que el padre
+static void atfork_child(void) {
+    buddy_atfork_child(heap);
+    trace_fd = -1;
+    trace_len = 0;
+    pthread_mutex_unlock(&trace_lock);
+}
+
+static buddy_system_t* init_heap(void) {
+    // Una llamada desde adentro del arranque se arregla con mmap directo
+    if (in_init) return NULL;
+    int expected = HEAP_UNINIT;
+    if (!atomic_compare_exchange_strong(&heap_state, &expected, HEAP_STARTING)) {
+        int state;
+        while ((state = atomic_load_explicit(&heap_state, memory_order_acquire)) == HEAP_STARTING) sched_yield();
+        return state == HEAP_READY ? heap : NULL;
+    }
+
+    in_init = 1;
+    long page = sysconf(_SC_PAGESIZE);
+    if (page > 0) page_size = (size_t)page;
+    mmap_threshold = env_size("BUDDY_MALLOC_MMAP_THRESHOLD", DEFAULT_MMAP_THRESHOLD);
+    const char *slabs = getenv("BUDDY_MALLOC_SLABS");
+    const char *huge = getenv("BUDDY_MALLOC_HUGE");
+    buddy_config_t config = {.reserve_size = env_size("BUDDY_MALLOC_RESERVE", DEFAULT_RESERVE),
+                             .chunk_size = DEFAULT_CHUNK,
+                             .huge_pages = huge && *huge == '1' ? BUDDY_HUGE_TRANSPARENT : BUDDY_HUGE_NONE,
+                             .concurrent = 1,
+                             .slabs = !(slabs && *slabs == '0')};
+    if (config.chunk_size > config.reserve_size) config.chunk_size = config.reserve_size;
+    heap = buddy_init_ex(&config);
+
+    const char *stats = getenv("BUDDY_MALLOC_STATS");
+    if (stats && *stats) {
+        stats_fd = strcmp(stats, "1") == 0 ? STDERR_FILENO
+                                           : open(stats, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    }
+    const char *trace = getenv("BUDDY_MALLOC_TRACE");
+    if (trace && *trace) {
+        char path[4096];
+        if (snprintf(path, sizeof(path), "%s.%d", trace, (int)getpid()) < (int)sizeof(path)) {
+            trace_fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        }
+    }
+    pthread_atfork(atfork_prepare, atfork_parent, atfork_child);
+    in_init = 0;
+    atomic_store_explicit(&heap_state, heap ? HEAP_READY : HEAP_FAILED, memory_order_release);
+    return heap;
+}
+
+static inline buddy_system_t* get_heap(void) {
+    if (atomic_load_explicit(&heap_state, memory_order_acquire) == HEAP_READY) return heap;
+    return init_heap();
+}
+
+static inline int in_heap(buddy_system_t *b, void *ptr) {
+    return b && (uintptr_t)ptr - (uintptr_t)b->memory_pool < b->total_size;
+}
+
+// --- Grabación (con trace_lock tomado) ---
+
+static void trace_flush(void) {
+    size_t done = 0;
+    while (done < trace_len) {
+        ssize_t n = write(trace_fd, trace_buf + done, trace_len - done);
+        if (n <= 0) break;
+        done += (size_t)n;
+    }
+    trace_len = 0;
+}
+
+static void trace_put_u64(uint64_t n, int hex) {
+    char digits[24];
+    int len = 0;
+    do {
+        digits[len++] = "0123456789abcdef"[hex ? n & 15 : n % 10];
+        n = hex ? n >> 4 : n / 10;
+    } while (n);
+    if (hex) {
+        trace_buf[trace_len++] = '0';
+        trace_buf[trace_len++] = 'x';
+    }
+    while (len) trace_buf[trace_len++] = digits[--len];
+}
+
+// Una línea del formato de buddy_trace; el id es la dirección del bloque
+static void trace_record(char op, void *ptr, size_t size) {
+    if (trace_fd < 0 || !ptr) return;
+    if (trace_len > TRACE_BUFFER - 80) trace_flush();
+    if (trace_tid < 0) trace_tid = atomic_fetch_add(&trace_threads, 1) % TRACE_THREADS;
+    trace_buf[trace_len++] = op;
+    trace_buf[trace_len++] = ' ';
+    trace_put_u64((uintptr_t)ptr, 1);
+    if (op != 'f') {
+        trace_buf[trace_len++] = ' ';
+        trace_put_u64(size, 0);
+    }
+    trace_buf[trace_len++] = ' ';
+    trace_put_u64((uint64_t)trace_tid, 0);
+    trace_buf[trace_len++] = '\n';
+}
+
+// --- Implementación ---
+
+// Como glibc: más de 8 bytes se redondea a 16 para que quede alineado a 16
+static inline size_t malloc_size(size_t size) {
+    if (size <= 8) return size ? size : 1;
+    return size <= SIZE_MAX - 15 ? (size + 15) & ~(size_t)15 : size;
+}
+
+static void* do_malloc(size_t size) {
+    buddy_system_t *b = get_heap();
+    void *p = NULL;
+    if (b && size < mmap_threshold) p = buddy_alloc(b, malloc_size(size));
+    if (!p) p = big_alloc(size, 16);
+    if (!p) errno = ENOMEM;
+    return p;
+}
+
+static void do_free(void *ptr) {
+    if (!ptr) return;
+    buddy_system_t *b = get_heap();
+    if (in_heap(b, ptr)) buddy_free(b, ptr);
+    else big_free(ptr);
+}
+
+static size_t usable_size(void *ptr) {
+    if (!ptr) return 0;
+    buddy_system_t *b = get_heap();
+    return in_heap(b, ptr) ? buddy_usable_size(b, ptr) : big_usable(ptr);
+}
+
+static void* do_realloc(void *ptr, size_t size) {
+    if (!ptr) return do_malloc(size);
+    if (size == 0) {
+        do_free(ptr);
+        return NULL;
+    }
+    buddy_system_t *b = get_heap();
+    void *p = NULL;
+    if (in_heap(b, ptr)) {
+        // En el lugar si se puede (o copiando dentro de la arena)
+        if (size < mmap_threshold) p = buddy_realloc(b, ptr, malloc_size(size));
+        if (p) return p;
+    } else {
+        p = big_realloc(ptr, size);
+        if (p || size >= mmap_threshold) {
+            if (!p) errno = ENOMEM;
+            return p;
+        }
+    }
+    // Cambia de lugar entre la arena y mmap
+    p = do_malloc(size);
+    if (!p) return NULL;
+    size_t old = usable_size(ptr);
+    memcpy(p, ptr, old < size ? old : size);
+    do_free(ptr);
+    return p;
+}
+
+static void* do_aligned(size_t align, size_t size) {
+    if (align <= 16) return do_malloc(size);
+    buddy_system_t *b = get_heap();
+    void *p = NULL;
+    if (b && size < mmap_threshold && align <= b->base_align) {
+        p = buddy_aligned_alloc(b, align, malloc_size(size));
+    }
+    if (!p) p = big_alloc(size, align);
+    if (!p) errno = ENOMEM;
+    return p;
+}
+
+// --- Interfaz de malloc ---
+// Mientras se graba una traza cada operación se hace y se anota con el lock
+// tomado, así el orden del archivo es el orden real.
+
+// Arranca antes de mirar trace_fd, así también se graba el primer malloc
+static inline int recording(void) {
+    get_heap();
+    return trace_fd >= 0;
+}
+
+EXPORT void* malloc(size_t size) {
+    if (!recording()) return do_malloc(size);
+    pthread_mutex_lock(&trace_lock);
+    void *p = do_malloc(size);
+    trace_record('a', p, size);
+    pthread_mutex_unlock(&trace_lock);
+    return p;
+}
+
+EXPORT void free(void *ptr) {
+    if (!recording()) {
+        do_free(ptr);
+        return;
+    }
+    pthread_mutex_lock(&trace_lock);
+    trace_record('f', ptr, 0);
+    do_free(ptr);
+    pthread_mutex_unlock(&trace_lock);
+}
+
+// No se llama a malloc: gcc convierte malloc + memset en calloc y esto se
+// llamaría a sí mismo
+EXPORT void* calloc(size_t n, size_t size) {
+    if (size && n > SIZE_MAX / size) {
+        errno = ENOMEM;
+        return NULL;
+    }
+    int rec = recording();
+    if (rec) pthread_mutex_lock(&trace_lock);
+    void *p = do_malloc(n * size);
+    // Lo que viene de mmap ya está en cero
+    if (p && in_heap(heap, p)) memset(p, 0, n * size);
+    if (rec) {
+        trace_record('a', p, n * size);
+        pthread_mutex_unlock(&trace_lock);
+    }
+    return p;
+}
+
+EXPORT void* realloc(void *ptr, size_t size) {
+    if (!recording()) return do_realloc(ptr, size);
+    pthread_mutex_lock(&trace_lock);
+    void *p = do_realloc(ptr, size);
+    if (p == ptr) {
+        trace_record('r', p, size);
+    } else if (p || size == 0) {
+        // Si se movió, en la traza es asignar el nuevo y liberar el viejo
+        trace_record('a', p, size);
+        trace_record('f', ptr, 0);
+    }
+    pthread_mutex_unlock(&trace_lock);
+    return p;
+}
+
+EXPORT void* reallocarray(void *ptr, size_t n, size_t size) {
+    if (size && n > SIZE_MAX / size) {
+        errno = ENOMEM;
+        return NULL;
+    }
+    return realloc(ptr, n * size);
+}
+
+static void* aligned(size_t align, size_t size) {
+    if (!recording()) return do_aligned(align, size);
+    pthread_mutex_lock(&trace_lock);
+    void *p = do_aligned(align, size);
+    trace_record('a', p, size);
+    pthread_mutex_unlock(&trace_lock);
+    return p;
+}
+
+EXPORT int posix_memalign(void **memptr, size_t align, size_t size) {
+    if (align < sizeof(void*) || (align & (align - 1)) != 0) return EINVAL;
+    int saved = errno;
+    void *p = aligned(align, size);
+    errno = saved;
+    if (!p) return ENOMEM;
+    *memptr = p;
+    return 0;
+}
+
+EXPORT void* aligned_alloc(size_t align, size_t size) {
+    if (align == 0 || (align & (align - 1)) != 0) {
+        errno = EINVAL;
+        return NULL;
+    }
+    return aligned(align, size);
+}
+
+// memalign redondea la alineación a potencia de 2, como glibc
+EXPORT void* memalign(size_t align, size_t size) {
+    size_t a = 16;
+    while (a < align && a <= SIZE_MAX / 2) a <<= 1;
+    return aligned(a, size);
+}
+
+EXPORT void* valloc(size_t size) {
+    get_heap();
+    return aligned(page_size, size);
+}
+
+EXPORT void* pvalloc(size_t size) {
+    get_heap();
+    if (size > SIZE_MAX - page_size) {
+        errno = ENOMEM;
+        return NULL;
+    }
+    return aligned(page_size, (size + page_size - 1) & ~(page_size - 1));
+}
+
+EXPORT size_t malloc_usable_size(void *ptr) {
+    return usable_size(ptr);
+}
+
+// --- Estadísticas al salir ---
+
+static double mib(uint64_t bytes) {
+    return bytes / (1024.0 * 1024.0);
+}
+
+__attribute__((destructor)) static void buddy_malloc_exit(void) {
+    if (trace_fd >= 0) {
+        pthread_mutex_lock(&trace_lock);
+        trace_flush();
+        pthread_mutex_unlock(&trace_lock);
+    }
+    if (stats_fd < 0) return;
+
+    char out[2048];
+    int len = snprintf(out, sizeof(out), "=== buddy_malloc (pid %d) ===\n", (int)getpid());
+    if (heap) {
+        buddy_stats_t s;
+        buddy_get_stats(heap, &s);
+        double frag = s.granted_bytes ? 100.0 * (s.granted_bytes - s.requested_bytes) / s.granted_bytes : 0;
+        len += snprintf(out + len, sizeof(out) - len,
+                        "Arena: %.1f MiB reservados, %.2f MiB agregados en %" PRIu64 " chunks, %" PRIu64
+                        " devueltos al sistema\n"
+                        "En uso al salir: %.2f MiB en bloques, %.2f MiB en caches, %.2f MiB libres en slabs\n"
+                        "Pico (usados + en caches): %.2f MiB\n"
+                        "Operaciones: %" PRIu64 " allocs, %" PRIu64 " frees, %" PRIu64 " sin memoria, %" PRIu64
+                        " punteros invalidos\n"
+                        "Fragmentacion interna: %.2f%% (%" PRIu64 " bytes pedidos, %" PRIu64 " entregados)\n",
+                        mib(s.total_size), mib(s.committed_bytes), s.chunks_added, s.chunks_released,
+                        mib(s.used_bytes), mib(s.cached_bytes), mib(s.slab_free_bytes), mib(s.high_water),
+                        s.allocs, s.frees, s.failed_allocs, s.bad_frees, frag, s.requested_bytes,
+                        s.granted_bytes);
+    } else {
+        len += snprintf(out + len, sizeof(out) - len, "No se pudo crear la arena: todo fue con mmap\n");
+    }
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    len += snprintf(out + len, sizeof(out) - len,
+                    "mmap directo: %" PRIu64 " pedidos, %" PRIu64 " vivos (%.2f MiB), pico %.2f MiB\n"
+                    "RSS maximo del proceso: %.2f MiB\n",
+                    atomic_load(&big_total), atomic_load(&big_live), mib(atomic_load(&big_bytes)),
+                    mib(atomic_load(&big_peak)), usage.ru_maxrss / 1024.0);
+    if (len > (int)sizeof(out)) len = sizeof(out);
+    if (write(stats_fd, out, (size_t)len) < 0) return;
+}
@@ -0,0 +1,172 @@
+// Prueba de estrés multihilo del buddy system en modo concurrente.
+//
+// Cada hilo hace alloc/free al azar de bloques chicos (16 a 128 bytes) sobre
+// su propio arreglo de punteros vivos y, cada tanto, intercambia un puntero
+// con otro hilo a través de un arreglo compartido, así también hay
+// liberaciones desde un hilo distinto al que asignó. Se corre con 1, 2, 4...
+// hasta la cantidad de núcleos y se compara contra malloc/free de la libc.
+// El buddy es una arena que arranca con un chunk y crece según haga falta, y
+// se prueba también con slabs.
+//
+// Uso: ./buddy_stress [operaciones por hilo] [hilos maximos]
+
+#define _POSIX_C_SOURCE 200809L // Para clock_gettime con -std=c11
+
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "buddy_system.h"
+
+#define RESERVE_SIZE ((size_t)1 << 30)  // Arena de hasta 1 GiB...
+#define CHUNK_SIZE ((size_t)1 << 22)    // ...que crece de a 4 MiB
+#define LIVE_SLOTS 256        // Punteros vivos por hilo
+#define SHARED_SLOTS 1024     // Arreglo para pasar punteros entre hilos
+
+typedef struct {
+    buddy_system_t *buddy;  // NULL = usar malloc/free
+    long ops;
+    unsigned seed;
+    long errors;
+} worker_args_t;
+
+static _Atomic(unsigned char*) shared[SHARED_SLOTS];
+
+static void* do_alloc(buddy_system_t *buddy, size_t size) {
+    return buddy ? buddy_alloc(buddy, size) : malloc(size);
+}
+
+static void do_free(buddy_system_t *buddy, void *p) {
+    if (buddy) buddy_free(buddy, p);
+    else free(p);
+}
+
+static void* worker(void *arg) {
+    worker_args_t *w = arg;
+    unsigned char *live[LIVE_SLOTS] = {0};
+    unsigned s = w->seed;
+    for (long op = 0; op < w->ops; op++) {
+        s = s * 1103515245u + 12345u;
+        int i = (s >> 8) % LIVE_SLOTS;
+        if ((s & 15) == 0) {
+            // Intercambio con otro hilo: el que recibimos lo liberaremos nosotros
+            int j = (s >> 16) % SHARED_SLOTS;
+            live[i] = atomic_exchange(&shared[j], live[i]);
+        } else if (live[i]) {
+            // El primer byte guarda el tamaño: si cambió, alguien pisó el bloque
+            if (live[i][1] != (unsigned char)(live[i][0] ^ 0xA5)) w->errors++;
+            do_free(w->buddy, live[i]);
+            live[i] = NULL;
+        } else {
+            size_t size = 16 + (s >> 20) % 113;
+            live[i] = do_alloc(w->buddy, size);
+            if (live[i]) {
+                live[i][0] = (unsigned char)size;
+                live[i][1] = (unsigned char)(size ^ 0xA5);
+            }
+        }
+    }
+    for (int i = 0; i < LIVE_SLOTS; i++) {
+        if (live[i]) do_free(w->buddy, live[i]);
+    }
+    return NULL;
+}
+
+static double now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Corre threads hilos y devuelve millones de operaciones por segundo
+static double run(buddy_system_t *buddy, int threads, long ops, long *errors) {
+    pthread_t tids[256];
+    worker_args_t args[256];
+    double start = now();
+    for (int t = 0; t < threads; t++) {
+        args[t] = (worker_args_t){buddy, ops, 12345u + 7919u * t, 0};
+        pthread_create(&tids[t], NULL, worker, &args[t]);
+    }
+    for (int t = 0; t < threads; t++) {
+        pthread_join(tids[t], NULL);
+        *errors += args[t].errors;
+    }
+    double elapsed = now() - start;
+    // Lo que quedó en el arreglo compartido se libera al final
+    for (int j = 0; j < SHARED_SLOTS; j++) {
+        unsigned char *p = atomic_exchange(&shared[j], NULL);
+        if (p) do_free(buddy, p);
+    }
+    if (buddy) buddy_thread_flush(buddy);
+    return threads * ops / elapsed / 1e6;
+}
+
+// Corre la prueba sobre una arena nueva (con o sin slabs), revisa que todo
+// haya vuelto al núcleo y deja los contadores finales en stats
+static double run_buddy(int threads, long ops, int slabs, long *errors, buddy_stats_t *stats) {
+    buddy_config_t config = {.reserve_size = RESERVE_SIZE, .chunk_size = CHUNK_SIZE,
+                             .concurrent = 1, .slabs = slabs};
+    buddy_system_t *buddy = buddy_init_ex(&config);
+    if (!buddy) {
+        printf("Error: No se pudo inicializar el buddy system\n");
+        exit(1);
+    }
+    double mops = run(buddy, threads, ops, errors);
+
+    // Todo volvió al núcleo y cada chunk se fusionó en bloques de un chunk o
+    // más (con slabs queda a lo sumo un slab vacío por clase)
+    buddy_get_stats(buddy, stats);
+    size_t large_free = 0;
+    for (int k = find_order(CHUNK_SIZE); k <= stats->max_order; k++) {
+        large_free += (size_t)stats->free_blocks[k] * ((size_t)MIN_BLOCK_SIZE << k);
+    }
+    int merged = slabs ? stats->slab_free_bytes == stats->slab_bytes : large_free == stats->committed_bytes;
+    if (stats->used_bytes != 0 || stats->cached_bytes != 0 || stats->allocs != stats->frees || !merged) {
+        printf("Error: quedaron %zu bytes asignados y %zu en caches\n",
+               stats->used_bytes, stats->cached_bytes);
+        (*errors)++;
+    }
+    buddy_destroy(buddy);
+    return mops;
+}
+
+static double internal_fragmentation(const buddy_stats_t *stats) {
+    return (double)(stats->granted_bytes - stats->requested_bytes) / stats->granted_bytes * 100.0;
+}
+
+int main(int argc, char **argv) {
+    long ops = argc > 1 ? atol(argv[1]) : 2000000;
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    int max_threads = argc > 2 ? atoi(argv[2]) : (cores > 0 ? (int)cores : 1);
+    if (max_threads > 256) max_threads = 256;
+
+    printf("=== Estres del Buddy System concurrente ===\n");
+    printf("%ld operaciones por hilo, hasta %d hilos\n\n", ops, max_threads);
+    printf("%6s %14s %10s %14s %14s\n", "hilos", "buddy Mops/s", "escala", "slabs Mops/s", "malloc Mops/s");
+
+    long errors = 0;
+    double base = 0;
+    buddy_stats_t plain, slabs;
+    for (int t = 1; t <= max_threads; t = (t * 2 <= max_threads || t == max_threads) ? t * 2 : max_threads) {
+        double mops = run_buddy(t, ops, 0, &errors, &plain);
+        double slab_mops = run_buddy(t, ops, 1, &errors, &slabs);
+        double libc = run(NULL, t, ops, &errors);
+        if (t == 1) base = mops;
+        printf("%6d %14.2f %9.2fx %14.2f %14.2f\n", t, mops, mops / base, slab_mops, libc);
+        if (t == max_threads) break;
+    }
+
+    // Los pedidos son de 16 a 128 bytes: sin slabs se redondean a potencia de 2
+    printf("\nFragmentacion interna: %.2f%% solo buddy, %.2f%% con slabs\n",
+           internal_fragmentation(&plain), internal_fragmentation(&slabs));
+
+    if (errors) {
+        printf("\nFALLO: %ld errores\n", errors);
+        return 1;
+    }
+    printf("\nSin errores: ningun bloque se piso y todo se libero\n");
+    return 0;
+}
@@ -1,353 +1,1771 @@
+#define _DEFAULT_SOURCE // MAP_ANONYMOUS, MADV_* con -std=c11
+
+#include <inttypes.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdint.h>
 #include <string.h>
-#include <math.h>
-
-// Definimos el tamaño total de la memoria y el tamaño mínimo de bloque
-#define MEMORY_SIZE 1024  // Memoria total (debe ser potencia de 2)
-#define MIN_BLOCK_SIZE 16 // Bloque más pequeño (potencia de 2)
-
-// Estructura para los bloques de memoria
-typedef struct block {
-    size_t size;
-    int is_free;
-    struct block *next;
-    struct block *prev;
-    struct block *buddy;
-} block_t;
-
-// Estructura principal del sistema buddy
+
+#if defined(__unix__) || defined(__APPLE__)
+#define BUDDY_HAS_MMAP 1
+#include <sys/mman.h>
+#include <unistd.h>
+#else
+#define BUDDY_HAS_MMAP 0
+#endif
+
+#include "buddy_system.h"
+
+// Los bloques asignados no llevan header: el puntero que recibe el usuario
+// es el inicio del bloque. El estado de cada bloque vive en dos bitmaps por
+// orden (libre / asignado) y el buddy de un bloque se calcula con
+// offset XOR tamaño, así que no hace falta guardar nada dentro del bloque.
+//
+// Modo concurrente (buddy_init_concurrent): el núcleo (listas libres y
+// bitmaps) se protege con un mutex, pero los bloques chicos casi nunca llegan
+// a él. Cada hilo tiene una caché por orden; alloc y free de bloques chicos
+// solo tocan la caché del hilo. Cuando la caché se vacía se rellena de a
+// MAG_SIZE / 2 bloques con el lock tomado; cuando se llena, la mitad se
+// empuja con un CAS a una pila compartida (remote_free) que el próximo que
+// tome el lock devuelve al núcleo y fusiona. Un bloque se puede liberar desde
+// cualquier hilo: va a la caché del hilo que lo libera. Para el núcleo un
+// bloque en una caché sigue asignado; cached_bits lo marca para que un
+// segundo free (o buddy_usable_size) lo vea como libre.
+//
+// La arena (buddy_init_ex) reserva espacio virtual para total_size bytes pero
+// solo usa memoria real desde 0 hasta committed. Cuando no hay bloque libre se
+// agrega el siguiente chunk como bloque libre (y se fusiona con sus vecinos,
+// así también hay bloques más grandes que un chunk). Cuando al liberar queda
+// libre un chunk entero, sus páginas vuelven al sistema operativo; la primera
+// página del bloque libre se conserva porque ahí vive su enlace.
+//
+// Con slabs (config.slabs) los pedidos de hasta 512 bytes no redondean a
+// potencia de 2: cada clase de tamaño toma bloques de 4 KiB (clases de hasta
+// 128 bytes) o 16 KiB del buddy y los corta en objetos iguales, sin header.
+// El slab tiene al inicio un header con su lista de objetos libres; un byte
+// por página de 4 KiB (page_kind) dice si la página es de un slab y de qué
+// tamaño, así buddy_free encuentra el header con una máscara.
+//
+// El asignador no imprime nada: cada operación pasa por el hook de trazas
+// (si hay uno) y actualiza contadores que se leen con buddy_get_stats.
+//
+// Modo debug (-DBUDDY_DEBUG=1): como los bloques no tienen header, cada
+// asignación pide DEBUG_EXTRA bytes de más y los usa al final del bloque:
+// después de los bytes pedidos va un canario y en los últimos 16 bytes un
+// trailer con el tamaño pedido y un checksum (que también depende de la
+// dirección y de si el bloque está vivo o liberado). buddy_free valida el
+// puntero (que sea de la arena, que esté asignado, trailer y canario), llena
+// el bloque con DEBUG_POISON y lo deja en una cuarentena; recién cuando sale
+// de ella se libera de verdad, después de comprobar que nadie lo escribió.
+// Las listas libres se desenlazan verificando a los vecinos. Nada de esto se
+// compila en el modo normal.
+
+// Compilar con -DBUDDY_TRACE=0 quita las llamadas al hook por completo
+#ifndef BUDDY_TRACE
+#define BUDDY_TRACE 1
+#endif
+
+#if BUDDY_TRACE
+#define TRACE(buddy, event, ptr, size, order)                              \
+    do {                                                                   \
+        if ((buddy)->trace)                                                \
+            (buddy)->trace((event), (ptr), (size), (order), (buddy)->trace_ctx); \
+    } while (0)
+#else
+// sizeof no evalúa nada: solo evita avisos de parámetros sin usar
+#define TRACE(buddy, event, ptr, size, order) ((void)sizeof(ptr), (void)sizeof(size), (void)sizeof(order))
+#endif
+
+#ifndef BUDDY_DEBUG
+#define BUDDY_DEBUG 0
+#endif
+
+typedef char min_block_fits_links[(MIN_BLOCK_SIZE >= sizeof(free_block_t) &&
+                                   MIN_BLOCK_SIZE >= sizeof(remote_block_t)) ? 1 : -1];
+
+// Caché de bloques chicos de un hilo. Cuando el hilo termina, la caché se
+// vacía y queda libre para el próximo hilo nuevo; nunca se borra hasta
+// buddy_destroy, así buddy_get_stats puede recorrer la lista sin lock.
+typedef struct thread_cache {
+    buddy_system_t *buddy;
+    void *blocks[MAG_ORDERS][MAG_SIZE];
+    int count[MAG_ORDERS];
+    _Atomic int in_use;
+    // Contadores de este hilo (solo él los escribe)
+    _Atomic uint64_t allocs[MAG_ORDERS];
+    _Atomic uint64_t frees[MAG_ORDERS];
+    _Atomic uint64_t requested;
+    struct thread_cache *next;
+} thread_cache_t;
+
+// Objetos por slab como máximo: el slab más chico (4 KiB) con objetos de 8
+#define SLAB_MAX_OBJECTS (4096 / 8)
+
+// Header al inicio de cada slab; los objetos van después
+typedef struct slab {
+    struct slab *next;  // Lista de slabs con lugar de su clase
+    struct slab *prev;
+    void *free_list;    // Objetos liberados (enlazados dentro de ellos)
+    uint32_t bump;      // Offset del primer objeto que nunca se usó
+    uint32_t used;
+    uint32_t capacity;
+    uint32_t size_class;
+    _Atomic uint64_t live[SLAB_MAX_OBJECTS / 64];  // 1 = objeto asignado (para ver frees repetidos)
+} slab_t;
+
+#define SLAB_HEADER ((sizeof(slab_t) + 15) & ~(size_t)15)
+#define SLAB_PAGE_SHIFT 12
+
+static const uint32_t slab_sizes[BUDDY_SLAB_CLASSES] = {8, 16, 24, 32, 48, 64, 96, 128, 192, 256, 384, 512};
+
+// Clase para un pedido de size bytes: slab_class_of[(size + 7) / 8]
+static const uint8_t slab_class_of[BUDDY_SLAB_MAX / 8 + 1] = {
+    0, 0, 1, 2, 3, 4, 4, 5, 5, 6, 6, 6, 6, 7, 7, 7, 7, 8, 8, 8, 8, 8,
+    8, 8, 8, 9, 9, 9, 9, 9, 9, 9, 9, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+    10, 10, 10, 10, 10, 10, 10, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11,
+    11, 11, 11, 11};
+
+// --- Modo debug: formato de los bloques ---
+
+#define DEBUG_TRAILER 16         // sizeof(debug_trailer_t)
+#define DEBUG_EXTRA 24           // Trailer + al menos 8 bytes de canario
+#define DEBUG_CANARY 0xCA        // Entre lo pedido y el trailer
+#define DEBUG_POISON 0xDD        // Bloques liberados
+#define DEBUG_LIVE 0x6C6976656C697665ULL
+#define DEBUG_FREED 0x6672656564667265ULL
+#define QUARANTINE_SLOTS 1024
+#define QUARANTINE_BYTES ((size_t)4 << 20)
+#define QUARANTINE_EVICT 4       // Máximo de bloques que saca de la cuarentena cada free
+
+// Últimos 16 bytes de un bloque (u objeto de slab) en modo debug
 typedef struct {
-    void *memory_pool;
-    block_t **free_lists;
-    int max_order;
-    size_t total_size;
-    size_t used_memory;
-    size_t overhead_memory;
-    double max_coverage;  // Para guardar el máximo de cobertura alcanzado
-} buddy_system_t;
+    uint64_t size;   // Bytes pedidos
+    uint64_t check;  // debug_seal(bloque, size, DEBUG_LIVE o DEBUG_FREED)
+} debug_trailer_t;
+
+// Cola circular de bloques liberados que esperan para volver al asignador.
+// Sale el más viejo cuando se llena o cuando pasa de QUARANTINE_BYTES.
+typedef struct quarantine {
+    pthread_mutex_t lock;  // Solo en modo concurrente
+    size_t head, count;
+    size_t bytes;
+    void *blocks[QUARANTINE_SLOTS];
+    size_t usable[QUARANTINE_SLOTS];
+} quarantine_t;
+
+// --- Operaciones de bits ---
+
+static inline int bit_test(const uint64_t *bits, size_t i) {
+    return (bits[i >> 6] >> (i & 63)) & 1;
+}
+
+static inline void bit_set(uint64_t *bits, size_t i) {
+    bits[i >> 6] |= (uint64_t)1 << (i & 63);
+}
+
+static inline void bit_clear(uint64_t *bits, size_t i) {
+    bits[i >> 6] &= ~((uint64_t)1 << (i & 63));
+}
+
+// El bitmap de asignados (y el de objetos vivos de cada slab) se lee sin
+// lock desde buddy_free, así que sus palabras son atómicas. Solo se escribe
+// con el lock tomado (o en modo de un hilo), por eso alcanza con load +
+// store en vez de fetch_or / fetch_and.
+static inline int used_test(_Atomic uint64_t *bits, size_t i) {
+    return (atomic_load_explicit(&bits[i >> 6], memory_order_acquire) >> (i & 63)) & 1;
+}
+
+static inline void used_set(_Atomic uint64_t *bits, size_t i) {
+    uint64_t w = atomic_load_explicit(&bits[i >> 6], memory_order_relaxed);
+    atomic_store_explicit(&bits[i >> 6], w | ((uint64_t)1 << (i & 63)), memory_order_release);
+}
+
+static inline void used_clear(_Atomic uint64_t *bits, size_t i) {
+    uint64_t w = atomic_load_explicit(&bits[i >> 6], memory_order_relaxed);
+    atomic_store_explicit(&bits[i >> 6], w & ~((uint64_t)1 << (i & 63)), memory_order_release);
+}
+
+// El bitmap de bloques en cachés lo escriben los hilos dueños de cada caché
+// sin lock, así que ahí sí hace falta fetch_or / fetch_and. Devuelven el bit
+// anterior: marcar un bloque que ya estaba en una caché es un free repetido.
+static inline int cached_mark(_Atomic uint64_t *bits, size_t i) {
+    uint64_t mask = (uint64_t)1 << (i & 63);
+    return (atomic_fetch_or_explicit(&bits[i >> 6], mask, memory_order_acq_rel) & mask) != 0;
+}
+
+static inline void cached_unmark(_Atomic uint64_t *bits, size_t i) {
+    atomic_fetch_and_explicit(&bits[i >> 6], ~((uint64_t)1 << (i & 63)), memory_order_acq_rel);
+}
+
+// Contador con un solo escritor (quien tiene el lock, o el dueño de la
+// caché): load + store relajados, sin lectura-modificación-escritura atómica
+static inline void counter_add(_Atomic uint64_t *c, uint64_t n) {
+    atomic_store_explicit(c, atomic_load_explicit(c, memory_order_relaxed) + n, memory_order_relaxed);
+}
+
+static inline void counter_sub(_Atomic uint64_t *c, uint64_t n) {
+    atomic_store_explicit(c, atomic_load_explicit(c, memory_order_relaxed) - n, memory_order_relaxed);
+}
+
+static inline uint64_t counter_get(_Atomic uint64_t *c) {
+    return atomic_load_explicit(c, memory_order_relaxed);
+}
+
+// Posición del bit más alto (x > 0)
+static inline int highest_bit(uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return 63 - __builtin_clzll(x);
+#else
+    int r = 0;
+    while (x >>= 1) r++;
+    return r;
+#endif
+}
+
+// Posición del bit más bajo (x > 0)
+static inline int lowest_bit(uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(x);
+#else
+    int r = 0;
+    while (!(x & 1)) {
+        x >>= 1;
+        r++;
+    }
+    return r;
+#endif
+}
 
 // Calcula el orden máximo (cuántas veces se puede dividir la memoria)
 int calculate_max_order(size_t total_size, size_t min_block_size) {
-    int order = 0;
-    size_t block_size = total_size;
-    while (block_size >= min_block_size) {
-        order++;
-        block_size /= 2;
+    return highest_bit(total_size) - highest_bit(min_block_size);
+}
+
+// Bit del bloque que empieza en offset dentro del bitmap del orden dado
+static inline size_t block_bit(buddy_system_t *buddy, size_t offset, int order) {
+    return buddy->bit_base[order] + (offset >> (MIN_BLOCK_SHIFT + order));
+}
+
+static inline size_t block_offset(buddy_system_t *buddy, void *block) {
+    return (size_t)((uint8_t*)block - (uint8_t*)buddy->memory_pool);
+}
+
+#if BUDDY_DEBUG
+static const char *const fault_names[] = {
+    "puntero fuera del buddy", "puntero no asignado", "doble free", "trailer corrupto",
+    "desborde (canario pisado)", "uso despues de free", "lista libre corrupta"};
+
+// Avisa una falla al hook (y vuelve, para que la operación se ignore) o, si
+// no hay hook o las listas ya no son confiables, la imprime y aborta
+static void debug_fault(buddy_system_t *buddy, void *ptr, buddy_fault_t fault) {
+    atomic_fetch_add_explicit(&buddy->faults, 1, memory_order_relaxed);
+#if BUDDY_TRACE
+    if (buddy->trace) {
+        buddy->trace(BUDDY_EV_CORRUPTION, ptr, 0, (int)fault, buddy->trace_ctx);
+        if (fault != BUDDY_FAULT_FREE_LIST) return;
     }
-    return order - 1;
+#endif
+    fprintf(stderr, "buddy: %s en %p\n", fault_names[fault], ptr);
+    abort();
 }
 
-// Inicializa el sistema buddy
-buddy_system_t* buddy_init(size_t total_size) {
-    buddy_system_t *buddy = malloc(sizeof(buddy_system_t));
+// Un enlace de lista libre válido: alineado y dentro de la parte usable
+static int debug_link_ok(buddy_system_t *buddy, free_block_t *link) {
+    size_t offset = (uintptr_t)link - (uintptr_t)buddy->memory_pool;
+    return offset < counter_get(&buddy->committed) && (offset & (MIN_BLOCK_SIZE - 1)) == 0;
+}
+#endif
+
+// --- Listas libres (doblemente enlazadas dentro de los bloques libres) ---
+
+static void push_free(buddy_system_t *buddy, size_t offset, int order) {
+    free_block_t *block = (free_block_t*)((uint8_t*)buddy->memory_pool + offset);
+    block->prev = NULL;
+    block->next = buddy->free_lists[order];
+    if (block->next) block->next->prev = block;
+    buddy->free_lists[order] = block;
+    bit_set(buddy->free_bits, block_bit(buddy, offset, order));
+    counter_add(&buddy->free_count[order], 1);
+}
+
+static void remove_free(buddy_system_t *buddy, size_t offset, int order) {
+    free_block_t *block = (free_block_t*)((uint8_t*)buddy->memory_pool + offset);
+#if BUDDY_DEBUG
+    // Antes de tocar a los vecinos: tienen que apuntar a este bloque
+    if (!bit_test(buddy->free_bits, block_bit(buddy, offset, order)) ||
+        (block->next && (!debug_link_ok(buddy, block->next) || block->next->prev != block)) ||
+        (block->prev ? !debug_link_ok(buddy, block->prev) || block->prev->next != block
+                     : buddy->free_lists[order] != block)) {
+        debug_fault(buddy, block, BUDDY_FAULT_FREE_LIST);
+    }
+#endif
+    if (block->prev) block->prev->next = block->next;
+    else buddy->free_lists[order] = block->next;
+    if (block->next) block->next->prev = block->prev;
+    bit_clear(buddy->free_bits, block_bit(buddy, offset, order));
+    counter_sub(&buddy->free_count[order], 1);
+}
+
+// --- Memoria del sistema operativo ---
+// Sin mmap (Windows) la arena se pide entera con malloc y no crece ni
+// devuelve memoria.
+
+#define BUDDY_DEFAULT_CHUNK ((size_t)64 << 20)
+#define BUDDY_THP_SIZE ((size_t)2 << 20)
+
+static size_t os_page_size(void) {
+#if BUDDY_HAS_MMAP
+    long page = sysconf(_SC_PAGESIZE);
+    return page > 0 ? (size_t)page : 4096;
+#else
+    return 4096;
+#endif
+}
+
+// Reserva size bytes de espacio virtual sin memoria detrás
+static void* os_reserve(size_t size, buddy_huge_t huge, size_t align) {
+#if BUDDY_HAS_MMAP
+#ifndef MAP_HUGETLB
+    if (huge == BUDDY_HUGE_EXPLICIT) return NULL;
+#endif
+    // Pedimos align de más y recortamos, así las páginas grandes quedan alineadas
+    size_t slack = align > os_page_size() ? align : 0;
+    uint8_t *p = mmap(NULL, size + slack, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (p == MAP_FAILED) return NULL;
+    if (slack) {
+        uint8_t *aligned = (uint8_t*)(((uintptr_t)p + align - 1) & ~(uintptr_t)(align - 1));
+        if (aligned > p) munmap(p, aligned - p);
+        if (aligned + size < p + size + slack) munmap(aligned + size, p + slack - aligned);
+        p = aligned;
+    }
+#ifdef MADV_HUGEPAGE
+    if (huge == BUDDY_HUGE_TRANSPARENT) madvise(p, size, MADV_HUGEPAGE);
+#endif
+    return p;
+#else
+    (void)align;
+    return huge == BUDDY_HUGE_NONE ? malloc(size) : NULL;
+#endif
+}
+
+// Hace usable [p, p + size) (p y size alineados a página). Las páginas
+// explícitas se mapean encima de la reserva: así el kernel las aparta ahora y
+// el mmap falla si no alcanzan, en vez de un SIGBUS al tocarlas.
+static int os_commit(void *p, size_t size, buddy_huge_t huge) {
+#if BUDDY_HAS_MMAP
+#ifdef MAP_HUGETLB
+    if (huge == BUDDY_HUGE_EXPLICIT) {
+        return mmap(p, size, PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED | MAP_HUGETLB, -1, 0) != MAP_FAILED;
+    }
+#endif
+    (void)huge;
+    return mprotect(p, size, PROT_READ | PROT_WRITE) == 0;
+#else
+    (void)p;
+    (void)size;
+    (void)huge;
+    return 1;
+#endif
+}
+
+// Devuelve las páginas al sistema: siguen usables y vuelven en cero
+static void os_release(void *p, size_t size) {
+#if BUDDY_HAS_MMAP
+    madvise(p, size, MADV_DONTNEED);
+#else
+    (void)p;
+    (void)size;
+#endif
+}
+
+static void os_unmap(void *p, size_t size) {
+#if BUDDY_HAS_MMAP
+    munmap(p, size);
+#else
+    (void)size;
+    free(p);
+#endif
+}
+
+// Memoria en cero para los metadatos: las páginas que nunca se tocan (bitmaps
+// de chunks que no se agregaron) no ocupan memoria real
+static void* os_alloc_zeroed(size_t size) {
+#if BUDDY_HAS_MMAP
+    void *p = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    return p == MAP_FAILED ? NULL : p;
+#else
+    return calloc(1, size);
+#endif
+}
+
+static void free_metadata(buddy_system_t *buddy) {
+#if BUDDY_DEBUG
+    pthread_mutex_destroy(&buddy->quarantine->lock);
+#endif
+    if (buddy->memory_pool) os_unmap(buddy->memory_pool, buddy->total_size);
+    os_unmap(buddy, buddy->metadata_size);
+}
+
+static void merge_buddies(buddy_system_t *buddy, size_t offset, int order);
+
+// Agrega el siguiente chunk a la arena. Devuelve 0 si ya no hay espacio
+// reservado. En modo concurrente se llama con el lock tomado.
+static int grow(buddy_system_t *buddy) {
+    size_t chunk = (size_t)MIN_BLOCK_SIZE << buddy->chunk_order;
+    size_t offset = counter_get(&buddy->committed);
+    if (offset >= buddy->total_size) return 0;
+
+    // Con chunks más chicos que una página se habilita la página entera
+    size_t page = buddy->page_size;
+    size_t first = offset & ~(page - 1);
+    size_t last = (offset + chunk + page - 1) & ~(page - 1);
+    if (!os_commit((uint8_t*)buddy->memory_pool + first, last - first, buddy->huge_pages)) return 0;
+
+    atomic_store_explicit(&buddy->committed, offset + chunk, memory_order_relaxed);
+    counter_add(&buddy->chunks_added, 1);
+    push_free(buddy, offset, buddy->chunk_order);
+    merge_buddies(buddy, offset, buddy->chunk_order);
+    return 1;
+}
+
+// Devuelve al sistema las páginas enteras de [start, end)
+static void release_range(buddy_system_t *buddy, size_t start, size_t end) {
+    size_t page = buddy->page_size;
+    start = (start + page - 1) & ~(page - 1);
+    end &= ~(page - 1);
+    if (start >= end) return;
+    os_release((uint8_t*)buddy->memory_pool + start, end - start);
+}
+
+// Devuelve al sistema el chunk que empieza en offset si sigue libre (puede
+// ser parte de un bloque libre más grande). La primera página del bloque
+// libre se conserva porque ahí vive su enlace.
+static void purge_chunk(buddy_system_t *buddy, size_t offset) {
+    for (int k = buddy->chunk_order; k <= buddy->max_order; k++) {
+        size_t head = offset & ~(((size_t)MIN_BLOCK_SIZE << k) - 1);
+        if (bit_test(buddy->free_bits, block_bit(buddy, head, k))) {
+            size_t chunk = (size_t)MIN_BLOCK_SIZE << buddy->chunk_order;
+            release_range(buddy, offset == head ? offset + buddy->page_size : offset, offset + chunk);
+            counter_add(&buddy->chunks_released, 1);
+            return;
+        }
+    }
+}
+
+// Anota un chunk que quedó libre entero. Los últimos BUDDY_RETAIN_CHUNKS se
+// quedan en memoria y recién el más viejo se devuelve: así un chunk que se
+// libera y se vuelve a usar enseguida no paga madvise y page faults cada vez.
+static void chunk_freed(buddy_system_t *buddy, size_t offset) {
+    for (int i = 0; i < buddy->retained; i++) {
+        if (buddy->retain[i] == offset) return;
+    }
+    if (buddy->retained < BUDDY_RETAIN_CHUNKS) {
+        buddy->retain[buddy->retained++] = offset;
+        return;
+    }
+    size_t oldest = buddy->retain[0];
+    memmove(buddy->retain, buddy->retain + 1, (BUDDY_RETAIN_CHUNKS - 1) * sizeof(size_t));
+    buddy->retain[BUDDY_RETAIN_CHUNKS - 1] = offset;
+    purge_chunk(buddy, oldest);
+}
+
+// Crea la arena según la configuración (ya completada con los valores por defecto)
+static buddy_system_t* buddy_create(const buddy_config_t *config) {
+    size_t total_size = config->reserve_size;
+    size_t chunk = config->chunk_size;
+    // Todos los tamaños tienen que ser potencia de 2 y al menos un bloque mínimo
+    if (total_size < MIN_BLOCK_SIZE || (total_size & (total_size - 1)) != 0) return NULL;
+    if (chunk < MIN_BLOCK_SIZE || (chunk & (chunk - 1)) != 0 || chunk > total_size) return NULL;
+    int max_order = calculate_max_order(total_size, MIN_BLOCK_SIZE);
+    if (max_order >= BUDDY_MAX_ORDERS) return NULL;
+
+    size_t page = os_page_size();
+    if (config->huge_pages == BUDDY_HUGE_EXPLICIT) {
+        // Con páginas explícitas todo se hace de a páginas grandes
+        page = config->huge_page_size;
+        if ((page & (page - 1)) != 0 || chunk < page) return NULL;
+    }
+
+    // Cada orden k tiene total_size / (MIN_BLOCK_SIZE << k) bloques posibles
+    size_t bits = 0;
+    size_t bit_base[BUDDY_MAX_ORDERS];
+    for (int k = 0; k <= max_order; k++) {
+        bit_base[k] = bits;
+        bits += total_size >> (MIN_BLOCK_SHIFT + k);
+    }
+    size_t words = (bits + 63) / 64;
+
+    // La estructura, los dos bitmaps y (con slabs) page_kind van en un solo mapeo
+    size_t header = (sizeof(buddy_system_t) + 63) & ~(size_t)63;
+#if BUDDY_DEBUG
+    // La cuarentena va en el mismo mapeo, después de la estructura
+    size_t quarantine_at = header;
+    header += (sizeof(quarantine_t) + 63) & ~(size_t)63;
+#endif
+    // Bits de las cachés: solo los órdenes que tienen caché, en modo concurrente
+    size_t cached_words = 0;
+    if (config->concurrent) cached_words = ((max_order < MAG_ORDERS ? bits : bit_base[MAG_ORDERS]) + 63) / 64;
+    size_t pages = config->slabs ? (total_size >> SLAB_PAGE_SHIFT) + 1 : 0;
+    size_t metadata_size = header + (2 * words + cached_words) * sizeof(uint64_t) + pages;
+    buddy_system_t *buddy = os_alloc_zeroed(metadata_size);
     if (!buddy) return NULL;
+    buddy->metadata_size = metadata_size;
+    buddy->free_bits = (uint64_t*)((uint8_t*)buddy + header);
+    buddy->used_bits = (_Atomic uint64_t*)(buddy->free_bits + words);
+    if (cached_words) buddy->cached_bits = (_Atomic uint64_t*)(buddy->free_bits + 2 * words);
+#if BUDDY_DEBUG
+    buddy->quarantine = (quarantine_t*)((uint8_t*)buddy + quarantine_at);
+    pthread_mutex_init(&buddy->quarantine->lock, NULL);
+#endif
+    if (config->slabs) {
+        buddy->slabs = 1;
+        buddy->page_kind = (_Atomic uint8_t*)(buddy->free_bits + 2 * words + cached_words);
+        for (int c = 0; c < BUDDY_SLAB_CLASSES; c++) {
+            buddy->slab_classes[c].object_size = slab_sizes[c];
+            buddy->slab_classes[c].slab_order = find_order(slab_sizes[c] <= 128 ? 4096 : 16384);
+        }
+    }
+    memcpy(buddy->bit_base, bit_base, sizeof(bit_base));
     buddy->total_size = total_size;
-    buddy->max_order = calculate_max_order(total_size, MIN_BLOCK_SIZE);
-    buddy->used_memory = 0;
-    buddy->overhead_memory = 0;
-    buddy->max_coverage = 0.0;
-
-    // Reservamos la memoria principal
-    buddy->memory_pool = malloc(total_size);
+    buddy->max_order = max_order;
+    buddy->chunk_order = calculate_max_order(chunk, MIN_BLOCK_SIZE);
+    buddy->page_size = page;
+    buddy->huge_pages = config->huge_pages;
+    buddy->release_chunks = !config->keep_free_chunks;
+
+    // La arena queda alineada a min(total_size, 2 MiB) (o a la página
+    // explícita), así los bloques grandes también están alineados en
+    // direcciones absolutas y buddy_aligned_alloc puede dar hasta eso
+    size_t align = total_size < BUDDY_THP_SIZE ? total_size : BUDDY_THP_SIZE;
+    if (config->huge_pages == BUDDY_HUGE_EXPLICIT && page > align) align = page;
+    buddy->memory_pool = os_reserve(total_size, config->huge_pages, align);
     if (!buddy->memory_pool) {
-        free(buddy);
+        free_metadata(buddy);
         return NULL;
     }
+    uintptr_t base = (uintptr_t)buddy->memory_pool;
+    buddy->base_align = (size_t)(base & (~base + 1));
+    if (buddy->base_align > total_size) buddy->base_align = total_size;
+
+    // El overhead ahora son solo los metadatos, fuera de la memoria del usuario
+    int orders = max_order + 1;
+    buddy->overhead_memory = (2 * words + cached_words) * sizeof(uint64_t) + orders * (sizeof(size_t) + sizeof(free_block_t*)) + pages;
+#if BUDDY_DEBUG
+    buddy->overhead_memory += sizeof(quarantine_t);
+#endif
+
+    // Los primeros chunks (con un solo chunk del tamaño total queda un único
+    // bloque libre que ocupa toda la memoria)
+    do {
+        if (!grow(buddy)) {
+            free_metadata(buddy);
+            return NULL;
+        }
+    } while (counter_get(&buddy->committed) < config->initial_size);
+    return buddy;
+}
 
-    // Creamos las listas libres para cada orden
-    buddy->free_lists = calloc(buddy->max_order + 1, sizeof(block_t*));
-    if (!buddy->free_lists) {
-        free(buddy->memory_pool);
-        free(buddy);
-        return NULL;
+static void cache_destructor(void *arg);
+
+// Prepara el lock y la clave de las cachés de hilo
+static int enable_concurrency(buddy_system_t *buddy) {
+    buddy->concurrent = 1;
+    atomic_init(&buddy->remote_free, NULL);
+    atomic_init(&buddy->caches, NULL);
+    if (pthread_mutex_init(&buddy->lock, NULL) != 0) return 0;
+    if (pthread_key_create(&buddy->cache_key, cache_destructor) != 0) {
+        pthread_mutex_destroy(&buddy->lock);
+        return 0;
     }
+    for (int c = 0; c < BUDDY_SLAB_CLASSES; c++) {
+        pthread_mutex_init(&buddy->slab_classes[c].lock, NULL);
+    }
+    return 1;
+}
 
-    // Creamos el bloque inicial que ocupa toda la memoria
-    block_t *initial_block = (block_t*)buddy->memory_pool;
-    initial_block->size = total_size;
-    initial_block->is_free = 1;
-    initial_block->next = NULL;
-    initial_block->prev = NULL;
-    initial_block->buddy = NULL;
-
-    // Lo metemos en la lista de bloques libres más grande
-    buddy->free_lists[buddy->max_order] = initial_block;
+buddy_system_t* buddy_init_ex(const buddy_config_t *config) {
+    buddy_config_t c = *config;
+    if (c.chunk_size == 0) c.chunk_size = c.reserve_size < BUDDY_DEFAULT_CHUNK ? c.reserve_size : BUDDY_DEFAULT_CHUNK;
+    if (c.initial_size == 0) c.initial_size = c.chunk_size;
+    if (c.huge_page_size == 0) c.huge_page_size = BUDDY_THP_SIZE;
 
-    // Calculamos el overhead inicial (solo el header del primer bloque)
-    buddy->overhead_memory = sizeof(block_t);
+    buddy_system_t *buddy = buddy_create(&c);
+    if (!buddy) return NULL;
+    if (c.concurrent && !enable_concurrency(buddy)) {
+        buddy->concurrent = 0;
+        free_metadata(buddy);
+        return NULL;
+    }
+    return buddy;
+}
 
-    printf("Buddy System inicializado:\n");
-    printf("  Tamano total: %zu bytes\n", total_size);
-    printf("  Orden maximo: %d\n", buddy->max_order);
-    printf("  Bloque minimo: %d bytes\n", MIN_BLOCK_SIZE);
-    printf("  Overhead inicial: %zu bytes\n", buddy->overhead_memory);
+// Inicializa el sistema buddy: una arena de un solo chunk del tamaño total
+buddy_system_t* buddy_init(size_t total_size) {
+    buddy_config_t config = {.reserve_size = total_size, .chunk_size = total_size};
+    return buddy_init_ex(&config);
+}
 
-    return buddy;
+// Inicializa el sistema buddy para usarlo desde varios hilos
+buddy_system_t* buddy_init_concurrent(size_t total_size) {
+    buddy_config_t config = {.reserve_size = total_size, .chunk_size = total_size, .concurrent = 1};
+    return buddy_init_ex(&config);
 }
 
-// Busca el orden adecuado para el tamaño solicitado
+// Busca el orden adecuado para el tamaño solicitado: ceil(log2(size)) - log2(MIN)
 int find_order(size_t size) {
-    int order = 0;
-    size_t block_size = MIN_BLOCK_SIZE;
-    while (block_size < size) {
-        order++;
-        block_size *= 2;
-        if (order > 20) break; // por si acaso
-    }
-    return order;
+    if (size <= MIN_BLOCK_SIZE) return 0;
+    return highest_bit((uint64_t)(size - 1)) + 1 - MIN_BLOCK_SHIFT;
 }
 
-// Divide un bloque en dos buddies
-void split_block(buddy_system_t *buddy, block_t *block, int current_order) {
-    if (current_order <= 0) return;
-    size_t new_size = block->size / 2;
+// Divide el bloque libre en offset (de orden current_order) en dos buddies
+// del orden de abajo. Devuelve el orden nuevo.
+int split_block(buddy_system_t *buddy, size_t offset, int current_order) {
     int new_order = current_order - 1;
+    size_t new_size = (size_t)MIN_BLOCK_SIZE << new_order;
 
-    // Si el bloque es muy pequeño, ya no se puede dividir
-    if (new_size < sizeof(block_t)) {
-        return;
+    remove_free(buddy, offset, current_order);
+    // Primero la mitad derecha, así la izquierda queda al frente de la lista
+    push_free(buddy, offset + new_size, new_order);
+    push_free(buddy, offset, new_order);
+
+    counter_add(&buddy->splits, 1);
+    TRACE(buddy, BUDDY_EV_SPLIT, (uint8_t*)buddy->memory_pool + offset, new_size, new_order);
+    return new_order;
+}
+
+// Actualizamos el máximo de memoria usada
+static void update_high_water(buddy_system_t *buddy) {
+    uint64_t used = counter_get(&buddy->used_memory);
+    if (used > counter_get(&buddy->high_water)) {
+        atomic_store_explicit(&buddy->high_water, used, memory_order_relaxed);
+    }
+}
+
+// Toma un bloque del orden pedido (partiendo uno más grande si hace falta).
+// Devuelve su offset o SIZE_MAX si no hay memoria. En modo concurrente se
+// llama con el lock tomado.
+static size_t core_alloc(buddy_system_t *buddy, int required_order) {
+    // Buscamos un bloque libre del orden adecuado o mayor; si no hay, la
+    // arena crece de a un chunk hasta que aparezca o se acabe lo reservado
+    int current_order;
+    for (;;) {
+        current_order = required_order;
+        while (current_order <= buddy->max_order && buddy->free_lists[current_order] == NULL) {
+            current_order++;
+        }
+        if (current_order <= buddy->max_order) break;
+        if (!grow(buddy)) return SIZE_MAX;
     }
 
-    // Creamos el buddy (el bloque gemelo)
-    block_t *buddy_block = (block_t*)((uint8_t*)block + new_size);
+    // Si el bloque es más grande, lo partimos hasta llegar al tamaño justo
+    size_t offset = block_offset(buddy, buddy->free_lists[current_order]);
+    while (current_order > required_order) {
+        current_order = split_block(buddy, offset, current_order);
+    }
 
-    block->size = new_size;
-    block->buddy = buddy_block;
+    // Lo quitamos de la lista libre y lo marcamos como asignado
+    remove_free(buddy, offset, required_order);
+    used_set(buddy->used_bits, block_bit(buddy, offset, required_order));
 
-    buddy_block->size = new_size;
-    buddy_block->is_free = 1;
-    buddy_block->buddy = block;
-    buddy_block->next = NULL;
-    buddy_block->prev = NULL;
+    counter_add(&buddy->used_memory, (size_t)MIN_BLOCK_SIZE << required_order);
+    update_high_water(buddy);
+    return offset;
+}
 
-    // Aumentamos el overhead porque hay un nuevo header
-    buddy->overhead_memory += sizeof(block_t);
+// Toma hasta n bloques del orden pedido partiendo pocos bloques grandes: un
+// bloque de orden j se corta de una vez en 2^(j - order) bloques seguidos,
+// en vez de partirlo de a mitades y pasar cada mitad por las listas libres.
+// Deja los punteros en out (en orden de dirección) y devuelve cuántos tomó.
+// En modo concurrente se llama con el lock tomado.
+static size_t core_alloc_batch(buddy_system_t *buddy, int order, size_t n, void **out) {
+    size_t block_size = (size_t)MIN_BLOCK_SIZE << order;
+    size_t done = 0;
+    while (done < n) {
+        size_t need = n - done;
+        // El orden que alcanza para todo lo que falta
+        int target = order + (need > 1 ? highest_bit(need - 1) + 1 : 0);
+        if (target > buddy->max_order) target = buddy->max_order;
+
+        // El bloque libre más chico que alcance; si no hay, el más grande que
+        // haya; si tampoco, la arena crece
+        int j = target;
+        while (j <= buddy->max_order && buddy->free_lists[j] == NULL) j++;
+        if (j > buddy->max_order) {
+            j = target - 1;
+            while (j >= order && buddy->free_lists[j] == NULL) j--;
+            if (j < order) {
+                if (!grow(buddy)) break;
+                continue;
+            }
+        }
 
-    // Quitamos el bloque original de la lista libre
-    if (block->prev) block->prev->next = block->next;
-    if (block->next) block->next->prev = block->prev;
-    if (buddy->free_lists[current_order] == block) {
-        buddy->free_lists[current_order] = block->next;
+        size_t offset = block_offset(buddy, buddy->free_lists[j]);
+        remove_free(buddy, offset, j);
+        size_t pieces = (size_t)1 << (j - order);
+        size_t take = pieces < need ? pieces : need;
+        for (size_t i = 0; i < take; i++) {
+            used_set(buddy->used_bits, block_bit(buddy, offset + i * block_size, order));
+            out[done + i] = (uint8_t*)buddy->memory_pool + offset + i * block_size;
+        }
+        // Lo que sobra vuelve a las listas como los bloques alineados más
+        // grandes posibles (ninguno tiene a su buddy libre, no hay que fusionar)
+        if (take < pieces) {
+            for (size_t p = take; p < pieces; p += (size_t)1 << lowest_bit(p)) {
+                push_free(buddy, offset + p * block_size, order + lowest_bit(p));
+            }
+            counter_add(&buddy->splits, 1);
+            TRACE(buddy, BUDDY_EV_SPLIT, (uint8_t*)buddy->memory_pool + offset, block_size, order);
+        }
+        done += take;
+        counter_add(&buddy->used_memory, take * block_size);
     }
+    update_high_water(buddy);
+    return done;
+}
 
-    // Metemos los dos bloques en la lista de orden menor
-    block->next = buddy->free_lists[new_order];
-    if (buddy->free_lists[new_order]) {
-        buddy->free_lists[new_order]->prev = block;
-    }
-    buddy->free_lists[new_order] = block;
+// Fusiona el bloque libre en offset con su buddy mientras el buddy también
+// esté libre y entero (su bit de libre en el mismo orden). Devuelve el orden
+// final; en *merged queda el offset del bloque resultante si no es NULL.
+static int merge_into(buddy_system_t *buddy, size_t offset, int order, size_t *merged) {
+    while (order < buddy->max_order) {
+        size_t block_size = (size_t)MIN_BLOCK_SIZE << order;
+        size_t buddy_offset = offset ^ block_size;
+        if (!bit_test(buddy->free_bits, block_bit(buddy, buddy_offset, order))) break;
+
+        // Quitamos ambos bloques de la lista libre
+        remove_free(buddy, offset, order);
+        remove_free(buddy, buddy_offset, order);
+
+        // El bloque con menor dirección es el que queda, del doble de tamaño
+        offset &= ~block_size;
+        order++;
+        push_free(buddy, offset, order);
 
-    buddy_block->next = buddy->free_lists[new_order];
-    if (buddy->free_lists[new_order]) {
-        buddy->free_lists[new_order]->prev = buddy_block;
+        counter_add(&buddy->merges, 1);
+        TRACE(buddy, BUDDY_EV_MERGE, (uint8_t*)buddy->memory_pool + offset, block_size * 2, order);
     }
-    buddy->free_lists[new_order] = buddy_block;
+    if (merged) *merged = offset;
+    return order;
+}
+
+static void merge_buddies(buddy_system_t *buddy, size_t offset, int order) {
+    merge_into(buddy, offset, order, NULL);
+}
 
-    printf("  Bloque dividido: orden %d -> orden %d (tamano: %zu)\n", 
-           current_order, new_order, new_size);
+// Marca libre un bloque asignado y lo mete en la lista libre, sin fusionar
+static void core_release(buddy_system_t *buddy, size_t offset, int order) {
+    used_clear(buddy->used_bits, block_bit(buddy, offset, order));
+    counter_sub(&buddy->used_memory, (size_t)MIN_BLOCK_SIZE << order);
+    push_free(buddy, offset, order);
 }
 
-// Actualiza la cobertura máxima si se supera el récord
-void update_max_coverage(buddy_system_t *buddy) {
-    double current_coverage = (double)buddy->used_memory / buddy->total_size * 100.0;
-    if (current_coverage > buddy->max_coverage) {
-        buddy->max_coverage = current_coverage;
+// Fusiona el bloque libre recién liberado con sus buddies
+static void coalesce(buddy_system_t *buddy, size_t offset, int order) {
+    size_t merged;
+    int merged_order = merge_into(buddy, offset, order, &merged);
+
+    // Si con esto quedaron libres chunks enteros, se anotan para devolverlos
+    if (buddy->release_chunks && merged_order >= buddy->chunk_order && buddy->chunk_order < buddy->max_order) {
+        size_t chunk = (size_t)MIN_BLOCK_SIZE << buddy->chunk_order;
+        size_t size = order > buddy->chunk_order ? (size_t)MIN_BLOCK_SIZE << order : chunk;
+        size_t start = offset & ~(size - 1);
+        for (size_t c = start; c < start + size; c += chunk) chunk_freed(buddy, c);
     }
+    (void)merged;
 }
 
-// Asigna memoria (como malloc pero usando buddy)
-void* buddy_alloc(buddy_system_t *buddy, size_t size) {
-    if (size == 0 || size > buddy->total_size) {
-        return NULL;
+// Devuelve al núcleo un bloque asignado de ese orden y lo fusiona. En modo
+// concurrente se llama con el lock tomado.
+static void core_free(buddy_system_t *buddy, size_t offset, int order) {
+    core_release(buddy, offset, order);
+    coalesce(buddy, offset, order);
+}
+
+// Orden del bloque asignado que empieza en ptr, o -1 si ptr no es el inicio
+// de un bloque asignado. Lo deduce del bitmap de asignados: es el único
+// orden con el bit encendido en ese offset (a lo sumo max_order + 1 pruebas).
+// Un bloque que está en la caché de un hilo cuenta como libre. No necesita
+// el lock: los bits de un bloque asignado no cambian hasta que su dueño lo
+// libera.
+static int find_used_order(buddy_system_t *buddy, void *ptr) {
+    if ((uint8_t*)ptr < (uint8_t*)buddy->memory_pool ||
+        (uint8_t*)ptr >= (uint8_t*)buddy->memory_pool + buddy->total_size) {
+        return -1;
     }
-    size_t required_size = size;
-    int required_order = find_order(required_size);
+    size_t offset = block_offset(buddy, ptr);
+    for (int k = 0; k <= buddy->max_order; k++) {
+        if (offset & (((size_t)MIN_BLOCK_SIZE << k) - 1)) break; // desalineado para este orden
+        size_t bit = block_bit(buddy, offset, k);
+        if (used_test(buddy->used_bits, bit)) {
+            if (k < MAG_ORDERS && buddy->cached_bits && used_test(buddy->cached_bits, bit)) return -1;
+            return k;
+        }
+    }
+    return -1;
+}
 
-    if (required_order > buddy->max_order) {
-        return NULL;
+// --- Modo concurrente ---
+
+// Devuelve al núcleo todo lo que otros hilos dejaron en la pila remota.
+// Se llama con el lock tomado.
+static void drain_remote(buddy_system_t *buddy) {
+    remote_block_t *list = atomic_exchange_explicit(&buddy->remote_free, NULL, memory_order_acquire);
+    while (list) {
+        remote_block_t *next = list->next;
+        core_free(buddy, block_offset(buddy, list), list->order);
+        list = next;
     }
+}
 
-    printf("Solicitando %zu bytes (requiere orden %d)\n", size, required_order);
+// Empuja la cadena first..last (ya enlazada) a la pila remota con un CAS.
+// Como quien vacía la pila se la lleva entera con un exchange, no hay ABA.
+static void push_remote(buddy_system_t *buddy, remote_block_t *first, remote_block_t *last) {
+    remote_block_t *head = atomic_load_explicit(&buddy->remote_free, memory_order_relaxed);
+    do {
+        last->next = head;
+    } while (!atomic_compare_exchange_weak_explicit(&buddy->remote_free, &head, first,
+                                                    memory_order_release, memory_order_relaxed));
+}
 
-    // Buscamos un bloque libre del orden adecuado o mayor
-    int current_order = required_order;
-    while (current_order <= buddy->max_order) {
-        if (buddy->free_lists[current_order] != NULL) {
+// Caché del hilo actual. La primera vez reusa la de un hilo que ya terminó
+// o crea una nueva y la agrega a la lista con un CAS.
+static thread_cache_t* get_cache(buddy_system_t *buddy) {
+    thread_cache_t *tc = pthread_getspecific(buddy->cache_key);
+    if (tc) return tc;
+    for (tc = atomic_load_explicit(&buddy->caches, memory_order_acquire); tc; tc = tc->next) {
+        int expected = 0;
+        if (atomic_compare_exchange_strong_explicit(&tc->in_use, &expected, 1,
+                                                    memory_order_acquire, memory_order_relaxed)) {
             break;
         }
-        current_order++;
     }
+    if (!tc) {
+        // Con mmap y no con malloc: el buddy puede ser el malloc del proceso
+        tc = os_alloc_zeroed(sizeof(thread_cache_t));
+        if (!tc) return NULL;
+        tc->buddy = buddy;
+        atomic_init(&tc->in_use, 1);
+        tc->next = atomic_load_explicit(&buddy->caches, memory_order_relaxed);
+        while (!atomic_compare_exchange_weak_explicit(&buddy->caches, &tc->next, tc,
+                                                      memory_order_release, memory_order_relaxed)) {
+        }
+    }
+    pthread_setspecific(buddy->cache_key, tc);
+    return tc;
+}
 
-    if (current_order > buddy->max_order) {
-        printf("  No hay memoria disponible\n");
-        return NULL;
+// Devuelve al núcleo todos los bloques de la caché. Con el lock tomado.
+static void cache_flush(buddy_system_t *buddy, thread_cache_t *tc) {
+    for (int k = 0; k < MAG_ORDERS; k++) {
+        for (int i = 0; i < tc->count[k]; i++) {
+            size_t offset = block_offset(buddy, tc->blocks[k][i]);
+            cached_unmark(buddy->cached_bits, block_bit(buddy, offset, k));
+            core_free(buddy, offset, k);
+        }
+        tc->count[k] = 0;
     }
+    drain_remote(buddy);
+}
 
-    // Si el bloque es más grande, lo partimos hasta llegar al tamaño justo
-    while (current_order > required_order) {
-        block_t *block = buddy->free_lists[current_order];
-        if (!block) break;
-        split_block(buddy, block, current_order);
-        current_order--;
+// Al terminar un hilo, sus bloques vuelven al núcleo
+static void cache_destructor(void *arg) {
+    thread_cache_t *tc = arg;
+    buddy_system_t *buddy = tc->buddy;
+    pthread_mutex_lock(&buddy->lock);
+    cache_flush(buddy, tc);
+    pthread_mutex_unlock(&buddy->lock);
+    atomic_store_explicit(&tc->in_use, 0, memory_order_release);
+}
+
+static void* concurrent_alloc(buddy_system_t *buddy, int order, size_t size) {
+    if (order < MAG_ORDERS) {
+        thread_cache_t *tc = get_cache(buddy);
+        if (tc) {
+            if (tc->count[order] == 0) {
+                // Caché vacía: se rellena con la mitad de su capacidad de una vez
+                pthread_mutex_lock(&buddy->lock);
+                drain_remote(buddy);
+                while (tc->count[order] < MAG_SIZE / 2) {
+                    size_t offset = core_alloc(buddy, order);
+                    if (offset == SIZE_MAX) break;
+                    cached_mark(buddy->cached_bits, block_bit(buddy, offset, order));
+                    tc->blocks[order][tc->count[order]++] = (uint8_t*)buddy->memory_pool + offset;
+                }
+                pthread_mutex_unlock(&buddy->lock);
+                if (tc->count[order] == 0) return NULL;
+            }
+            counter_add(&tc->allocs[order], 1);
+            counter_add(&tc->requested, size);
+            void *ptr = tc->blocks[order][--tc->count[order]];
+            cached_unmark(buddy->cached_bits, block_bit(buddy, block_offset(buddy, ptr), order));
+            return ptr;
+        }
+    }
+    pthread_mutex_lock(&buddy->lock);
+    drain_remote(buddy);
+    size_t offset = core_alloc(buddy, order);
+    if (offset != SIZE_MAX) {
+        counter_add(&buddy->allocs[order], 1);
+        counter_add(&buddy->requested, size);
     }
+    pthread_mutex_unlock(&buddy->lock);
+    return offset == SIZE_MAX ? NULL : (uint8_t*)buddy->memory_pool + offset;
+}
 
-    // Tomamos el primer bloque disponible del orden correcto
-    block_t *allocated_block = buddy->free_lists[required_order];
-    if (!allocated_block) {
-        printf("  Error: no se pudo asignar bloque\n");
-        return NULL;
+static void concurrent_free(buddy_system_t *buddy, void *ptr, int order) {
+    if (order < MAG_ORDERS) {
+        thread_cache_t *tc = get_cache(buddy);
+        if (tc) {
+            // Dos hilos liberando a la vez el mismo bloque: solo uno lo marca
+            if (cached_mark(buddy->cached_bits, block_bit(buddy, block_offset(buddy, ptr), order))) {
+                atomic_fetch_add_explicit(&buddy->bad_frees, 1, memory_order_relaxed);
+                TRACE(buddy, BUDDY_EV_BAD_FREE, ptr, 0, -1);
+                return;
+            }
+            if (tc->count[order] == MAG_SIZE) {
+                // Caché llena: la mitad de abajo va a la pila remota sin lock
+                int half = MAG_SIZE / 2;
+                for (int i = 0; i < half; i++) {
+                    remote_block_t *r = tc->blocks[order][i];
+                    cached_unmark(buddy->cached_bits, block_bit(buddy, block_offset(buddy, r), order));
+                    r->order = order;
+                    r->next = i + 1 < half ? tc->blocks[order][i + 1] : NULL;
+                }
+                push_remote(buddy, tc->blocks[order][0], tc->blocks[order][half - 1]);
+                memmove(tc->blocks[order], tc->blocks[order] + half, (MAG_SIZE - half) * sizeof(void*));
+                tc->count[order] -= half;
+            }
+            tc->blocks[order][tc->count[order]++] = ptr;
+            counter_add(&tc->frees[order], 1);
+            return;
+        }
     }
+    pthread_mutex_lock(&buddy->lock);
+    drain_remote(buddy);
+    core_free(buddy, block_offset(buddy, ptr), order);
+    counter_add(&buddy->frees[order], 1);
+    pthread_mutex_unlock(&buddy->lock);
+}
+
+// --- Slabs ---
 
-    // Lo quitamos de la lista libre
-    buddy->free_lists[required_order] = allocated_block->next;
-    if (allocated_block->next) {
-        allocated_block->next->prev = NULL;
+// Toma un bloque del núcleo para un slab nuevo de la clase c. Con el lock de
+// la clase tomado (el del núcleo se toma adentro: siempre en ese orden).
+static slab_t* new_slab(buddy_system_t *buddy, int c) {
+    slab_class_t *cls = &buddy->slab_classes[c];
+    if (buddy->concurrent) {
+        pthread_mutex_lock(&buddy->lock);
+        drain_remote(buddy);
     }
+    size_t offset = core_alloc(buddy, cls->slab_order);
+    if (buddy->concurrent) pthread_mutex_unlock(&buddy->lock);
+    if (offset == SIZE_MAX) return NULL;
+
+    size_t size = (size_t)MIN_BLOCK_SIZE << cls->slab_order;
+    slab_t *slab = (slab_t*)((uint8_t*)buddy->memory_pool + offset);
+    slab->next = slab->prev = NULL;
+    slab->free_list = NULL;
+    slab->bump = SLAB_HEADER;
+    slab->used = 0;
+    slab->capacity = (uint32_t)((size - SLAB_HEADER) / cls->object_size);
+    slab->size_class = (uint32_t)c;
+    for (size_t w = 0; w < SLAB_MAX_OBJECTS / 64; w++) {
+        atomic_store_explicit(&slab->live[w], 0, memory_order_relaxed);
+    }
+    uint8_t shift = (uint8_t)highest_bit(size);
+    for (size_t page = offset >> SLAB_PAGE_SHIFT; page < (offset + size) >> SLAB_PAGE_SHIFT; page++) {
+        atomic_store_explicit(&buddy->page_kind[page], shift, memory_order_relaxed);
+    }
+    counter_add(&cls->slabs, 1);
+    return slab;
+}
 
-    allocated_block->is_free = 0;
-    allocated_block->next = NULL;
-    allocated_block->prev = NULL;
+static void unlink_slab(slab_class_t *cls, slab_t *slab) {
+    if (slab->prev) slab->prev->next = slab->next;
+    else cls->partial = slab->next;
+    if (slab->next) slab->next->prev = slab->prev;
+    slab->next = slab->prev = NULL;
+}
 
-    // Actualizamos la memoria usada (solo lo que usa el usuario, no el header)
-    size_t actual_user_memory = allocated_block->size - sizeof(block_t);
-    if (actual_user_memory > size) {
-        actual_user_memory = size;
+// Un objeto de la clase c, con el lock de la clase tomado
+static void* slab_alloc_locked(buddy_system_t *buddy, int c, size_t size) {
+    slab_class_t *cls = &buddy->slab_classes[c];
+    slab_t *slab = cls->partial;
+    if (!slab) {
+        slab = new_slab(buddy, c);
+        if (!slab) return NULL;
+        cls->partial = slab;
     }
-    buddy->used_memory += actual_user_memory;
 
-    // Actualizamos la cobertura máxima
-    update_max_coverage(buddy);
+    // Primero los objetos liberados, después los que nunca se usaron
+    void *obj;
+    if (slab->free_list) {
+        obj = slab->free_list;
+        slab->free_list = *(void**)obj;
+    } else {
+        obj = (uint8_t*)slab + slab->bump;
+        slab->bump += cls->object_size;
+    }
+    used_set(slab->live, ((uint8_t*)obj - (uint8_t*)slab - SLAB_HEADER) / cls->object_size);
+    // Un slab lleno sale de la lista hasta que se libere algo
+    if (++slab->used == slab->capacity) unlink_slab(cls, slab);
 
-    void *user_ptr = (void*)((uint8_t*)allocated_block + sizeof(block_t));
+    counter_add(&cls->allocs, 1);
+    counter_add(&cls->requested, size);
+    return obj;
+}
 
-    printf("  Memoria asignada: %p (bloque: %p, tamano: %zu, usuario: %zu)\n", 
-           user_ptr, allocated_block, allocated_block->size, actual_user_memory);
+static void* slab_alloc(buddy_system_t *buddy, int c, size_t size) {
+    slab_class_t *cls = &buddy->slab_classes[c];
+    if (buddy->concurrent) pthread_mutex_lock(&cls->lock);
+    void *obj = slab_alloc_locked(buddy, c, size);
+    if (buddy->concurrent) pthread_mutex_unlock(&cls->lock);
+    return obj;
+}
 
-    return user_ptr;
+// Slab del objeto ptr (que está en una página de slab de 2^shift bytes), o
+// NULL si ptr no cae justo al inicio de un objeto
+static slab_t* slab_of(buddy_system_t *buddy, void *ptr, int shift) {
+    size_t offset = block_offset(buddy, ptr);
+    size_t start = offset & ~(((size_t)1 << shift) - 1);
+    slab_t *slab = (slab_t*)((uint8_t*)buddy->memory_pool + start);
+    size_t pos = offset - start;
+    // El slab no cambia de clase mientras tenga objetos asignados
+    if (pos < SLAB_HEADER || (pos - SLAB_HEADER) % buddy->slab_classes[slab->size_class].object_size != 0) {
+        return NULL;
+    }
+    return slab;
 }
 
-// Fusiona bloques buddies si ambos están libres
-void merge_buddies(buddy_system_t *buddy, block_t *block) {
-    while (block->buddy && block->buddy->is_free && 
-           block->size == block->buddy->size &&
-           block->size * 2 <= buddy->total_size) {
-        
-        block_t *buddy_block = block->buddy;
-        int current_order = find_order(block->size);
+// Índice de ptr (inicio de un objeto) dentro de su slab
+static inline size_t slab_index(buddy_system_t *buddy, slab_t *slab, void *ptr) {
+    return ((uint8_t*)ptr - (uint8_t*)slab - SLAB_HEADER) / buddy->slab_classes[slab->size_class].object_size;
+}
 
-        // Quitamos ambos bloques de la lista libre
-        if (block->prev) block->prev->next = block->next;
-        if (block->next) block->next->prev = block->prev;
-        if (buddy->free_lists[current_order] == block) {
-            buddy->free_lists[current_order] = block->next;
-        }
-        if (buddy_block->prev) buddy_block->prev->next = buddy_block->next;
-        if (buddy_block->next) buddy_block->next->prev = buddy_block->prev;
-        if (buddy->free_lists[current_order] == buddy_block) {
-            buddy->free_lists[current_order] = buddy_block->next;
+// Con el lock de la clase del slab tomado. Devuelve 0 (y lo cuenta como
+// liberación inválida) si el objeto no estaba asignado. Traza acá, con el
+// lock: después el objeto ya puede ser de otro hilo.
+static int slab_free_locked(buddy_system_t *buddy, slab_t *slab, void *ptr) {
+    slab_class_t *cls = &buddy->slab_classes[slab->size_class];
+    size_t index = slab_index(buddy, slab, ptr);
+    if (!used_test(slab->live, index)) {
+        atomic_fetch_add_explicit(&buddy->bad_frees, 1, memory_order_relaxed);
+        TRACE(buddy, BUDDY_EV_BAD_FREE, ptr, 0, -1);
+        return 0;
+    }
+    TRACE(buddy, BUDDY_EV_FREE, ptr, cls->object_size, -1);
+    used_clear(slab->live, index);
+    *(void**)ptr = slab->free_list;
+    slab->free_list = ptr;
+    // Si estaba lleno vuelve a la lista de slabs con lugar
+    if (slab->used-- == slab->capacity) {
+        slab->next = cls->partial;
+        if (slab->next) slab->next->prev = slab;
+        cls->partial = slab;
+    }
+    counter_add(&cls->frees, 1);
+
+    // Un slab vacío vuelve al núcleo, salvo que sea el único de la clase
+    // (así alloc/free alternados no lo crean y destruyen cada vez)
+    if (slab->used == 0 && (slab->prev || slab->next)) {
+        unlink_slab(cls, slab);
+        size_t offset = block_offset(buddy, slab);
+        size_t size = (size_t)MIN_BLOCK_SIZE << cls->slab_order;
+        for (size_t page = offset >> SLAB_PAGE_SHIFT; page < (offset + size) >> SLAB_PAGE_SHIFT; page++) {
+            atomic_store_explicit(&buddy->page_kind[page], 0, memory_order_relaxed);
         }
+        counter_sub(&cls->slabs, 1);
+        if (buddy->concurrent) pthread_mutex_lock(&buddy->lock);
+        core_free(buddy, offset, cls->slab_order);
+        if (buddy->concurrent) pthread_mutex_unlock(&buddy->lock);
+    }
+    return 1;
+}
 
-        // El bloque con menor dirección es el que queda
-        block_t *left_block = (block < buddy_block) ? block : buddy_block;
+static void slab_free(buddy_system_t *buddy, slab_t *slab, void *ptr) {
+    slab_class_t *cls = &buddy->slab_classes[slab->size_class];
+    if (buddy->concurrent) pthread_mutex_lock(&cls->lock);
+    slab_free_locked(buddy, slab, ptr);
+    if (buddy->concurrent) pthread_mutex_unlock(&cls->lock);
+}
 
-        // El bloque fusionado es el doble de grande
-        left_block->size *= 2;
-        left_block->is_free = 1;
-        left_block->next = NULL;
-        left_block->prev = NULL;
+// ptr es un objeto asignado de slab. Sin lock: el bit de un objeto asignado
+// no cambia hasta que su dueño lo libera.
+static int slab_live(buddy_system_t *buddy, slab_t *slab, void *ptr) {
+    return used_test(slab->live, slab_index(buddy, slab, ptr));
+}
 
-        // Disminuimos el overhead porque quitamos un header
-        if (buddy->overhead_memory >= sizeof(block_t)) {
-            buddy->overhead_memory -= sizeof(block_t);
+// Slab de ptr si ptr cae en una página de slab (NULL si no). *bad queda en 1
+// si cae en un slab pero no al inicio de un objeto.
+static slab_t* find_slab(buddy_system_t *buddy, void *ptr, int *bad) {
+    *bad = 0;
+    if (!buddy->slabs || (uint8_t*)ptr < (uint8_t*)buddy->memory_pool ||
+        (uint8_t*)ptr >= (uint8_t*)buddy->memory_pool + buddy->total_size) {
+        return NULL;
+    }
+    size_t page = block_offset(buddy, ptr) >> SLAB_PAGE_SHIFT;
+    int shift = atomic_load_explicit(&buddy->page_kind[page], memory_order_relaxed);
+    if (!shift) return NULL;
+    slab_t *slab = slab_of(buddy, ptr, shift);
+    if (!slab) *bad = 1;
+    return slab;
+}
+
+// Bloque del buddy (sin pasar por los slabs) para un pedido de size bytes
+static void* block_alloc(buddy_system_t *buddy, int order, size_t size) {
+    if (buddy->concurrent) return concurrent_alloc(buddy, order, size);
+    size_t offset = core_alloc(buddy, order);
+    if (offset == SIZE_MAX) return NULL;
+    counter_add(&buddy->allocs[order], 1);
+    counter_add(&buddy->requested, size);
+    return (uint8_t*)buddy->memory_pool + offset;
+}
+
+static void* alloc_failed(buddy_system_t *buddy, size_t size, int order) {
+    atomic_fetch_add_explicit(&buddy->failed_allocs, 1, memory_order_relaxed);
+    TRACE(buddy, BUDDY_EV_NO_MEMORY, NULL, size, order);
+    return NULL;
+}
+
+// Bytes del bloque o del objeto de slab en ptr; 0 si no es uno asignado
+static size_t block_usable(buddy_system_t *buddy, void *ptr) {
+    int bad;
+    slab_t *slab = find_slab(buddy, ptr, &bad);
+    if (slab) return slab_live(buddy, slab, ptr) ? buddy->slab_classes[slab->size_class].object_size : 0;
+    int order = bad ? -1 : find_used_order(buddy, ptr);
+    return order < 0 ? 0 : (size_t)MIN_BLOCK_SIZE << order;
+}
+
+#if BUDDY_DEBUG
+// --- Modo debug ---
+
+static inline uint64_t debug_seal(void *ptr, uint64_t size, uint64_t state) {
+    return ((uint64_t)(uintptr_t)ptr * 0x9E3779B97F4A7C15ULL) ^ size ^ state;
+}
+
+static inline debug_trailer_t* debug_trailer(void *ptr, size_t usable) {
+    return (debug_trailer_t*)((uint8_t*)ptr + usable - DEBUG_TRAILER);
+}
+
+static int debug_filled(const uint8_t *p, int byte, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        if (p[i] != byte) return 0;
+    }
+    return 1;
+}
+
+// Deja listo un bloque recién asignado: canario y trailer vivo
+static void debug_arm(buddy_system_t *buddy, void *ptr, size_t size) {
+    size_t usable = block_usable(buddy, ptr);
+    memset((uint8_t*)ptr + size, DEBUG_CANARY, usable - DEBUG_TRAILER - size);
+    debug_trailer_t *t = debug_trailer(ptr, usable);
+    t->size = size;
+    t->check = debug_seal(ptr, size, DEBUG_LIVE);
+}
+
+// Valida un puntero que el usuario devuelve o consulta. Devuelve los bytes
+// que pidió o SIZE_MAX si hay una falla (que se avisa si report es 1).
+static size_t debug_check(buddy_system_t *buddy, void *ptr, int report) {
+    buddy_fault_t fault;
+    size_t usable = 0;
+    if ((uintptr_t)ptr - (uintptr_t)buddy->memory_pool >= buddy->total_size) {
+        fault = BUDDY_FAULT_FOREIGN;
+    } else if ((usable = block_usable(buddy, ptr)) == 0) {
+        fault = BUDDY_FAULT_NOT_ALLOCATED;
+    } else {
+        debug_trailer_t *t = debug_trailer(ptr, usable);
+        uint64_t size = t->size;
+        if (t->check == debug_seal(ptr, size, DEBUG_FREED)) {
+            fault = BUDDY_FAULT_DOUBLE_FREE;
+        } else if (size > usable - DEBUG_EXTRA || t->check != debug_seal(ptr, size, DEBUG_LIVE)) {
+            fault = BUDDY_FAULT_TRAILER;
+        } else if (!debug_filled((uint8_t*)ptr + size, DEBUG_CANARY, usable - DEBUG_TRAILER - size)) {
+            fault = BUDDY_FAULT_OVERFLOW;
+        } else {
+            return (size_t)size;
         }
+    }
+    if (report) debug_fault(buddy, ptr, fault);
+    return SIZE_MAX;
+}
+
+// Comprueba que un bloque que sale de la cuarentena siga envenenado
+static void debug_check_poison(buddy_system_t *buddy, void *ptr, size_t usable) {
+    debug_trailer_t *t = debug_trailer(ptr, usable);
+    if (t->size > usable - DEBUG_EXTRA || t->check != debug_seal(ptr, t->size, DEBUG_FREED) ||
+        !debug_filled(ptr, DEBUG_POISON, usable - DEBUG_TRAILER)) {
+        debug_fault(buddy, ptr, BUDDY_FAULT_USE_AFTER_FREE);
+    }
+}
+
+// Valida ptr, lo envenena y lo mete en la cuarentena. Deja en victims los
+// bloques más viejos que salen para hacerle lugar (a lo sumo
+// QUARANTINE_EVICT) y devuelve cuántos son; esos sí hay que liberarlos. El
+// trailer de un bloque liberado queda sellado como tal: si vuelve a llegar a
+// buddy_free mientras está en una caché o en un slab, es un doble free.
+static size_t debug_quarantine(buddy_system_t *buddy, void *ptr, void **victims) {
+    size_t size = debug_check(buddy, ptr, 1);
+    if (size == SIZE_MAX) return 0;
+    size_t usable = block_usable(buddy, ptr);
+    memset(ptr, DEBUG_POISON, usable - DEBUG_TRAILER);
+    debug_trailer(ptr, usable)->check = debug_seal(ptr, size, DEBUG_FREED);
+
+    quarantine_t *q = buddy->quarantine;
+    size_t n = 0;
+    size_t victim_usable[QUARANTINE_EVICT];
+    if (buddy->concurrent) pthread_mutex_lock(&q->lock);
+    while (n < QUARANTINE_EVICT &&
+           (q->count == QUARANTINE_SLOTS || (q->count > 0 && q->bytes + usable > QUARANTINE_BYTES))) {
+        victims[n] = q->blocks[q->head];
+        victim_usable[n++] = q->usable[q->head];
+        q->bytes -= q->usable[q->head];
+        q->head = (q->head + 1) % QUARANTINE_SLOTS;
+        q->count--;
+    }
+    size_t slot = (q->head + q->count) % QUARANTINE_SLOTS;
+    q->blocks[slot] = ptr;
+    q->usable[slot] = usable;
+    q->count++;
+    q->bytes += usable;
+    if (buddy->concurrent) pthread_mutex_unlock(&q->lock);
+
+    for (size_t i = 0; i < n; i++) debug_check_poison(buddy, victims[i], victim_usable[i]);
+    return n;
+}
 
-        int new_order = current_order + 1;
+// Saca el bloque más viejo de la cuarentena (NULL si está vacía)
+static void* debug_unquarantine(buddy_system_t *buddy) {
+    quarantine_t *q = buddy->quarantine;
+    void *ptr = NULL;
+    size_t usable = 0;
+    if (buddy->concurrent) pthread_mutex_lock(&q->lock);
+    if (q->count > 0) {
+        ptr = q->blocks[q->head];
+        usable = q->usable[q->head];
+        q->bytes -= usable;
+        q->head = (q->head + 1) % QUARANTINE_SLOTS;
+        q->count--;
+    }
+    if (buddy->concurrent) pthread_mutex_unlock(&q->lock);
+    if (ptr) debug_check_poison(buddy, ptr, usable);
+    return ptr;
+}
+#endif
 
-        // Metemos el bloque fusionado en la lista de orden superior
-        left_block->next = buddy->free_lists[new_order];
-        if (buddy->free_lists[new_order]) {
-            buddy->free_lists[new_order]->prev = left_block;
+// --- API ---
+
+// Asigna memoria (como malloc pero usando buddy)
+void* buddy_alloc(buddy_system_t *buddy, size_t size) {
+    if (size == 0) return NULL;
+#if BUDDY_DEBUG
+    // Lo pedido de más también cuenta en los contadores y en la traza
+    size_t user_size = size;
+    if (size > SIZE_MAX - DEBUG_EXTRA) return alloc_failed(buddy, size, -1);
+    size += DEBUG_EXTRA;
+#endif
+    void *user_ptr = NULL;
+    int required_order = -1;
+    // Los pedidos chicos van a su slab (order -1 en la traza); si no hay
+    // memoria para un slab nuevo se intenta igual con un bloque
+    if (buddy->slabs && size <= BUDDY_SLAB_MAX) {
+        user_ptr = slab_alloc(buddy, slab_class_of[(size + 7) >> 3], size);
+    }
+    if (!user_ptr && size <= buddy->total_size) {
+        required_order = find_order(size);
+        user_ptr = block_alloc(buddy, required_order, size);
+    }
+    if (!user_ptr) return alloc_failed(buddy, size, required_order);
+    TRACE(buddy, BUDDY_EV_ALLOC, user_ptr, size, required_order);
+#if BUDDY_DEBUG
+    debug_arm(buddy, user_ptr, user_size);
+#endif
+    return user_ptr;
+}
+
+// Pide size bytes alineados a alignment (potencia de 2). Como un bloque de
+// orden k empieza en un múltiplo de su tamaño, alcanza con un bloque de al
+// menos alignment bytes. Devuelve NULL si alignment es mayor que la
+// alineación de la arena (base_align).
+void* buddy_aligned_alloc(buddy_system_t *buddy, size_t alignment, size_t size) {
+    if (!buddy || size == 0 || alignment == 0 || (alignment & (alignment - 1)) != 0 ||
+        alignment > buddy->base_align) {
+        return NULL;
+    }
+#if BUDDY_DEBUG
+    size_t user_size = size;
+    if (size > SIZE_MAX - DEBUG_EXTRA) return alloc_failed(buddy, size, -1);
+    size += DEBUG_EXTRA;
+#endif
+    // En un slab los objetos quedan alineados a 16 si su tamaño es múltiplo de
+    // 16 (y a 8 si no): se busca la primera clase que sirva
+    if (buddy->slabs && alignment <= MIN_BLOCK_SIZE && size <= BUDDY_SLAB_MAX) {
+        int c = slab_class_of[(size + 7) >> 3];
+        while (slab_sizes[c] % alignment != 0) c++;
+        void *obj = slab_alloc(buddy, c, size);
+        if (obj) {
+            TRACE(buddy, BUDDY_EV_ALLOC, obj, size, -1);
+#if BUDDY_DEBUG
+            debug_arm(buddy, obj, user_size);
+#endif
+            return obj;
         }
-        buddy->free_lists[new_order] = left_block;
+    }
+    size_t block = size < alignment ? alignment : size;
+    if (block > buddy->total_size) return alloc_failed(buddy, size, -1);
+    int order = find_order(block);
+    void *ptr = block_alloc(buddy, order, size);
+    if (!ptr) return alloc_failed(buddy, size, order);
+    TRACE(buddy, BUDDY_EV_ALLOC, ptr, size, order);
+#if BUDDY_DEBUG
+    debug_arm(buddy, ptr, user_size);
+#endif
+    return ptr;
+}
 
-        printf("  Bloques fusionados: nuevo tamano %zu (orden %d)\n", 
-               left_block->size, new_order);
+#if !BUDDY_DEBUG
+// Cambia en el lugar el bloque asignado en offset de orden old_order a
+// new_order: para achicar lo parte y devuelve las mitades de arriba; para
+// agrandar absorbe a sus buddies, si están libres y enteros. Devuelve 0 si no
+// se pudo (el bloque queda como estaba). En modo concurrente se llama con el
+// lock tomado.
+static int resize_in_place(buddy_system_t *buddy, size_t offset, int old_order, int new_order) {
+    if (new_order > old_order) {
+        // Tiene que ser la mitad de abajo en cada nivel y el buddy de cada
+        // nivel tiene que ser un bloque libre de ese mismo orden
+        if (new_order > buddy->max_order || (offset & (((size_t)MIN_BLOCK_SIZE << new_order) - 1)) != 0) return 0;
+        for (int k = old_order; k < new_order; k++) {
+            if (!bit_test(buddy->free_bits, block_bit(buddy, offset + ((size_t)MIN_BLOCK_SIZE << k), k))) return 0;
+        }
+        for (int k = old_order; k < new_order; k++) {
+            remove_free(buddy, offset + ((size_t)MIN_BLOCK_SIZE << k), k);
+            counter_add(&buddy->merges, 1);
+        }
+        counter_add(&buddy->used_memory, ((size_t)MIN_BLOCK_SIZE << new_order) - ((size_t)MIN_BLOCK_SIZE << old_order));
+        update_high_water(buddy);
+    } else {
+        // Las mitades de arriba tienen a su buddy asignado: no hay que fusionar
+        for (int k = old_order - 1; k >= new_order; k--) {
+            push_free(buddy, offset + ((size_t)MIN_BLOCK_SIZE << k), k);
+            counter_add(&buddy->splits, 1);
+        }
+        counter_sub(&buddy->used_memory, ((size_t)MIN_BLOCK_SIZE << old_order) - ((size_t)MIN_BLOCK_SIZE << new_order));
+    }
+    used_clear(buddy->used_bits, block_bit(buddy, offset, old_order));
+    used_set(buddy->used_bits, block_bit(buddy, offset, new_order));
+    // En los contadores cuenta como liberar el bloque viejo y asignar el nuevo
+    counter_add(&buddy->frees[old_order], 1);
+    counter_add(&buddy->allocs[new_order], 1);
+    return 1;
+}
+#endif
+
+// Como realloc: cambia el tamaño de ptr a size bytes. Intenta primero en el
+// lugar (un objeto de slab que todavía alcanza, un bloque que se achica o que
+// absorbe a su buddy libre) y solo si no se puede asigna, copia y libera.
+// Si falla devuelve NULL y ptr queda intacto.
+void* buddy_realloc(buddy_system_t *buddy, void *ptr, size_t size) {
+    if (!ptr) return buddy_alloc(buddy, size);
+    if (size == 0) {
+        buddy_free(buddy, ptr);
+        return NULL;
+    }
+#if BUDDY_DEBUG
+    // Siempre se mueve: así el bloque viejo pasa por la cuarentena y un
+    // puntero viejo que se sigue usando no cae en memoria válida
+    size_t old_size = debug_check(buddy, ptr, 1);
+    if (old_size == SIZE_MAX) return NULL;
+#else
+    size_t old_size;
+    int bad;
+    slab_t *slab = find_slab(buddy, ptr, &bad);
+    if (slab && !slab_live(buddy, slab, ptr)) {
+        atomic_fetch_add_explicit(&buddy->bad_frees, 1, memory_order_relaxed);
+        TRACE(buddy, BUDDY_EV_BAD_FREE, ptr, 0, -1);
+        return NULL;
+    }
+    if (slab) {
+        old_size = buddy->slab_classes[slab->size_class].object_size;
+        if (size <= old_size) return ptr;
+    } else {
+        int order = bad ? -1 : find_used_order(buddy, ptr);
+        if (order < 0) {
+            atomic_fetch_add_explicit(&buddy->bad_frees, 1, memory_order_relaxed);
+            TRACE(buddy, BUDDY_EV_BAD_FREE, ptr, 0, -1);
+            return NULL;
+        }
+        old_size = (size_t)MIN_BLOCK_SIZE << order;
+        int new_order = size <= buddy->total_size ? find_order(size) : buddy->max_order + 1;
+        if (new_order == order) return ptr;
+        if (buddy->concurrent) pthread_mutex_lock(&buddy->lock);
+        int done = resize_in_place(buddy, block_offset(buddy, ptr), order, new_order);
+        if (done) counter_add(&buddy->requested, size);
+        if (buddy->concurrent) pthread_mutex_unlock(&buddy->lock);
+        if (done) {
+            TRACE(buddy, BUDDY_EV_REALLOC, ptr, size, new_order);
+            return ptr;
+        }
+    }
+#endif
+
+    // No se pudo en el lugar: asignar, copiar y liberar
+    void *moved = buddy_alloc(buddy, size);
+    if (!moved) return NULL;
+    memcpy(moved, ptr, old_size < size ? old_size : size);
+    buddy_free(buddy, ptr);
+    return moved;
+}
 
-        block = left_block;
+// Devuelve ptr al asignador
+static void free_ptr(buddy_system_t *buddy, void *ptr) {
+    int bad;
+    slab_t *slab = find_slab(buddy, ptr, &bad);
+    if (slab) {
+        slab_free(buddy, slab, ptr);
+        return;
     }
+    int order = bad ? -1 : find_used_order(buddy, ptr);
+    if (order < 0) {
+        atomic_fetch_add_explicit(&buddy->bad_frees, 1, memory_order_relaxed);
+        TRACE(buddy, BUDDY_EV_BAD_FREE, ptr, 0, -1);
+        return;
+    }
+    // Se traza antes de liberar: después el bloque ya puede ser de otro hilo
+    TRACE(buddy, BUDDY_EV_FREE, ptr, (size_t)MIN_BLOCK_SIZE << order, order);
+    if (buddy->concurrent) {
+        concurrent_free(buddy, ptr, order);
+        return;
+    }
+    core_free(buddy, block_offset(buddy, ptr), order);
+    counter_add(&buddy->frees[order], 1);
 }
 
 // Libera memoria (como free pero usando buddy)
 void buddy_free(buddy_system_t *buddy, void *ptr) {
     if (!ptr || !buddy) return;
-    block_t *block = (block_t*)((uint8_t*)ptr - sizeof(block_t));
+#if BUDDY_DEBUG
+    // ptr queda en la cuarentena; se liberan de verdad los que salen de ella
+    void *victims[QUARANTINE_EVICT];
+    size_t n = debug_quarantine(buddy, ptr, victims);
+    for (size_t i = 0; i < n; i++) free_ptr(buddy, victims[i]);
+#else
+    free_ptr(buddy, ptr);
+#endif
+}
+
+// Modo concurrente: devuelve al núcleo la caché del hilo. En modo debug
+// antes vacía la cuarentena (en cualquier modo).
+void buddy_thread_flush(buddy_system_t *buddy) {
+#if BUDDY_DEBUG
+    if (buddy) {
+        void *ptr;
+        while ((ptr = debug_unquarantine(buddy)) != NULL) free_ptr(buddy, ptr);
+    }
+#endif
+    if (!buddy || !buddy->concurrent) return;
+    thread_cache_t *tc = pthread_getspecific(buddy->cache_key);
+    pthread_mutex_lock(&buddy->lock);
+    if (tc) cache_flush(buddy, tc);
+    else drain_remote(buddy);
+    pthread_mutex_unlock(&buddy->lock);
+}
 
-    printf("Liberando memoria: %p (bloque: %p, tamano: %zu)\n", 
-           ptr, block, block->size);
+// Bytes que se pueden usar en ptr (tamaño del bloque o del objeto del slab);
+// 0 si ptr no es un bloque asignado de este buddy. En modo debug son los
+// bytes pedidos: los demás son del canario.
+size_t buddy_usable_size(buddy_system_t *buddy, void *ptr) {
+    if (!buddy || !ptr) return 0;
+#if BUDDY_DEBUG
+    size_t size = debug_check(buddy, ptr, 0);
+    return size == SIZE_MAX ? 0 : size;
+#else
+    return block_usable(buddy, ptr);
+#endif
+}
 
-    if (block->is_free) {
-        printf("  Error: bloque ya esta libre\n");
-        return;
+// Para fork en modo concurrente: antes de fork se toman todos los locks (en
+// el mismo orden que slab_alloc: clases y después el núcleo) y después se
+// sueltan en los dos procesos. En el hijo solo queda el hilo que llamó a
+// fork; las cachés de los demás hilos quedan marcadas en uso, con sus
+// bloques, y no se vuelven a usar (pudieron quedar a medio modificar).
+void buddy_atfork_prepare(buddy_system_t *buddy) {
+    if (!buddy || !buddy->concurrent) return;
+    if (buddy->quarantine) pthread_mutex_lock(&buddy->quarantine->lock);
+    if (buddy->slabs) {
+        for (int c = 0; c < BUDDY_SLAB_CLASSES; c++) pthread_mutex_lock(&buddy->slab_classes[c].lock);
     }
+    pthread_mutex_lock(&buddy->lock);
+}
 
-    // Calculamos cuánta memoria de usuario se libera
-    size_t user_memory = block->size - sizeof(block_t);
-    if (buddy->used_memory >= user_memory) {
-        buddy->used_memory -= user_memory;
-    } else {
-        buddy->used_memory = 0;
+void buddy_atfork_parent(buddy_system_t *buddy) {
+    if (!buddy || !buddy->concurrent) return;
+    pthread_mutex_unlock(&buddy->lock);
+    if (buddy->slabs) {
+        for (int c = BUDDY_SLAB_CLASSES - 1; c >= 0; c--) pthread_mutex_unlock(&buddy->slab_classes[c].lock);
     }
+    if (buddy->quarantine) pthread_mutex_unlock(&buddy->quarantine->lock);
+}
 
-    block->is_free = 1;
-    int order = find_order(block->size);
-    if (order > buddy->max_order) {
-        order = buddy->max_order;
+void buddy_atfork_child(buddy_system_t *buddy) {
+    buddy_atfork_parent(buddy);
+}
+
+// Pide n bloques de size bytes de una vez. Los bloques del buddy salen de
+// pocos bloques grandes cortados de una vez (core_alloc_batch) y en modo
+// concurrente primero de la caché del hilo; el lock se toma una sola vez.
+size_t buddy_alloc_batch(buddy_system_t *buddy, size_t size, size_t n, void **out) {
+    if (!buddy || size == 0) return 0;
+    size_t done = 0;
+#if BUDDY_DEBUG
+    // Cada bloque necesita su canario: uno por uno
+    while (done < n && (out[done] = buddy_alloc(buddy, size)) != NULL) done++;
+    for (size_t i = done; i < n; i++) out[i] = NULL;
+    return done;
+#endif
+
+    if (buddy->slabs && size <= BUDDY_SLAB_MAX) {
+        int c = slab_class_of[(size + 7) >> 3];
+        slab_class_t *cls = &buddy->slab_classes[c];
+        if (buddy->concurrent) pthread_mutex_lock(&cls->lock);
+        while (done < n && (out[done] = slab_alloc_locked(buddy, c, size)) != NULL) done++;
+        if (buddy->concurrent) pthread_mutex_unlock(&cls->lock);
     }
 
-    // Metemos el bloque en la lista libre
-    block->next = buddy->free_lists[order];
-    block->prev = NULL;
-    if (buddy->free_lists[order]) {
-        buddy->free_lists[order]->prev = block;
+    int order = size <= buddy->total_size ? find_order(size) : -1;
+    if (done < n && order >= 0) {
+        thread_cache_t *tc = buddy->concurrent && order < MAG_ORDERS ? get_cache(buddy) : NULL;
+        if (tc) {
+            size_t from_cache = 0;
+            while (done < n && tc->count[order] > 0) {
+                out[done] = tc->blocks[order][--tc->count[order]];
+                cached_unmark(buddy->cached_bits, block_bit(buddy, block_offset(buddy, out[done]), order));
+                done++;
+                from_cache++;
+            }
+            counter_add(&tc->allocs[order], from_cache);
+            counter_add(&tc->requested, from_cache * size);
+        }
+        if (done < n) {
+            if (buddy->concurrent) {
+                pthread_mutex_lock(&buddy->lock);
+                drain_remote(buddy);
+            }
+            size_t got = core_alloc_batch(buddy, order, n - done, out + done);
+            counter_add(&buddy->allocs[order], got);
+            counter_add(&buddy->requested, got * size);
+            if (buddy->concurrent) pthread_mutex_unlock(&buddy->lock);
+            done += got;
+        }
     }
-    buddy->free_lists[order] = block;
 
-    // Intentamos fusionar con su buddy
-    merge_buddies(buddy, block);
+    for (size_t i = 0; i < done; i++) {
+        TRACE(buddy, BUDDY_EV_ALLOC, out[i], size, order);
+    }
+    if (done < n) {
+        atomic_fetch_add_explicit(&buddy->failed_allocs, 1, memory_order_relaxed);
+        TRACE(buddy, BUDDY_EV_NO_MEMORY, NULL, size, order);
+        for (size_t i = done; i < n; i++) out[i] = NULL;
+    }
+    return done;
 }
 
-// Imprime el porcentaje de cobertura/utilización de la memoria
-void buddy_print_coverage(buddy_system_t *buddy) {
-    size_t total_available = buddy->total_size;
-    size_t memory_with_overhead = buddy->used_memory + buddy->overhead_memory;
+#define FREE_BATCH_GROUP 64
+
+// Libera n punteros de una vez. Los bloques que vuelven al núcleo se
+// liberan todos primero y recién después se fusionan, con el lock tomado una
+// vez por grupo de FREE_BATCH_GROUP: un bloque que ya quedó absorbido por la
+// fusión de otro del mismo lote no se vuelve a procesar.
+void buddy_free_batch(buddy_system_t *buddy, void **ptrs, size_t n) {
+    if (!buddy) return;
+#if BUDDY_DEBUG
+    // Cada puntero se valida y pasa por la cuarentena
+    for (size_t i = 0; i < n; i++) buddy_free(buddy, ptrs[i]);
+    return;
+#endif
+    for (size_t start = 0; start < n; start += FREE_BATCH_GROUP) {
+        size_t end = n - start < FREE_BATCH_GROUP ? n : start + FREE_BATCH_GROUP;
+        size_t offsets[FREE_BATCH_GROUP];
+        int orders[FREE_BATCH_GROUP];
+        size_t m = 0;
+        slab_class_t *locked = NULL;  // Lock de clase tomado (objetos seguidos de la misma clase)
+
+        for (size_t i = start; i < end; i++) {
+            void *ptr = ptrs[i];
+            if (!ptr) continue;
+            int bad;
+            slab_t *slab = find_slab(buddy, ptr, &bad);
+            if (slab) {
+                slab_class_t *cls = &buddy->slab_classes[slab->size_class];
+                if (buddy->concurrent && cls != locked) {
+                    if (locked) pthread_mutex_unlock(&locked->lock);
+                    pthread_mutex_lock(&cls->lock);
+                    locked = cls;
+                }
+                slab_free_locked(buddy, slab, ptr);
+                continue;
+            }
+            int order = bad ? -1 : find_used_order(buddy, ptr);
+            if (order < 0) {
+                atomic_fetch_add_explicit(&buddy->bad_frees, 1, memory_order_relaxed);
+                TRACE(buddy, BUDDY_EV_BAD_FREE, ptr, 0, -1);
+                continue;
+            }
+            TRACE(buddy, BUDDY_EV_FREE, ptr, (size_t)MIN_BLOCK_SIZE << order, order);
+            if (buddy->concurrent && order < MAG_ORDERS && get_cache(buddy)) {
+                concurrent_free(buddy, ptr, order);  // A la caché del hilo
+                continue;
+            }
+            offsets[m] = block_offset(buddy, ptr);
+            orders[m++] = order;
+        }
+        if (locked) pthread_mutex_unlock(&locked->lock);
+        if (m == 0) continue;
 
-    if (total_available == 0) total_available = 1;
+        if (buddy->concurrent) {
+            pthread_mutex_lock(&buddy->lock);
+            drain_remote(buddy);
+        }
+        for (size_t i = 0; i < m; i++) {
+            // Repetido dentro del lote: el segundo ya no está asignado
+            if (!used_test(buddy->used_bits, block_bit(buddy, offsets[i], orders[i]))) {
+                atomic_fetch_add_explicit(&buddy->bad_frees, 1, memory_order_relaxed);
+                orders[i] = -1;
+                continue;
+            }
+            core_release(buddy, offsets[i], orders[i]);
+            counter_add(&buddy->frees[orders[i]], 1);
+        }
+        for (size_t i = 0; i < m; i++) {
+            // Solo si sigue libre con su orden (no lo absorbió otra fusión)
+            if (orders[i] >= 0 && bit_test(buddy->free_bits, block_bit(buddy, offsets[i], orders[i]))) {
+                coalesce(buddy, offsets[i], orders[i]);
+            }
+        }
+        if (buddy->concurrent) pthread_mutex_unlock(&buddy->lock);
+    }
+}
 
-    double utilization_percentage = (double)buddy->used_memory / total_available * 100.0;
-    double overhead_percentage = (double)buddy->overhead_memory / total_available * 100.0;
-    double total_usage_percentage = (double)memory_with_overhead / total_available * 100.0;
+void buddy_set_trace_hook(buddy_system_t *buddy, buddy_trace_fn hook, void *ctx) {
+    buddy->trace = hook;
+    buddy->trace_ctx = ctx;
+}
 
-    if (utilization_percentage > 100.0) utilization_percentage = 100.0;
-    if (overhead_percentage > 100.0) overhead_percentage = 100.0;
-    if (total_usage_percentage > 100.0) total_usage_percentage = 100.0;
+// Junta los contadores del núcleo con los de cada caché de hilo
+void buddy_get_stats(buddy_system_t *buddy, buddy_stats_t *stats) {
+    memset(stats, 0, sizeof(*stats));
+    stats->total_size = buddy->total_size;
+    stats->committed_bytes = counter_get(&buddy->committed);
+    stats->chunks_added = counter_get(&buddy->chunks_added);
+    stats->chunks_released = counter_get(&buddy->chunks_released);
+    stats->overhead_bytes = buddy->overhead_memory;
+    stats->max_order = buddy->max_order;
+    stats->failed_allocs = counter_get(&buddy->failed_allocs);
+    stats->bad_frees = counter_get(&buddy->bad_frees);
+    stats->faults = counter_get(&buddy->faults);
+    stats->splits = counter_get(&buddy->splits);
+    stats->merges = counter_get(&buddy->merges);
+    stats->high_water = counter_get(&buddy->high_water);
+
+    stats->requested_bytes = counter_get(&buddy->requested);
+
+    int64_t live[BUDDY_MAX_ORDERS] = {0};
+    uint64_t granted[BUDDY_MAX_ORDERS] = {0};
+    for (int k = 0; k <= buddy->max_order; k++) {
+        uint64_t a = counter_get(&buddy->allocs[k]), f = counter_get(&buddy->frees[k]);
+        stats->allocs += a;
+        stats->frees += f;
+        live[k] = (int64_t)(a - f);
+        granted[k] = a;
+        stats->free_blocks[k] = counter_get(&buddy->free_count[k]);
+    }
+    if (buddy->concurrent) {
+        for (thread_cache_t *tc = atomic_load_explicit(&buddy->caches, memory_order_acquire); tc;
+             tc = tc->next) {
+            for (int k = 0; k < MAG_ORDERS && k <= buddy->max_order; k++) {
+                uint64_t a = counter_get(&tc->allocs[k]), f = counter_get(&tc->frees[k]);
+                stats->allocs += a;
+                stats->frees += f;
+                live[k] += (int64_t)(a - f);
+                granted[k] += a;
+            }
+            stats->requested_bytes += counter_get(&tc->requested);
+        }
+    }
+
+    // Un bloque puede asignarse en un hilo y liberarse en otro: sin lock se
+    // puede ver la liberación antes que la asignación, de ahí el recorte en 0
+    size_t out_of_core = counter_get(&buddy->used_memory);
+    size_t block_bytes = 0;
+    for (int k = 0; k <= buddy->max_order; k++) {
+        stats->used_blocks[k] = live[k] > 0 ? (uint64_t)live[k] : 0;
+        block_bytes += (size_t)stats->used_blocks[k] * ((size_t)MIN_BLOCK_SIZE << k);
+        stats->granted_bytes += granted[k] * ((uint64_t)MIN_BLOCK_SIZE << k);
+    }
+
+    size_t object_bytes = 0;
+    for (int c = 0; c < BUDDY_SLAB_CLASSES; c++) {
+        slab_class_t *cls = &buddy->slab_classes[c];
+        stats->slab_object_size[c] = slab_sizes[c];
+        if (!buddy->slabs) continue;
+        uint64_t a = counter_get(&cls->allocs), f = counter_get(&cls->frees);
+        stats->allocs += a;
+        stats->frees += f;
+        stats->requested_bytes += counter_get(&cls->requested);
+        stats->granted_bytes += a * cls->object_size;
+        stats->slab_objects[c] = a > f ? a - f : 0;
+        stats->slab_pages[c] = counter_get(&cls->slabs);
+        stats->slab_bytes += (size_t)stats->slab_pages[c] * ((size_t)MIN_BLOCK_SIZE << cls->slab_order);
+        object_bytes += (size_t)stats->slab_objects[c] * cls->object_size;
+    }
+    if (object_bytes > stats->slab_bytes) object_bytes = stats->slab_bytes;
+    stats->slab_free_bytes = stats->slab_bytes - object_bytes;
+
+    if (block_bytes + stats->slab_bytes > out_of_core) block_bytes = out_of_core - stats->slab_bytes;
+    stats->used_bytes = block_bytes + object_bytes;
+    stats->cached_bytes = out_of_core - block_bytes - stats->slab_bytes;
+}
+
+// Imprime el porcentaje de cobertura/utilización de la memoria
+void buddy_print_coverage(buddy_system_t *buddy) {
+    buddy_stats_t stats;
+    buddy_get_stats(buddy, &stats);
+    // En una arena que crece, lo disponible es lo que ya se agregó
+    size_t total_available = stats.committed_bytes;
+    if (total_available == 0) total_available = 1;
 
-    double fragmentation_percentage = total_usage_percentage - utilization_percentage;
+    double utilization_percentage = (double)stats.used_bytes / total_available * 100.0;
+    double overhead_percentage = (double)stats.overhead_bytes / total_available * 100.0;
 
-    size_t free_memory = (memory_with_overhead > total_available) ? 0 : total_available - memory_with_overhead;
+    size_t free_memory = total_available - stats.used_bytes - stats.cached_bytes - stats.slab_free_bytes;
     double free_percentage = (double)free_memory / total_available * 100.0;
 
     printf("\n=== PORCENTAJE DE COBERTURA ===\n");
     printf("Memoria total disponible: %zu bytes\n", total_available);
-    printf("Memoria util utilizada:   %zu bytes (%.2f%%)\n", 
-           buddy->used_memory, utilization_percentage);
-    printf("Overhead de headers:      %zu bytes (%.2f%%)\n", 
-           buddy->overhead_memory, overhead_percentage);
-    printf("Fragmentacion interna:    %.2f%%\n", fragmentation_percentage);
-    printf("Uso total:                %.2f%%\n", total_usage_percentage);
-    printf("Memoria libre:            %zu bytes (%.2f%%)\n", 
+    if (stats.total_size != stats.committed_bytes) {
+        printf("Espacio reservado:        %zu bytes (%" PRIu64 " chunks agregados, %" PRIu64
+               " devueltos al sistema)\n", stats.total_size, stats.chunks_added, stats.chunks_released);
+    }
+    printf("Memoria asignada:         %zu bytes (%.2f%%)\n",
+           stats.used_bytes, utilization_percentage);
+    if (stats.cached_bytes) {
+        printf("En caches de hilos:       %zu bytes\n", stats.cached_bytes);
+    }
+    printf("Metadatos (fuera del pool): %zu bytes (%.2f%%)\n",
+           stats.overhead_bytes, overhead_percentage);
+    printf("Memoria libre:            %zu bytes (%.2f%%)\n",
            free_memory, free_percentage);
+    printf("Maximo usado:             %zu bytes (%.2f%%)\n",
+           stats.high_water, (double)stats.high_water / total_available * 100.0);
+    if (stats.slab_bytes) {
+        printf("Paginas de slabs:         %zu bytes (%zu sin objetos asignados)\n",
+               stats.slab_bytes, stats.slab_free_bytes);
+    }
+    // Fragmentación interna: lo que se entregó de más al redondear cada pedido
+    if (stats.granted_bytes) {
+        printf("Fragmentacion interna:    %.2f%% (%" PRIu64 " bytes pedidos, %" PRIu64 " entregados)\n",
+               (double)(stats.granted_bytes - stats.requested_bytes) / stats.granted_bytes * 100.0,
+               stats.requested_bytes, stats.granted_bytes);
+    }
 
     // Chequeamos si llegamos al 80%
     if (utilization_percentage >= 80.0) {
@@ -360,20 +1778,27 @@ void buddy_print_coverage(buddy_system_t *buddy) {
 
 // Imprime el estado de la memoria (cuántos bloques libres hay por orden)
 void buddy_print_status(buddy_system_t *buddy) {
+    buddy_stats_t stats;
+    buddy_get_stats(buddy, &stats);
     printf("\n=== Estado del Buddy System ===\n");
-    printf("Tamano total: %zu bytes\n", buddy->total_size);
+    printf("Tamano total: %zu bytes\n", stats.total_size);
 
-    for (int i = 0; i <= buddy->max_order; i++) {
-        size_t block_size = MIN_BLOCK_SIZE * (1 << i);
-        printf("Orden %d (tamano %4zu): ", i, block_size);
-
-        block_t *current = buddy->free_lists[i];
-        int count = 0;
-        while (current) {
-            count++;
-            current = current->next;
-        }
-        printf("%d bloques libres\n", count);
+    for (int i = 0; i <= stats.max_order; i++) {
+        size_t block_size = (size_t)MIN_BLOCK_SIZE << i;
+        printf("Orden %d (tamano %4zu): %" PRIu64 " bloques libres, %" PRIu64 " asignados\n",
+               i, block_size, stats.free_blocks[i], stats.used_blocks[i]);
+    }
+    for (int c = 0; c < BUDDY_SLAB_CLASSES; c++) {
+        if (stats.slab_pages[c] == 0) continue;
+        printf("Slab de %3u bytes: %" PRIu64 " objetos en %" PRIu64 " slabs\n",
+               stats.slab_object_size[c], stats.slab_objects[c], stats.slab_pages[c]);
+    }
+    printf("Operaciones: %" PRIu64 " asignaciones, %" PRIu64 " liberaciones, %" PRIu64
+           " divisiones, %" PRIu64 " fusiones\n",
+           stats.allocs, stats.frees, stats.splits, stats.merges);
+    if (stats.failed_allocs || stats.bad_frees) {
+        printf("Errores: %" PRIu64 " pedidos sin memoria, %" PRIu64 " liberaciones invalidas\n",
+               stats.failed_allocs, stats.bad_frees);
     }
 
     // Mostramos la cobertura
@@ -382,10 +1807,54 @@ void buddy_print_status(buddy_system_t *buddy) {
 
 // Libera toda la memoria del sistema buddy
 void buddy_destroy(buddy_system_t *buddy) {
-    if (buddy) {
-        free(buddy->memory_pool);
-        free(buddy->free_lists);
-        free(buddy);
+    if (!buddy) return;
+    if (buddy->concurrent) {
+        // Las cachés de los hilos que siguen vivos se descartan con el pool
+        pthread_key_delete(buddy->cache_key);
+        thread_cache_t *tc = atomic_load(&buddy->caches);
+        while (tc) {
+            thread_cache_t *next = tc->next;
+            os_unmap(tc, sizeof(thread_cache_t));
+            tc = next;
+        }
+        pthread_mutex_destroy(&buddy->lock);
+        for (int c = 0; c < BUDDY_SLAB_CLASSES; c++) {
+            pthread_mutex_destroy(&buddy->slab_classes[c].lock);
+        }
+    }
+    free_metadata(buddy);
+}
+
+#ifndef BUDDY_NO_MAIN
+// Hook del demo: imprime cada operación
+static void print_trace(buddy_event_t event, void *ptr, size_t size, int order, void *ctx) {
+    (void)ctx;
+    switch (event) {
+    case BUDDY_EV_ALLOC:
+        printf("Memoria asignada: %p (pedido: %zu, tamano de bloque: %zu, orden %d)\n",
+               ptr, size, (size_t)MIN_BLOCK_SIZE << order, order);
+        break;
+    case BUDDY_EV_FREE:
+        printf("Liberando memoria: %p (tamano: %zu)\n", ptr, size);
+        break;
+    case BUDDY_EV_SPLIT:
+        printf("  Bloque dividido: orden %d -> orden %d (tamano: %zu)\n", order + 1, order, size);
+        break;
+    case BUDDY_EV_MERGE:
+        printf("  Bloques fusionados: nuevo tamano %zu (orden %d)\n", size, order);
+        break;
+    case BUDDY_EV_NO_MEMORY:
+        printf("No hay memoria disponible para %zu bytes\n", size);
+        break;
+    case BUDDY_EV_REALLOC:
+        printf("Bloque redimensionado en el lugar: %p (pedido: %zu, orden %d)\n", ptr, size, order);
+        break;
+    case BUDDY_EV_BAD_FREE:
+        printf("Error: %p no es un bloque asignado (o ya esta libre)\n", ptr);
+        break;
+    case BUDDY_EV_CORRUPTION:
+        printf("Error: memoria corrupta en %p (falla %d)\n", ptr, order);
+        break;
     }
 }
 
@@ -398,6 +1867,13 @@ int main() {
         printf("Error: No se pudo inicializar el buddy system\n");
         return 1;
     }
+    buddy_set_trace_hook(buddy, print_trace, NULL);
+
+    printf("Buddy System inicializado:\n");
+    printf("  Tamano total: %zu bytes\n", buddy->total_size);
+    printf("  Orden maximo: %d\n", buddy->max_order);
+    printf("  Bloque minimo: %d bytes\n", MIN_BLOCK_SIZE);
+    printf("  Overhead inicial: %zu bytes (bitmaps, sin headers)\n", buddy->overhead_memory);
 
     buddy_print_status(buddy);
 
@@ -420,25 +1896,28 @@ int main() {
     buddy_print_status(buddy);
 
     // RESULTADO FINAL
+    buddy_stats_t stats;
+    buddy_get_stats(buddy, &stats);
+    double max_coverage = (double)stats.high_water / stats.total_size * 100.0;
     printf("=== INFORME FINAL ===\n");
     printf("RESULTADO: ");
-    if (buddy->max_coverage >= 80.0) {
+    if (max_coverage >= 80.0) {
         printf("EXITO - Se supero el objetivo del 80%%\n");
-        printf("Cobertura maxima alcanzada: %.2f%%\n", buddy->max_coverage);
+        printf("Cobertura maxima alcanzada: %.2f%%\n", max_coverage);
     } else {
         printf("FALLO - No se alcanzo el objetivo del 80%%\n");
-        printf("Cobertura maxima alcanzada: %.2f%%\n", buddy->max_coverage);
+        printf("Cobertura maxima alcanzada: %.2f%%\n", max_coverage);
     }
 
     printf("\nANALISIS:\n");
     printf("- Se usaron 2 bloques grandes (500 + 400 bytes)\n");
-    printf("- Menos overhead que muchos bloques chicos\n");
+    printf("- Los bloques no llevan header: el estado vive en bitmaps por orden\n");
     printf("- El sistema si junta bloques al liberar (coalescing)\n");
-    printf("- La cobertura de %.2f%% muestra que el buddy system es eficiente\n", buddy->max_coverage);
+    printf("- La cobertura de %.2f%% muestra que el buddy system es eficiente\n", max_coverage);
     printf("- Estado final 0%% es normal: toda la memoria fue liberada\n");
 
     printf("\nCONCLUSION: ");
-    if (buddy->max_coverage >= 80.0) {
+    if (max_coverage >= 80.0) {
         printf("EL SISTEMA BUDDY ES EFICIENTE PARA >80%% DE COBERTURA\n");
     } else {
         printf("SE REQUIERE OPTIMIZACION PARA MEJORAR LA COBERTURA\n");
@@ -449,3 +1928,4 @@ int main() {
 
     return 0;
 }
+#endif
@@ -0,0 +1,263 @@
+#ifndef BUDDY_SYSTEM_H
+#define BUDDY_SYSTEM_H
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Definimos el tamaño total de la memoria y el tamaño mínimo de bloque
+#define MEMORY_SIZE 1024  // Memoria total del demo (debe ser potencia de 2)
+#define MIN_BLOCK_SIZE 16 // Bloque más pequeño (potencia de 2)
+#define MIN_BLOCK_SHIFT 4 // log2(MIN_BLOCK_SIZE)
+
+// Modo concurrente: los órdenes 0..MAG_ORDERS-1 (16 a 128 bytes) se sirven
+// desde una caché por hilo ("magazine") de hasta MAG_SIZE bloques por orden.
+#define MAG_ORDERS 4
+#define MAG_SIZE 32
+
+// Los bloques libres usan sus propios bytes para enlazarse en la lista libre
+// de su orden (por eso MIN_BLOCK_SIZE debe alcanzar para dos punteros).
+typedef struct free_block {
+    struct free_block *next;
+    struct free_block *prev;
+} free_block_t;
+
+// Bloque liberado que espera en la cola entre hilos (también vive dentro
+// del propio bloque)
+typedef struct remote_block {
+    struct remote_block *next;
+    int order;
+} remote_block_t;
+
+// Slabs: los pedidos de hasta BUDDY_SLAB_MAX bytes se sirven con objetos de
+// BUDDY_SLAB_CLASSES tamaños fijos (8, 16, 24, 32, 48, 64, 96, 128, 192, 256,
+// 384 y 512) recortados de páginas del buddy, sin redondear a potencia de 2.
+#define BUDDY_SLAB_CLASSES 12
+#define BUDDY_SLAB_MAX 512
+
+// Máximo de órdenes que soporta el sistema (pools de hasta 2^(BUDDY_MAX_ORDERS+3) bytes)
+#define BUDDY_MAX_ORDERS 48
+
+// Eventos que recibe el hook de trazas
+typedef enum {
+    BUDDY_EV_ALLOC,      // ptr asignado; size = bytes pedidos
+    BUDDY_EV_FREE,       // ptr liberado; size = tamaño del bloque
+    BUDDY_EV_SPLIT,      // ptr partido en dos de size bytes (orden nuevo)
+    BUDDY_EV_MERGE,      // ptr quedó fusionado en un bloque de size bytes
+    BUDDY_EV_NO_MEMORY,  // no hay bloque para size bytes
+    BUDDY_EV_BAD_FREE,   // ptr no es un bloque asignado (o ya estaba libre)
+    BUDDY_EV_REALLOC,    // ptr cambió de tamaño en el lugar; size = bytes pedidos
+    BUDDY_EV_CORRUPTION  // Solo con BUDDY_DEBUG: falla en ptr; order = buddy_fault_t
+} buddy_event_t;
+
+// Fallas que detecta el modo debug (compilar con -DBUDDY_DEBUG=1). Sin hook
+// de trazas se imprimen y se aborta; con hook se le avisan y la operación se
+// ignora, salvo BUDDY_FAULT_FREE_LIST, que aborta siempre.
+typedef enum {
+    BUDDY_FAULT_FOREIGN,         // El puntero no es de la arena
+    BUDDY_FAULT_NOT_ALLOCATED,   // Es de la arena pero no es un bloque asignado
+    BUDDY_FAULT_DOUBLE_FREE,     // Ya estaba liberado (en la cuarentena o en una caché)
+    BUDDY_FAULT_TRAILER,         // El trailer del bloque no pasa el checksum
+    BUDDY_FAULT_OVERFLOW,        // Se escribió después de los bytes pedidos
+    BUDDY_FAULT_USE_AFTER_FREE,  // Se escribió en el bloque mientras estaba en cuarentena
+    BUDDY_FAULT_FREE_LIST        // Enlaces de una lista libre rotos
+} buddy_fault_t;
+
+// Hook de trazas. Con BUDDY_TRACE=0 las llamadas ni se compilan; si no, cuesta
+// un if por operación mientras no haya hook. En modo concurrente se puede
+// llamar desde cualquier hilo y con el lock tomado, así que el hook no debe
+// usar el buddy.
+typedef void (*buddy_trace_fn)(buddy_event_t event, void *ptr, size_t size, int order, void *ctx);
+
+// Páginas grandes para la arena de buddy_init_ex
+typedef enum {
+    BUDDY_HUGE_NONE,         // Páginas normales
+    BUDDY_HUGE_TRANSPARENT,  // madvise(MADV_HUGEPAGE): el kernel las usa si puede
+    BUDDY_HUGE_EXPLICIT      // MAP_HUGETLB: falla si no hay páginas reservadas
+} buddy_huge_t;
+
+// Chunks libres que una arena mantiene en memoria antes de devolver el más viejo
+#define BUDDY_RETAIN_CHUNKS 2
+
+// Configuración de buddy_init_ex. Los campos en 0 toman el valor por defecto.
+// La arena reserva reserve_size bytes de espacio virtual de una vez, pero solo
+// usa memoria real de a chunks: empieza con initial_size y agrega un chunk
+// cada vez que se queda sin bloques. Si hay más de un chunk, los que vuelven a
+// quedar libres enteros se devuelven al sistema operativo con
+// madvise(MADV_DONTNEED), salvo los BUDDY_RETAIN_CHUNKS más recientes.
+typedef struct {
+    size_t reserve_size;     // Potencia de 2: tamaño máximo de la arena
+    size_t chunk_size;       // Potencia de 2 (por defecto min(reserve, 64 MiB))
+    size_t initial_size;     // Por defecto un chunk
+    buddy_huge_t huge_pages;
+    size_t huge_page_size;   // Solo con BUDDY_HUGE_EXPLICIT (por defecto 2 MiB)
+    int keep_free_chunks;    // 1 = no devolver chunks libres al sistema
+    int concurrent;          // 1 = igual que buddy_init_concurrent
+    int slabs;               // 1 = usar slabs para pedidos chicos
+} buddy_config_t;
+
+// Copia de los contadores que devuelve buddy_get_stats
+typedef struct {
+    size_t total_size;       // Espacio reservado
+    size_t committed_bytes;  // Chunks agregados hasta ahora
+    size_t overhead_bytes;   // Metadatos, fuera del pool
+    int max_order;
+    uint64_t chunks_added;   // Veces que la arena creció
+    uint64_t chunks_released;  // Veces que se devolvió memoria al sistema
+    uint64_t allocs;         // buddy_alloc exitosos
+    uint64_t frees;          // buddy_free válidos
+    uint64_t failed_allocs;  // Pedidos sin memoria suficiente
+    uint64_t bad_frees;      // Punteros que no eran bloques asignados
+    uint64_t faults;         // Fallas del modo debug
+    uint64_t splits;
+    uint64_t merges;
+    size_t used_bytes;       // En bloques que tiene el usuario
+    size_t cached_bytes;     // En cachés de hilos (modo concurrente)
+    size_t high_water;       // Máximo de bytes fuera del núcleo (usados + en caché)
+    // Fragmentación interna: lo pedido contra lo entregado, sumando todas las
+    // asignaciones desde el inicio
+    uint64_t requested_bytes;
+    uint64_t granted_bytes;
+    // Slabs
+    size_t slab_bytes;       // Páginas del buddy que son slabs
+    size_t slab_free_bytes;  // Lo que en ellas no es un objeto asignado
+    uint32_t slab_object_size[BUDDY_SLAB_CLASSES];
+    uint64_t slab_objects[BUDDY_SLAB_CLASSES];  // Objetos asignados por clase
+    uint64_t slab_pages[BUDDY_SLAB_CLASSES];    // Slabs por clase
+    uint64_t free_blocks[BUDDY_MAX_ORDERS];  // Por orden, en las listas libres
+    uint64_t used_blocks[BUDDY_MAX_ORDERS];  // Por orden, en manos del usuario
+} buddy_stats_t;
+
+struct thread_cache;
+struct slab;
+struct quarantine;
+
+// Una clase de tamaño de los slabs
+typedef struct {
+    struct slab *partial;      // Slabs con lugar libre
+    uint32_t object_size;
+    int slab_order;            // Orden del bloque de cada slab
+    pthread_mutex_t lock;      // Solo en modo concurrente
+    // Se escriben con el lock de la clase tomado
+    _Atomic uint64_t allocs, frees, requested, slabs;
+} slab_class_t;
+
+// Estructura principal del sistema buddy
+typedef struct {
+    void *memory_pool;       // Inicio del espacio reservado
+    free_block_t *free_lists[BUDDY_MAX_ORDERS];
+    int max_order;
+    size_t total_size;       // Tamaño reservado (potencia de 2)
+    size_t base_align;       // Alineación de memory_pool (hasta total_size)
+    size_t overhead_memory;  // Bytes de metadatos (listas y bitmaps)
+    size_t metadata_size;    // Bytes mapeados para esta estructura y los bitmaps
+    // Bitmaps: el bloque i del orden k es el bit bit_base[k] + i
+    uint64_t *free_bits;            // 1 = hay un bloque libre de ese orden ahí
+    _Atomic uint64_t *used_bits;    // 1 = hay un bloque asignado de ese orden ahí
+    _Atomic uint64_t *cached_bits;  // Modo concurrente, órdenes < MAG_ORDERS: 1 = está en una caché
+    size_t bit_base[BUDDY_MAX_ORDERS];
+
+    // Crecimiento de la arena (con el lock tomado en modo concurrente)
+    int chunk_order;              // Orden de un chunk
+    size_t page_size;             // Granularidad para devolver memoria
+    int release_chunks;
+    buddy_huge_t huge_pages;
+    _Atomic uint64_t committed;   // Bytes desde el inicio ya agregados a la arena
+    _Atomic uint64_t chunks_added, chunks_released;
+    size_t retain[BUDDY_RETAIN_CHUNKS];  // Chunks libres que todavía no se devolvieron
+    int retained;
+
+    // Trazas (se configura antes de compartir el buddy entre hilos)
+    buddy_trace_fn trace;
+    void *trace_ctx;
+
+    // Contadores del núcleo: se escriben desde un solo hilo o con el lock
+    // tomado, y buddy_get_stats los lee sin lock
+    _Atomic uint64_t used_memory;   // Bytes fuera del núcleo
+    _Atomic uint64_t high_water;
+    _Atomic uint64_t splits, merges;
+    _Atomic uint64_t free_count[BUDDY_MAX_ORDERS];
+    _Atomic uint64_t allocs[BUDDY_MAX_ORDERS];  // Los de las cachés van aparte
+    _Atomic uint64_t frees[BUDDY_MAX_ORDERS];
+    _Atomic uint64_t failed_allocs, bad_frees;  // Raros: fetch_add desde cualquier hilo
+    _Atomic uint64_t faults;
+    _Atomic uint64_t requested;                 // Bytes pedidos (sin cachés ni slabs)
+
+    // --- Solo con BUDDY_DEBUG (si no, NULL) ---
+    struct quarantine *quarantine;  // Bloques liberados que todavía no se reusan
+
+    // --- Solo con slabs ---
+    int slabs;
+    _Atomic uint8_t *page_kind;   // Por página de 4 KiB: log2 del tamaño de su slab, o 0
+    slab_class_t slab_classes[BUDDY_SLAB_CLASSES];
+
+    // --- Solo en modo concurrente ---
+    int concurrent;
+    pthread_mutex_t lock;                      // Protege listas libres y bitmaps
+    pthread_key_t cache_key;                   // Caché de cada hilo
+    _Atomic(struct thread_cache*) caches;      // Todas las cachés (solo crece)
+    _Atomic(remote_block_t*) remote_free;      // Pila sin lock de liberaciones pendientes
+} buddy_system_t;
+
+// Crea un buddy system de total_size bytes (potencia de 2) para un solo hilo
+buddy_system_t* buddy_init(size_t total_size);
+
+// Igual, pero se puede usar desde varios hilos a la vez
+buddy_system_t* buddy_init_concurrent(size_t total_size);
+
+// Arena grande que crece de a chunks (ver buddy_config_t). Devuelve NULL si
+// la configuración no es válida o no se pudo reservar la memoria.
+buddy_system_t* buddy_init_ex(const buddy_config_t *config);
+
+void* buddy_alloc(buddy_system_t *buddy, size_t size);
+void buddy_free(buddy_system_t *buddy, void *ptr);
+
+// Como aligned_alloc: alignment tiene que ser potencia de 2 y a lo sumo
+// min(tamaño de la arena, 2 MiB). Se libera con buddy_free.
+void* buddy_aligned_alloc(buddy_system_t *buddy, size_t alignment, size_t size);
+
+// Como realloc: agranda o achica en el lugar cuando puede y si no, copia
+void* buddy_realloc(buddy_system_t *buddy, void *ptr, size_t size);
+
+// Bytes utilizables en ptr (como malloc_usable_size); 0 si no es un bloque
+// asignado de este buddy
+size_t buddy_usable_size(buddy_system_t *buddy, void *ptr);
+
+// Para pthread_atfork en modo concurrente: prepare toma todos los locks y
+// parent/child los sueltan después del fork
+void buddy_atfork_prepare(buddy_system_t *buddy);
+void buddy_atfork_parent(buddy_system_t *buddy);
+void buddy_atfork_child(buddy_system_t *buddy);
+
+// Pide n bloques de size bytes de una vez y los deja en out. Devuelve cuántos
+// consiguió (el resto de out queda en NULL).
+size_t buddy_alloc_batch(buddy_system_t *buddy, size_t size, size_t n, void **out);
+
+// Libera los n punteros de ptrs (los NULL se ignoran) y fusiona al final
+void buddy_free_batch(buddy_system_t *buddy, void **ptrs, size_t n);
+
+// Modo concurrente: devuelve al núcleo los bloques de la caché del hilo que
+// llama (al terminar un hilo esto pasa solo). En modo debug además libera
+// todo lo que esté en la cuarentena.
+void buddy_thread_flush(buddy_system_t *buddy);
+
+// Instala (o con NULL, quita) el hook de trazas
+void buddy_set_trace_hook(buddy_system_t *buddy, buddy_trace_fn hook, void *ctx);
+
+// Llena stats sin tomar el lock. Mientras otros hilos trabajan los valores
+// pueden estar un poco desfasados entre sí.
+void buddy_get_stats(buddy_system_t *buddy, buddy_stats_t *stats);
+
+// Las dos funciones de impresión solo leen buddy_get_stats
+void buddy_print_coverage(buddy_system_t *buddy);
+
+void buddy_print_status(buddy_system_t *buddy);
+
+// Libera todo. En modo concurrente ningún otro hilo debe estar usándolo.
+void buddy_destroy(buddy_system_t *buddy);
+
+int calculate_max_order(size_t total_size, size_t min_block_size);
+int find_order(size_t size);
+
+#endif
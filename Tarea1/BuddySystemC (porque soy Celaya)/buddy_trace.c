@@ -0,0 +1,668 @@
+// Reproduce una traza de asignaciones sobre el buddy system (solo buddy y con
+// slabs) y sobre malloc/free de la libc, y compara throughput, latencia por
+// operación, RSS pico y fragmentación a lo largo de la traza.
+//
+// Formato de la traza: texto, una operación por línea ('#' = comentario)
+//   a <id> <bytes> [hilo]   asignar
+//   r <id> <bytes> [hilo]   realloc de un bloque vivo
+//   f <id> [hilo]           liberar
+// El id nombra al bloque mientras está vivo y se puede repetir después de
+// liberarlo (sirve, por ejemplo, la dirección que tenía en el programa
+// grabado). Cada hilo hace sus operaciones en orden y, si le toca un bloque
+// de otro hilo, espera a que la operación anterior sobre ese bloque ya se
+// haya hecho, así se respeta el orden de la grabación.
+//
+// Cada asignador corre en un proceso hijo (el RSS pico es solo suyo) y hace
+// dos pasadas: una sin medir nada por operación (throughput, RSS y
+// fragmentación) y otra tomando el tiempo de cada llamada (latencias).
+//
+// Uso:
+//   ./buddy_trace generar <archivo> [operaciones] [hilos] [semilla]
+//   ./buddy_trace <archivo>
+
+#define _DEFAULT_SOURCE // getrusage, sched_yield y clock_gettime con -std=c11
+
+#include <malloc.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "buddy_system.h"
+
+#define MAX_THREADS 64
+#define SAMPLES 20             // Puntos de la fragmentación en el tiempo
+#define CHUNK_SIZE ((size_t)1 << 22)
+
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+#define HAVE_MALLINFO2 1
+#else
+#define HAVE_MALLINFO2 0
+#endif
+
+// --- Traza en memoria ---
+
+typedef struct {
+    uint64_t size;
+    uint32_t slot;     // Bloque, con los id ya renumerados de 0 en adelante
+    uint32_t seq;      // Operaciones sobre el mismo bloque que van antes
+    uint16_t thread;
+    char op;           // 'a', 'r' o 'f'
+} event_t;
+
+typedef struct {
+    event_t *events;
+    size_t count;
+    uint32_t slots;
+    int threads;
+    uint32_t *by_thread[MAX_THREADS];  // Índices de los eventos de cada hilo
+    size_t per_thread[MAX_THREADS];
+    size_t step;                       // Cada cuántos eventos se toma una muestra
+    uint64_t live[SAMPLES];            // Bytes pedidos vivos en cada muestra
+    uint64_t peak_live;
+} trace_t;
+
+// id de la traza -> bloque vivo (direccionamiento abierto, borrado con
+// corrimiento hacia atrás para no dejar marcas)
+typedef struct {
+    uint64_t *keys;
+    uint32_t *vals;
+    uint8_t *used;
+    size_t cap, count;
+} id_map_t;
+
+static size_t id_hash(const id_map_t *m, uint64_t key) {
+    return (size_t)((key * 0x9E3779B97F4A7C15ull) >> 17) & (m->cap - 1);
+}
+
+static size_t id_find(const id_map_t *m, uint64_t key) {
+    size_t i = id_hash(m, key);
+    while (m->used[i] && m->keys[i] != key) i = (i + 1) & (m->cap - 1);
+    return i;
+}
+
+static void id_grow(id_map_t *m) {
+    id_map_t old = *m;
+    m->cap = old.cap ? old.cap * 2 : 1024;
+    m->keys = malloc(m->cap * sizeof(uint64_t));
+    m->vals = malloc(m->cap * sizeof(uint32_t));
+    m->used = calloc(m->cap, 1);
+    if (!m->keys || !m->vals || !m->used) {
+        printf("Error: sin memoria para leer la traza\n");
+        exit(1);
+    }
+    for (size_t i = 0; i < old.cap; i++) {
+        if (!old.used[i]) continue;
+        size_t j = id_find(m, old.keys[i]);
+        m->used[j] = 1;
+        m->keys[j] = old.keys[i];
+        m->vals[j] = old.vals[i];
+    }
+    free(old.keys);
+    free(old.vals);
+    free(old.used);
+}
+
+static void id_remove(id_map_t *m, size_t i) {
+    m->used[i] = 0;
+    m->count--;
+    // Los que siguen en la misma corrida se corren si su lugar ideal quedó atrás
+    for (size_t j = (i + 1) & (m->cap - 1); m->used[j]; j = (j + 1) & (m->cap - 1)) {
+        size_t home = id_hash(m, m->keys[j]);
+        if (((j - home) & (m->cap - 1)) >= ((j - i) & (m->cap - 1))) {
+            m->keys[i] = m->keys[j];
+            m->vals[i] = m->vals[j];
+            m->used[i] = 1;
+            m->used[j] = 0;
+            i = j;
+        }
+    }
+}
+
+static int load_trace(const char *path, trace_t *t) {
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        printf("Error: no se pudo abrir %s\n", path);
+        return 0;
+    }
+    memset(t, 0, sizeof(*t));
+    size_t cap = 1 << 16;
+    t->events = malloc(cap * sizeof(event_t));
+    uint64_t *slot_size = NULL;  // Tamaño actual y operaciones hechas por bloque
+    uint32_t *slot_seq = NULL;
+    size_t slot_cap = 0;
+    id_map_t ids = {0};
+    id_grow(&ids);
+    uint64_t live_now = 0;
+
+    char line[256];
+    size_t lineno = 0;
+    while (fgets(line, sizeof(line), f)) {
+        lineno++;
+        char *p = line;
+        while (*p == ' ' || *p == '\t') p++;
+        if (*p == '#' || *p == '\n' || *p == '\0') continue;
+        char op = *p++;
+        char *end;
+        uint64_t id = strtoull(p, &end, 0);
+        int ok = (op == 'a' || op == 'r' || op == 'f') && end != p;
+        uint64_t size = 0;
+        if (ok && op != 'f') {
+            p = end;
+            size = strtoull(p, &end, 10);
+            ok = end != p;
+            if (size == 0) size = 1;  // malloc(0) grabado: se pide el mínimo
+        }
+        p = end;
+        unsigned long thread = strtoul(p, &end, 10);
+        if (end == p) thread = 0;
+        if (!ok || thread >= MAX_THREADS) {
+            printf("Error: %s:%zu: linea invalida\n", path, lineno);
+            goto fail;
+        }
+
+        event_t ev = {.size = size, .thread = (uint16_t)thread, .op = op};
+        size_t i = id_find(&ids, id);
+        if (op == 'a') {
+            if (ids.used[i]) {
+                printf("Error: %s:%zu: el id %llu ya esta vivo\n", path, lineno, (unsigned long long)id);
+                goto fail;
+            }
+            if (t->slots == slot_cap) {
+                slot_cap = slot_cap ? slot_cap * 2 : 1 << 16;
+                slot_size = realloc(slot_size, slot_cap * sizeof(uint64_t));
+                slot_seq = realloc(slot_seq, slot_cap * sizeof(uint32_t));
+                if (!slot_size || !slot_seq) {
+                    printf("Error: sin memoria para leer la traza\n");
+                    goto fail;
+                }
+            }
+            ev.slot = t->slots++;
+            slot_size[ev.slot] = 0;
+            slot_seq[ev.slot] = 0;
+            ids.used[i] = 1;
+            ids.keys[i] = id;
+            ids.vals[i] = ev.slot;
+            if (++ids.count * 2 > ids.cap) id_grow(&ids);
+        } else {
+            if (!ids.used[i]) {
+                printf("Error: %s:%zu: el id %llu no esta vivo\n", path, lineno, (unsigned long long)id);
+                goto fail;
+            }
+            ev.slot = ids.vals[i];
+            if (op == 'f') id_remove(&ids, i);
+        }
+        ev.seq = slot_seq[ev.slot]++;
+        // Bytes vivos pedidos después de esta operación
+        live_now += ev.size;
+        live_now -= slot_size[ev.slot];
+        slot_size[ev.slot] = ev.size;
+        if (live_now > t->peak_live) t->peak_live = live_now;
+
+        if (t->count == cap) {
+            cap *= 2;
+            t->events = realloc(t->events, cap * sizeof(event_t));
+        }
+        if (!t->events) {
+            printf("Error: sin memoria para leer la traza\n");
+            goto fail;
+        }
+        t->events[t->count++] = ev;
+        if ((int)thread >= t->threads) t->threads = (int)thread + 1;
+    }
+    fclose(f);
+    if (t->count == 0) {
+        printf("Error: %s no tiene operaciones\n", path);
+        return 0;
+    }
+
+    // Segunda vuelta: índices por hilo y bytes vivos en cada muestra
+    t->step = t->count / SAMPLES ? t->count / SAMPLES : 1;
+    for (int h = 0; h < t->threads; h++) t->by_thread[h] = malloc(t->count * sizeof(uint32_t));
+    memset(slot_size, 0, t->slots * sizeof(uint64_t));
+    uint64_t live = 0;
+    for (size_t e = 0; e < t->count; e++) {
+        event_t *ev = &t->events[e];
+        t->by_thread[ev->thread][t->per_thread[ev->thread]++] = (uint32_t)e;
+        live += ev->size;
+        live -= slot_size[ev->slot];
+        slot_size[ev->slot] = ev->size;
+        if ((e + 1) % t->step == 0 && (e + 1) / t->step <= SAMPLES) t->live[(e + 1) / t->step - 1] = live;
+    }
+    free(slot_size);
+    free(slot_seq);
+    free(ids.keys);
+    free(ids.vals);
+    free(ids.used);
+    return 1;
+
+fail:
+    fclose(f);
+    return 0;
+}
+
+// --- Generador de trazas sintéticas ---
+// Cada hilo tiene un conjunto de bloques vivos que sube y baja por fases (así
+// se libera mucho y se vuelve a asignar sobre los huecos). La mayoría de los
+// bloques vive poco y se libera casi en orden inverso; unos pocos duran hasta
+// el final. Los tamaños son mayormente chicos, con algunos medianos y grandes.
+// Parte de las liberaciones las hace otro hilo y parte de las operaciones son
+// realloc que agrandan (como un vector) o achican.
+
+#define GEN_LIVE_MAX 4096
+
+typedef struct {
+    uint64_t id;
+    uint64_t size;
+} gen_block_t;
+
+static unsigned gen_rand(unsigned *s) {
+    *s = *s * 1103515245u + 12345u;
+    return *s >> 8;
+}
+
+static uint64_t gen_size(unsigned *s) {
+    unsigned r = gen_rand(s) % 100;
+    if (r < 60) return 8 + gen_rand(s) % 57;
+    if (r < 85) return 65 + gen_rand(s) % 448;
+    if (r < 97) return 513 + gen_rand(s) % 7680;
+    return 8193 + gen_rand(s) % (256 * 1024 - 8192);
+}
+
+static int generate(const char *path, long ops, int threads, unsigned seed) {
+    FILE *f = fopen(path, "w");
+    if (!f) {
+        printf("Error: no se pudo crear %s\n", path);
+        return 1;
+    }
+    gen_block_t (*live)[GEN_LIVE_MAX] = calloc(threads, sizeof(*live));
+    int *count = calloc(threads, sizeof(int));
+    size_t forever_max = (size_t)ops / 50 + 16;
+    gen_block_t *forever = malloc(forever_max * sizeof(gen_block_t));
+    int *forever_thread = malloc(forever_max * sizeof(int));
+    size_t forever_count = 0;
+    uint64_t next_id = 1;
+    unsigned s = seed;
+    long period = ops / 4 > 1 ? ops / 4 : 1;
+
+    fprintf(f, "# buddy_trace: %ld operaciones, %d hilos, semilla %u\n", ops, threads, seed);
+    for (long op = 0; op < ops; op++) {
+        int t = (int)(gen_rand(&s) % threads);
+        double pos = (double)(op % period) / period;
+        int target = 64 + (int)((GEN_LIVE_MAX - 64) * (pos < 0.5 ? 2 * pos : 2 * (1 - pos)));
+        int grow = count[t] < target ? gen_rand(&s) % 10 < 7 : gen_rand(&s) % 10 < 3;
+        unsigned r = gen_rand(&s) % 100;
+
+        if (count[t] == 0 || (grow && count[t] < GEN_LIVE_MAX)) {
+            gen_block_t b = {next_id++, gen_size(&s)};
+            fprintf(f, "a %llu %llu %d\n", (unsigned long long)b.id, (unsigned long long)b.size, t);
+            if (r < 2 && forever_count < forever_max) {
+                forever_thread[forever_count] = t;
+                forever[forever_count++] = b;
+            } else {
+                live[t][count[t]++] = b;
+            }
+        } else if (r < 5) {
+            // realloc del más reciente
+            gen_block_t *b = &live[t][count[t] - 1];
+            uint64_t size = gen_rand(&s) % 4 ? b->size + b->size / 2 + 1 : b->size / 2 + 1;
+            b->size = size < 4 * 1024 * 1024 ? size : b->size;
+            fprintf(f, "r %llu %llu %d\n", (unsigned long long)b->id, (unsigned long long)b->size, t);
+        } else {
+            // Casi siempre uno de los últimos; a veces uno de otro hilo
+            int owner = t;
+            if (r < 9 && threads > 1) owner = (int)(gen_rand(&s) % threads);
+            if (count[owner] == 0) owner = t;
+            int back = (int)(gen_rand(&s) % 100 < 80 ? gen_rand(&s) % 8 : gen_rand(&s) % count[owner]);
+            if (back >= count[owner]) back = count[owner] - 1;
+            int i = count[owner] - 1 - back;
+            fprintf(f, "f %llu %d\n", (unsigned long long)live[owner][i].id, t);
+            live[owner][i] = live[owner][--count[owner]];
+        }
+    }
+    // Al final se libera todo lo que quedó
+    for (int t = 0; t < threads; t++) {
+        while (count[t] > 0) fprintf(f, "f %llu %d\n", (unsigned long long)live[t][--count[t]].id, t);
+    }
+    for (size_t i = 0; i < forever_count; i++) {
+        fprintf(f, "f %llu %d\n", (unsigned long long)forever[i].id, forever_thread[i]);
+    }
+    int failed = ferror(f);
+    fclose(f);
+    free(live);
+    free(count);
+    free(forever);
+    free(forever_thread);
+    if (failed) {
+        printf("Error: no se pudo escribir %s\n", path);
+        return 1;
+    }
+    printf("Traza generada en %s: %ld operaciones, %d hilos\n", path, ops, threads);
+    return 0;
+}
+
+// --- Reproducción ---
+
+enum { USE_BUDDY, USE_SLABS, USE_MALLOC, ALLOCATORS };
+static const char *allocator_names[ALLOCATORS] = {"buddy", "buddy+slabs", "malloc"};
+
+typedef struct {
+    _Atomic uint32_t seq;    // Operaciones ya hechas sobre el bloque
+    unsigned char *ptr;
+    uint64_t size;
+} slot_t;
+
+typedef struct {
+    const trace_t *trace;
+    buddy_system_t *buddy;   // NULL = malloc/free
+    slot_t *slots;
+    int thread;
+    uint32_t *latency;       // NULL = no medir cada operación
+    uint64_t *footprint;     // NULL = no tomar muestras
+    long errors, failures;
+} replay_args_t;
+
+static double now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+// Memoria que el asignador tiene ocupada por bloques (lo entregado al
+// usuario más lo que redondeó, cachés y lugar libre dentro de los slabs)
+static uint64_t footprint(buddy_system_t *buddy) {
+    if (buddy) {
+        buddy_stats_t stats;
+        buddy_get_stats(buddy, &stats);
+        return stats.used_bytes + stats.cached_bytes + stats.slab_free_bytes;
+    }
+#if HAVE_MALLINFO2
+    struct mallinfo2 info = mallinfo2();
+    return info.uordblks + info.hblkhd;
+#else
+    return 0;
+#endif
+}
+
+// La primera y la última posición del bloque llevan una marca del bloque: si
+// cambia, alguien lo pisó
+static unsigned char tag(uint32_t slot) {
+    return (unsigned char)(slot * 131u + 7u);
+}
+
+static void mark(slot_t *s, uint32_t slot) {
+    s->ptr[0] = tag(slot);
+    s->ptr[s->size - 1] = tag(slot);
+}
+
+static int marked(const slot_t *s, uint32_t slot) {
+    return s->ptr[0] == tag(slot) && s->ptr[s->size - 1] == tag(slot);
+}
+
+static void* replay_thread(void *arg) {
+    replay_args_t *w = arg;
+    const trace_t *t = w->trace;
+    const uint32_t *mine = t->by_thread[w->thread];
+    for (size_t n = 0; n < t->per_thread[w->thread]; n++) {
+        size_t e = mine[n];
+        const event_t *ev = &t->events[e];
+        slot_t *s = &w->slots[ev->slot];
+        // Si el bloque viene de otro hilo, esperar a que le toque
+        for (int spin = 0; atomic_load_explicit(&s->seq, memory_order_acquire) != ev->seq; spin++) {
+            if (spin > 64) sched_yield();
+        }
+
+        uint64_t size = ev->size;
+        int failed = 0;
+        if (ev->op != 'a' && s->ptr && !marked(s, ev->slot)) w->errors++;
+        uint64_t start = w->latency ? now_ns() : 0;
+        if (ev->op == 'a') {
+            s->ptr = w->buddy ? buddy_alloc(w->buddy, size) : malloc(size);
+            failed = !s->ptr;
+        } else if (ev->op == 'r') {
+            void *p = w->buddy ? buddy_realloc(w->buddy, s->ptr, size) : realloc(s->ptr, size);
+            // Si realloc falla el bloque viejo sigue siendo válido
+            failed = !p;
+            if (p) s->ptr = p;
+            else size = s->size;
+        } else {
+            if (w->buddy) buddy_free(w->buddy, s->ptr);
+            else free(s->ptr);
+            s->ptr = NULL;
+        }
+        if (w->latency) {
+            uint64_t ns = now_ns() - start;
+            w->latency[n] = ns < UINT32_MAX ? (uint32_t)ns : UINT32_MAX;
+        }
+
+        if (ev->op != 'f' && s->ptr) {
+            s->size = size;
+            mark(s, ev->slot);
+        }
+        w->failures += failed;
+        atomic_store_explicit(&s->seq, ev->seq + 1, memory_order_release);
+
+        if (w->footprint && (e + 1) % t->step == 0 && (e + 1) / t->step <= SAMPLES) {
+            w->footprint[(e + 1) / t->step - 1] = footprint(w->buddy);
+        }
+    }
+    return NULL;
+}
+
+typedef struct {
+    int ok;
+    double mops;
+    double seconds;
+    uint64_t p50, p99, p999, max;    // ns
+    uint64_t rss_peak;               // Bytes por encima de lo que había al empezar
+    uint64_t footprint[SAMPLES];
+    long errors, failures;
+} result_t;
+
+static buddy_system_t* make_buddy(const trace_t *t, int slabs) {
+    // Espacio de sobra para el pico (redondeos y huecos incluidos); solo
+    // ocupa memoria real lo que se usa
+    size_t reserve = (size_t)1 << 30;
+    while (reserve < 8 * t->peak_live) reserve <<= 1;
+    buddy_config_t config = {.reserve_size = reserve, .chunk_size = CHUNK_SIZE,
+                             .concurrent = t->threads > 1, .slabs = slabs};
+    return buddy_init_ex(&config);
+}
+
+// Reproduce la traza entera; al final libera lo que haya quedado vivo
+static double replay(const trace_t *t, buddy_system_t *buddy, uint32_t **latency,
+                     uint64_t *footprint_out, result_t *res) {
+    slot_t *slots = calloc(t->slots, sizeof(slot_t));
+    pthread_t tids[MAX_THREADS];
+    replay_args_t args[MAX_THREADS];
+    if (!slots) {
+        printf("Error: sin memoria para reproducir la traza\n");
+        exit(1);
+    }
+    double start = now();
+    for (int h = 0; h < t->threads; h++) {
+        args[h] = (replay_args_t){t, buddy, slots, h, latency ? latency[h] : NULL, footprint_out, 0, 0};
+        pthread_create(&tids[h], NULL, replay_thread, &args[h]);
+    }
+    for (int h = 0; h < t->threads; h++) {
+        pthread_join(tids[h], NULL);
+        res->errors += args[h].errors;
+        res->failures += args[h].failures;
+    }
+    double elapsed = now() - start;
+    for (uint32_t i = 0; i < t->slots; i++) {
+        if (!slots[i].ptr) continue;
+        if (buddy) buddy_free(buddy, slots[i].ptr);
+        else free(slots[i].ptr);
+    }
+    if (buddy) buddy_thread_flush(buddy);
+    free(slots);
+    return elapsed;
+}
+
+static uint64_t resident_bytes(void) {
+    FILE *f = fopen("/proc/self/statm", "r");
+    unsigned long size = 0, resident = 0;
+    if (f) {
+        if (fscanf(f, "%lu %lu", &size, &resident) != 2) resident = 0;
+        fclose(f);
+    }
+    return (uint64_t)resident * (uint64_t)sysconf(_SC_PAGESIZE);
+}
+
+static int compare_u32(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t*)a, y = *(const uint32_t*)b;
+    return (x > y) - (x < y);
+}
+
+static void run_allocator(const trace_t *t, int which, result_t *res) {
+    memset(res, 0, sizeof(*res));
+    uint64_t baseline = resident_bytes();
+
+    // Pasada 1: throughput, RSS pico y fragmentación
+    buddy_system_t *buddy = which == USE_MALLOC ? NULL : make_buddy(t, which == USE_SLABS);
+    if (which != USE_MALLOC && !buddy) return;
+    res->seconds = replay(t, buddy, NULL, res->footprint, res);
+    res->mops = t->count / res->seconds / 1e6;
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    uint64_t peak = (uint64_t)usage.ru_maxrss * 1024;
+    res->rss_peak = peak > baseline ? peak - baseline : 0;
+    if (buddy) {
+        buddy_stats_t stats;
+        buddy_get_stats(buddy, &stats);
+        if (stats.used_bytes != 0 || stats.allocs != stats.frees || stats.bad_frees) res->errors++;
+        buddy_destroy(buddy);
+    }
+
+    // Pasada 2: latencia de cada llamada, sobre un asignador nuevo
+    buddy = which == USE_MALLOC ? NULL : make_buddy(t, which == USE_SLABS);
+    if (which != USE_MALLOC && !buddy) return;
+    uint32_t *latency[MAX_THREADS];
+    uint32_t *all = malloc(t->count * sizeof(uint32_t));
+    size_t offset = 0;
+    for (int h = 0; h < t->threads; h++) {
+        latency[h] = all + offset;
+        offset += t->per_thread[h];
+    }
+    result_t timed = {0};
+    replay(t, buddy, latency, NULL, &timed);
+    if (buddy) buddy_destroy(buddy);
+    res->errors += timed.errors;
+    qsort(all, t->count, sizeof(uint32_t), compare_u32);
+    res->p50 = all[(t->count - 1) / 2];
+    res->p99 = all[(size_t)((t->count - 1) * 0.99)];
+    res->p999 = all[(size_t)((t->count - 1) * 0.999)];
+    res->max = all[t->count - 1];
+    free(all);
+    res->ok = 1;
+}
+
+// Corre el asignador en un proceso hijo y trae el resultado por un pipe
+static int run_isolated(const trace_t *t, int which, result_t *res) {
+    int fds[2];
+    if (pipe(fds) != 0) return 0;
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid < 0) return 0;
+    if (pid == 0) {
+        close(fds[0]);
+        run_allocator(t, which, res);
+        ssize_t written = write(fds[1], res, sizeof(*res));
+        _exit(written == (ssize_t)sizeof(*res) ? 0 : 1);
+    }
+    close(fds[1]);
+    ssize_t got = read(fds[0], res, sizeof(*res));
+    close(fds[0]);
+    int status;
+    waitpid(pid, &status, 0);
+    return got == (ssize_t)sizeof(*res) && WIFEXITED(status) && WEXITSTATUS(status) == 0 && res->ok;
+}
+
+static double mib(uint64_t bytes) {
+    return bytes / (1024.0 * 1024.0);
+}
+
+static int replay_file(const char *path) {
+    trace_t t;
+    if (!load_trace(path, &t)) return 1;
+    printf("=== Reproduccion de %s ===\n", path);
+    printf("%zu operaciones, %d hilos, %u bloques, pico vivo %.2f MiB\n\n", t.count, t.threads, t.slots,
+           mib(t.peak_live));
+    printf("%-12s %9s %9s %9s %9s %11s %13s %7s\n", "asignador", "Mops/s", "p50 ns", "p99 ns", "p99.9 ns",
+           "max us", "RSS pico MiB", "fallos");
+
+    result_t res[ALLOCATORS];
+    int ok[ALLOCATORS];
+    long errors = 0;
+    for (int a = 0; a < ALLOCATORS; a++) {
+        ok[a] = run_isolated(&t, a, &res[a]);
+        if (!ok[a]) {
+            printf("%-12s fallo (el proceso no termino bien)\n", allocator_names[a]);
+            errors++;
+            continue;
+        }
+        errors += res[a].errors;
+        printf("%-12s %9.2f %9llu %9llu %9llu %11.1f %13.2f %7ld\n", allocator_names[a], res[a].mops,
+               (unsigned long long)res[a].p50, (unsigned long long)res[a].p99,
+               (unsigned long long)res[a].p999, res[a].max / 1000.0, mib(res[a].rss_peak), res[a].failures);
+    }
+
+    // Fragmentación: qué parte de lo que cada asignador tiene ocupado no es
+    // lo que se pidió
+    printf("\nFragmentacion en el tiempo (1 - vivo / ocupado):\n");
+    printf("%6s %10s", "op %", "vivo MiB");
+    for (int a = 0; a < ALLOCATORS; a++) printf(" %12s", allocator_names[a]);
+    printf("\n");
+    size_t samples = t.count / t.step < SAMPLES ? t.count / t.step : SAMPLES;
+    for (size_t i = 0; i < samples; i++) {
+        printf("%5.0f%% %10.2f", 100.0 * (i + 1) * t.step / t.count, mib(t.live[i]));
+        for (int a = 0; a < ALLOCATORS; a++) {
+            uint64_t used = ok[a] ? res[a].footprint[i] : 0;
+            // Con casi nada vivo el porcentaje no dice nada
+            if (used == 0 || used < t.live[i] || t.live[i] * 100 < t.peak_live) printf(" %12s", "-");
+            else printf(" %11.1f%%", 100.0 * (1.0 - (double)t.live[i] / used));
+        }
+        printf("\n");
+    }
+
+    for (int h = 0; h < t.threads; h++) free(t.by_thread[h]);
+    free(t.events);
+    if (errors) {
+        printf("\nFALLO: %ld errores (bloques pisados o contadores que no cuadran)\n", errors);
+        return 1;
+    }
+    printf("\nSin errores\n");
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    if (argc >= 3 && strcmp(argv[1], "generar") == 0) {
+        long ops = argc > 3 ? atol(argv[3]) : 1000000;
+        int threads = argc > 4 ? atoi(argv[4]) : 1;
+        unsigned seed = argc > 5 ? (unsigned)strtoul(argv[5], NULL, 10) : 12345u;
+        if (ops <= 0 || threads < 1 || threads > MAX_THREADS) {
+            printf("Error: operaciones > 0 y entre 1 y %d hilos\n", MAX_THREADS);
+            return 1;
+        }
+        return generate(argv[2], ops, threads, seed);
+    }
+    if (argc != 2) {
+        printf("Uso: %s generar <archivo> [operaciones] [hilos] [semilla]\n", argv[0]);
+        printf("     %s <archivo>\n", argv[0]);
+        return 1;
+    }
+    return replay_file(argv[1]);
+}
@@ -2,23 +2,81 @@
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
-
-#define MAX_ENTITIES 100
-#define MAX_NAME_LEN 50
-#define MAX_LANG_LEN 20
+#include <time.h>
 
 typedef enum { PROG, INTERP, TRANS } EntityType;
 
+// Las entidades no guardan texto: cada nombre (de programa o de lenguaje) se
+// guarda una sola vez en el registro y se usa por su id
 typedef struct {
     EntityType type;
-    char name[MAX_NAME_LEN];
-    char lang1[MAX_LANG_LEN];
-    char lang2[MAX_LANG_LEN];
-    char lang3[MAX_LANG_LEN];
+    int name;   // Programa: su nombre
+    int lang1;  // Programa: su lenguaje. Interprete y traductor: lenguaje base
+    int lang2;  // Interprete: lenguaje que ejecuta. Traductor: lenguaje origen
+    int lang3;  // Traductor: lenguaje destino
+    int cost;   // Interprete y traductor: costo de usarlo en una RUTA (1 por defecto)
 } Entity;
 
-Entity entities[MAX_ENTITIES];
-int entity_count = 0;
+// Indice hash (direccionamiento abierto) de una clave de hasta 3 ids a la
+// posicion de la entidad. Las claves que usan menos ids ponen -1 en el resto.
+typedef struct {
+    int a, b, c;
+    int value;  // -1 = lugar vacio
+} IndexSlot;
+
+typedef struct {
+    IndexSlot *slots;
+    int capacity;  // Potencia de 2 (0 = todavia vacio)
+    int count;
+} Index;
+
+// Arista del grafo de lenguajes y la entidad que la puso
+typedef struct {
+    int to;
+    int via;
+} Edge;
+
+// Aristas que salen de un lenguaje
+typedef struct {
+    Edge *list;
+    int count, capacity;
+} Edges;
+
+// Caminos minimos desde LOCAL a cada lenguaje (para RUTA): dist es -1 si no
+// se llega y via es la entidad de la ultima arista del camino
+typedef struct {
+    long long *dist;
+    int *via;
+    int valido;   // 0 = hay que recalcularlo
+} RouteTree;
+
+// Todo el estado: nombres internados, entidades e indices. En cero es un
+// registro vacio valido; todo crece a medida que hace falta.
+typedef struct {
+    char **names;
+    int name_count, name_capacity;
+    int *name_slots;  // Tabla hash de ids de nombres (-1 = vacio)
+    int name_slot_capacity;
+
+    // Grafo de lenguajes: hay una arista A -> B si que A se pueda ejecutar
+    // hace que B tambien (interprete de B escrito en A, o traductor de B a
+    // A). runs es el conjunto (un bit por id) de lenguajes que se pueden
+    // ejecutar en LOCAL y se mantiene al dia con cada definicion. Todo va
+    // por id de nombre (name_capacity, que siempre es multiplo de 64).
+    Edges *edges;
+    unsigned long long *runs;
+    int *pending;  // Cola del BFS que propaga runs
+    RouteTree rutas[2];  // Por saltos y por costo; se calculan en la primera RUTA
+
+    Entity *entities;
+    int entity_count, entity_capacity;
+
+    Index programs;      // nombre
+    Index interpreters;  // (base, ejecuta)
+    Index translators;   // (base, origen, destino)
+} Registry;
+
+Registry registry;
 
 // Variables para tracking de cobertura
 int tests_passed = 0;
@@ -33,33 +91,263 @@ void to_uppercase(char *str) {
     }
 }
 
-int find_program(const char *name) {
-    functions_called[5]++;
-    for (int i = 0; i < entity_count; i++) {
-        if (entities[i].type == PROG && strcmp(entities[i].name, name) == 0) {
-            return i;
+// --- Conjunto de lenguajes ejecutables ---
+
+static int test_runs(int lang) {
+    return (registry.runs[lang / 64] >> (lang % 64)) & 1;
+}
+
+static void set_runs(int lang) {
+    registry.runs[lang / 64] |= 1ULL << (lang % 64);
+}
+
+// --- Nombres internados ---
+
+// FNV-1a
+static unsigned int hash_string(const char *s) {
+    unsigned int h = 2166136261u;
+    for (; *s; s++) {
+        h ^= (unsigned char)*s;
+        h *= 16777619u;
+    }
+    return h;
+}
+
+static unsigned int hash_ids(int a, int b, int c) {
+    unsigned int h = (unsigned int)a * 2654435761u;
+    h ^= (unsigned int)b * 2246822519u + (h << 6) + (h >> 2);
+    h ^= (unsigned int)c * 3266489917u + (h << 6) + (h >> 2);
+    return h;
+}
+
+// Lugar de name en la tabla: su id o el lugar vacio donde iria
+static int *name_slot(const char *name) {
+    int mask = registry.name_slot_capacity - 1;
+    for (unsigned int i = hash_string(name) & mask;; i = (i + 1) & mask) {
+        int *slot = &registry.name_slots[i];
+        if (*slot == -1 || strcmp(registry.names[*slot], name) == 0) return slot;
+    }
+}
+
+// Id de name si ya existe, -1 si no
+int lookup_name(const char *name) {
+    if (registry.name_slot_capacity == 0) return -1;
+    return *name_slot(name);
+}
+
+// Id de name, agregandolo si es nuevo (-1 si no hay memoria)
+int intern(const char *name) {
+    int id = lookup_name(name);
+    if (id != -1) return id;
+
+    if (registry.name_count == registry.name_capacity) {
+        int capacity = registry.name_capacity ? registry.name_capacity * 2 : 64;
+        char **names = realloc(registry.names, capacity * sizeof(char*));
+        if (!names) return -1;
+        registry.names = names;
+        Edges *edges = realloc(registry.edges, capacity * sizeof(Edges));
+        if (!edges) return -1;
+        registry.edges = edges;
+        unsigned long long *runs = realloc(registry.runs, capacity / 8);
+        if (!runs) return -1;
+        registry.runs = runs;
+        int *pending = realloc(registry.pending, capacity * sizeof(int));
+        if (!pending) return -1;
+        registry.pending = pending;
+        int old = registry.name_capacity;
+        memset(edges + old, 0, (capacity - old) * sizeof(Edges));
+        memset(runs + old / 64, 0, (capacity - old) / 8);
+        registry.name_capacity = capacity;
+    }
+    // La tabla se mantiene a lo sumo a la mitad
+    if (2 * (registry.name_count + 1) > registry.name_slot_capacity) {
+        int capacity = registry.name_slot_capacity ? registry.name_slot_capacity * 2 : 128;
+        int *slots = malloc(capacity * sizeof(int));
+        if (!slots) return -1;
+        memset(slots, -1, capacity * sizeof(int));
+        free(registry.name_slots);
+        registry.name_slots = slots;
+        registry.name_slot_capacity = capacity;
+        for (int i = 0; i < registry.name_count; i++) {
+            *name_slot(registry.names[i]) = i;
         }
     }
-    return -1;
+
+    char *copy = malloc(strlen(name) + 1);
+    if (!copy) return -1;
+    strcpy(copy, name);
+    id = registry.name_count++;
+    registry.names[id] = copy;
+    *name_slot(name) = id;
+    if (strcmp(name, "LOCAL") == 0) set_runs(id);
+    return id;
 }
 
-int entity_exists(EntityType type, const char *arg1, const char *arg2, const char *arg3) {
-    functions_called[6]++;
-    for (int i = 0; i < entity_count; i++) {
-        if (entities[i].type == type) {
-            if (type == PROG) {
-                if (strcmp(entities[i].name, arg1) == 0) return 1;
-            } else if (type == INTERP) {
-                if (strcmp(entities[i].lang1, arg1) == 0 && 
-                    strcmp(entities[i].lang2, arg2) == 0) return 1;
-            } else if (type == TRANS) {
-                if (strcmp(entities[i].lang1, arg1) == 0 && 
-                    strcmp(entities[i].lang2, arg2) == 0 && 
-                    strcmp(entities[i].lang3, arg3) == 0) return 1;
+const char *name_of(int id) {
+    return registry.names[id];
+}
+
+// --- Indices ---
+
+static IndexSlot *index_slot(Index *index, int a, int b, int c) {
+    int mask = index->capacity - 1;
+    for (unsigned int i = hash_ids(a, b, c) & mask;; i = (i + 1) & mask) {
+        IndexSlot *slot = &index->slots[i];
+        if (slot->value == -1 || (slot->a == a && slot->b == b && slot->c == c)) return slot;
+    }
+}
+
+// Entidad con esa clave, -1 si no hay
+int index_find(Index *index, int a, int b, int c) {
+    if (index->capacity == 0) return -1;
+    return index_slot(index, a, b, c)->value;
+}
+
+// Agrega la clave (que no debe estar). Devuelve 0 si no hay memoria.
+int index_insert(Index *index, int a, int b, int c, int value) {
+    if (2 * (index->count + 1) > index->capacity) {
+        int capacity = index->capacity ? index->capacity * 2 : 64;
+        IndexSlot *slots = malloc(capacity * sizeof(IndexSlot));
+        if (!slots) return 0;
+        for (int i = 0; i < capacity; i++) slots[i].value = -1;
+        Index grown = { slots, capacity, index->count };
+        for (int i = 0; i < index->capacity; i++) {
+            IndexSlot *old = &index->slots[i];
+            if (old->value != -1) *index_slot(&grown, old->a, old->b, old->c) = *old;
+        }
+        free(index->slots);
+        *index = grown;
+    }
+    IndexSlot *slot = index_slot(index, a, b, c);
+    slot->a = a;
+    slot->b = b;
+    slot->c = c;
+    slot->value = value;
+    index->count++;
+    return 1;
+}
+
+// --- Grafo de lenguajes ---
+
+// Deja lugar para una arista mas que sale de from. Devuelve 0 si no hay memoria.
+static int reserve_edge(int from) {
+    Edges *e = &registry.edges[from];
+    if (e->count < e->capacity) return 1;
+    int capacity = e->capacity ? e->capacity * 2 : 4;
+    Edge *list = realloc(e->list, capacity * sizeof(Edge));
+    if (!list) return 0;
+    e->list = list;
+    e->capacity = capacity;
+    return 1;
+}
+
+// Agrega from -> to (con lugar ya reservado). Si from se puede ejecutar y to
+// todavia no, un BFS desde to marca todo lo que pasa a poder. runs hace de
+// visitados y de memo a la vez: cada lenguaje entra a la cola una sola vez en
+// toda la vida del registro (los ciclos se cortan solos), asi que todas las
+// definiciones juntas cuestan O(lenguajes + aristas), sin importar el largo
+// de las cadenas.
+static void add_edge(int from, int to, int via) {
+    Edges *e = &registry.edges[from];
+    e->list[e->count].to = to;
+    e->list[e->count++].via = via;
+    if (!test_runs(from) || test_runs(to)) return;
+
+    int head = 0, tail = 0;
+    set_runs(to);
+    registry.pending[tail++] = to;
+    while (head < tail) {
+        Edges *next = &registry.edges[registry.pending[head++]];
+        for (int i = 0; i < next->count; i++) {
+            int lang = next->list[i].to;
+            if (!test_runs(lang)) {
+                set_runs(lang);
+                registry.pending[tail++] = lang;
             }
         }
     }
-    return 0;
+}
+
+// --- Registro ---
+
+// Lugar para una entidad nueva (NULL si no hay memoria)
+Entity *new_entity(void) {
+    if (registry.entity_count == registry.entity_capacity) {
+        int capacity = registry.entity_capacity ? registry.entity_capacity * 2 : 64;
+        Entity *entities = realloc(registry.entities, capacity * sizeof(Entity));
+        if (!entities) return NULL;
+        registry.entities = entities;
+        registry.entity_capacity = capacity;
+    }
+    return &registry.entities[registry.entity_count];
+}
+
+// Libera todo y deja el registro vacio
+void registry_free(void) {
+    for (int i = 0; i < registry.name_count; i++) {
+        free(registry.names[i]);
+        free(registry.edges[i].list);
+    }
+    free(registry.names);
+    free(registry.edges);
+    free(registry.runs);
+    free(registry.pending);
+    for (int i = 0; i < 2; i++) {
+        free(registry.rutas[i].dist);
+        free(registry.rutas[i].via);
+    }
+    free(registry.name_slots);
+    free(registry.entities);
+    free(registry.programs.slots);
+    free(registry.interpreters.slots);
+    free(registry.translators.slots);
+    memset(&registry, 0, sizeof(registry));
+}
+
+int find_program(const char *name) {
+    functions_called[5]++;
+    int id = lookup_name(name);
+    return id == -1 ? -1 : index_find(&registry.programs, id, -1, -1);
+}
+
+int entity_exists(EntityType type, const char *arg1, const char *arg2, const char *arg3) {
+    functions_called[6]++;
+    // Un nombre que nunca se vio no puede ser parte de una entidad
+    int a = lookup_name(arg1);
+    int b = arg2 ? lookup_name(arg2) : -1;
+    int c = arg3 ? lookup_name(arg3) : -1;
+    if (a == -1 || (arg2 && b == -1) || (arg3 && c == -1)) return 0;
+
+    if (type == PROG) return index_find(&registry.programs, a, -1, -1) != -1;
+    if (type == INTERP) return index_find(&registry.interpreters, a, b, -1) != -1;
+    return index_find(&registry.translators, a, b, c) != -1;
+}
+
+// Agrega la entidad al registro y a su indice. Devuelve 0 si no hay memoria.
+static int add_entity(EntityType type, int name, int lang1, int lang2, int lang3, int cost) {
+    Entity *e = new_entity();
+    if (!e || name == -1 || lang1 == -1 || lang2 == -1 || lang3 == -1) return 0;
+    // Arista del grafo: el interprete va de su base a lo que ejecuta y el
+    // traductor del destino al origen
+    int from = type == INTERP ? lang1 : lang3;
+    if (type != PROG && !reserve_edge(from)) return 0;
+    int ok;
+    if (type == PROG) ok = index_insert(&registry.programs, name, -1, -1, registry.entity_count);
+    else if (type == INTERP) ok = index_insert(&registry.interpreters, lang1, lang2, -1, registry.entity_count);
+    else ok = index_insert(&registry.translators, lang1, lang2, lang3, registry.entity_count);
+    if (!ok) return 0;
+    if (type != PROG) {
+        add_edge(from, lang2, registry.entity_count);
+        registry.rutas[0].valido = registry.rutas[1].valido = 0;
+    }
+    e->type = type;
+    e->name = name;
+    e->lang1 = lang1;
+    e->lang2 = lang2;
+    e->lang3 = lang3;
+    e->cost = cost;
+    registry.entity_count++;
+    return 1;
 }
 
 void definir_programa(const char *nombre, const char *lenguaje) {
@@ -69,148 +357,311 @@ void definir_programa(const char *nombre, const char *lenguaje) {
         return;
     }
     
-    if (entity_count >= MAX_ENTITIES) {
+    if (!add_entity(PROG, intern(nombre), intern(lenguaje), 0, 0, 0)) {
         printf("ERROR: No se pueden definir mas entidades\n");
         return;
     }
-    
-    Entity *e = &entities[entity_count++];
-    e->type = PROG;
-    strcpy(e->name, nombre);
-    strcpy(e->lang1, lenguaje);
     printf("Programa '%s' en lenguaje '%s' definido\n", nombre, lenguaje);
 }
 
-void definir_interprete(const char *lang_base, const char *lang_ejecuta) {
+// Mensaje de una definicion: el costo solo se muestra si no es el de por defecto
+static void imprimir_costo(int costo) {
+    if (costo != 1) printf(" (costo %d)", costo);
+    printf("\n");
+}
+
+void definir_interprete_con_costo(const char *lang_base, const char *lang_ejecuta, int costo) {
     functions_called[1]++;
     if (entity_exists(INTERP, lang_base, lang_ejecuta, NULL)) {
         printf("ERROR: Interprete '%s'->'%s' ya existe\n", lang_base, lang_ejecuta);
         return;
     }
     
-    if (entity_count >= MAX_ENTITIES) {
+    if (!add_entity(INTERP, 0, intern(lang_base), intern(lang_ejecuta), 0, costo)) {
         printf("ERROR: No se pueden definir mas entidades\n");
         return;
     }
-    
-    Entity *e = &entities[entity_count++];
-    e->type = INTERP;
-    strcpy(e->lang1, lang_base);
-    strcpy(e->lang2, lang_ejecuta);
-    printf("Interprete '%s'->'%s' definido\n", lang_base, lang_ejecuta);
+    printf("Interprete '%s'->'%s' definido", lang_base, lang_ejecuta);
+    imprimir_costo(costo);
 }
 
-void definir_traductor(const char *lang_base, const char *lang_origen, const char *lang_destino) {
+void definir_interprete(const char *lang_base, const char *lang_ejecuta) {
+    definir_interprete_con_costo(lang_base, lang_ejecuta, 1);
+}
+
+void definir_traductor_con_costo(const char *lang_base, const char *lang_origen, const char *lang_destino,
+                                 int costo) {
     functions_called[2]++;
     if (entity_exists(TRANS, lang_base, lang_origen, lang_destino)) {
         printf("ERROR: Traductor '%s':'%s'->'%s' ya existe\n", lang_base, lang_origen, lang_destino);
         return;
     }
     
-    if (entity_count >= MAX_ENTITIES) {
+    if (!add_entity(TRANS, 0, intern(lang_base), intern(lang_origen), intern(lang_destino), costo)) {
         printf("ERROR: No se pueden definir mas entidades\n");
         return;
     }
-    
-    Entity *e = &entities[entity_count++];
-    e->type = TRANS;
-    strcpy(e->lang1, lang_base);
-    strcpy(e->lang2, lang_origen);
-    strcpy(e->lang3, lang_destino);
-    printf("Traductor '%s':'%s'->'%s' definido\n", lang_base, lang_origen, lang_destino);
+    printf("Traductor '%s':'%s'->'%s' definido", lang_base, lang_origen, lang_destino);
+    imprimir_costo(costo);
+}
+
+void definir_traductor(const char *lang_base, const char *lang_origen, const char *lang_destino) {
+    definir_traductor_con_costo(lang_base, lang_origen, lang_destino, 1);
 }
 
-int puede_ejecutarse(const char *lang_actual, int depth, int *visited) {
+// Un lenguaje se puede ejecutar si es LOCAL, si hay un interprete para el
+// escrito en un lenguaje que se puede ejecutar o si hay un traductor de el a
+// uno que se puede ejecutar. El registro ya lo tiene calculado.
+int puede_ejecutarse(int lang) {
     functions_called[4]++;
-    if (depth > 10) return 0;
-    
-    if (strcmp(lang_actual, "LOCAL") == 0) return 1;
-    
-    for (int i = 0; i < depth; i++) {
-        if (visited[i] == (int)lang_actual[0]) return 0;
+    return test_runs(lang);
+}
+
+// Devuelve 1 si el programa se puede ejecutar, 0 si no y -1 si no existe
+int ejecutable(const char *nombre) {
+    functions_called[3]++;
+    int idx = find_program(nombre);
+    if (idx == -1) {
+        printf("ERROR: Programa '%s' no encontrado\n", nombre);
+        return -1;
     }
-    visited[depth] = (int)lang_actual[0];
     
-    for (int i = 0; i < entity_count; i++) {
-        if (entities[i].type == INTERP && 
-            strcmp(entities[i].lang2, lang_actual) == 0) {
-            if (puede_ejecutarse(entities[i].lang1, depth + 1, visited)) {
-                return 1;
-            }
-        }
+    if (puede_ejecutarse(registry.entities[idx].lang1)) {
+        printf("SI: '%s' puede ejecutarse\n", nombre);
+        return 1;
     }
-    
-    for (int i = 0; i < entity_count; i++) {
-        if (entities[i].type == TRANS && 
-            strcmp(entities[i].lang2, lang_actual) == 0) {
-            if (puede_ejecutarse(entities[i].lang3, depth + 1, visited)) {
-                return 1;
+    printf("NO: '%s' NO puede ejecutarse\n", nombre);
+    return 0;
+}
+
+// --- Rutas ---
+
+typedef struct {
+    long long dist;
+    int lang;
+} HeapItem;
+
+// Min-heap binario por dist. Devuelve 0 si no hay memoria.
+static int heap_push(HeapItem **heap, int *n, int *capacity, long long dist, int lang) {
+    if (*n == *capacity) {
+        int mas = *capacity ? *capacity * 2 : 64;
+        HeapItem *h = realloc(*heap, mas * sizeof(HeapItem));
+        if (!h) return 0;
+        *heap = h;
+        *capacity = mas;
+    }
+    HeapItem *h = *heap;
+    int i = (*n)++;
+    while (i > 0 && h[(i - 1) / 2].dist > dist) {
+        h[i] = h[(i - 1) / 2];
+        i = (i - 1) / 2;
+    }
+    h[i].dist = dist;
+    h[i].lang = lang;
+    return 1;
+}
+
+static HeapItem heap_pop(HeapItem *h, int *n) {
+    HeapItem top = h[0], last = h[--(*n)];
+    int i = 0;
+    for (;;) {
+        int hijo = 2 * i + 1;
+        if (hijo >= *n) break;
+        if (hijo + 1 < *n && h[hijo + 1].dist < h[hijo].dist) hijo++;
+        if (h[hijo].dist >= last.dist) break;
+        h[i] = h[hijo];
+        i = hijo;
+    }
+    if (*n > 0) h[i] = last;
+    return top;
+}
+
+// Lenguaje desde el que se llega a otro por la arista de la entidad
+static int lenguaje_anterior(const Entity *e) {
+    return e->type == INTERP ? e->lang1 : e->lang3;
+}
+
+// Calcula (si hace falta) el arbol de caminos minimos desde LOCAL: por_costo
+// = 0 cuenta pasos, por_costo = 1 suma costos. Es un Dijkstra por las mismas
+// aristas que usa runs, O((lenguajes + aristas) log lenguajes), y sirve para
+// todas las RUTA hasta la proxima definicion de interprete o traductor.
+// Devuelve NULL si no hay memoria.
+static RouteTree *arbol_rutas(int por_costo) {
+    RouteTree *t = &registry.rutas[por_costo];
+    if (t->valido) return t;
+    int n = registry.name_count;
+    long long *dist = realloc(t->dist, n * sizeof(long long));
+    if (dist) t->dist = dist;
+    int *via = realloc(t->via, n * sizeof(int));
+    if (via) t->via = via;
+    if (!dist || !via) return NULL;
+    for (int i = 0; i < n; i++) dist[i] = -1;
+
+    int local = lookup_name("LOCAL");
+    HeapItem *heap = NULL;
+    int heap_n = 0, heap_capacity = 0;
+    int ok = 1;
+    if (local != -1) {
+        dist[local] = 0;
+        via[local] = -1;
+        ok = heap_push(&heap, &heap_n, &heap_capacity, 0, local);
+    }
+    while (ok && heap_n > 0) {
+        HeapItem item = heap_pop(heap, &heap_n);
+        if (item.dist != dist[item.lang]) continue;  // Ya se llego mas barato
+        Edges *e = &registry.edges[item.lang];
+        for (int i = 0; i < e->count && ok; i++) {
+            Edge *arista = &e->list[i];
+            long long d = item.dist + (por_costo ? registry.entities[arista->via].cost : 1);
+            if (dist[arista->to] == -1 || d < dist[arista->to]) {
+                dist[arista->to] = d;
+                via[arista->to] = arista->via;
+                ok = heap_push(&heap, &heap_n, &heap_capacity, d, arista->to);
             }
         }
     }
-    
-    return 0;
+    free(heap);
+    t->valido = ok;
+    return ok ? t : NULL;
 }
 
-void ejecutable(const char *nombre) {
-    functions_called[3]++;
+// Muestra la cadena de interpretes y traductores mas corta (por_costo = 0:
+// menos pasos) o mas barata (por_costo = 1: menor suma de costos) con la que
+// se ejecuta el programa, siguiendo el arbol de caminos desde su lenguaje
+// hasta LOCAL. Devuelve la cantidad de pasos, o -1 si el programa no existe
+// o no se puede ejecutar.
+int ruta(const char *nombre, int por_costo) {
     int idx = find_program(nombre);
     if (idx == -1) {
         printf("ERROR: Programa '%s' no encontrado\n", nombre);
-        return;
+        return -1;
+    }
+    int destino = registry.entities[idx].lang1;
+    if (!puede_ejecutarse(destino)) {
+        printf("NO: '%s' NO puede ejecutarse\n", nombre);
+        return -1;
+    }
+    RouteTree *t = arbol_rutas(por_costo);
+    if (!t) {
+        printf("ERROR: Sin memoria\n");
+        return -1;
     }
     
-    char lenguaje[MAX_LANG_LEN];
-    strcpy(lenguaje, entities[idx].lang1);
+    int pasos = 0;
+    long long costo = 0;
+    for (int lang = destino; t->via[lang] != -1; lang = lenguaje_anterior(&registry.entities[t->via[lang]])) {
+        pasos++;
+        costo += registry.entities[t->via[lang]].cost;
+    }
+    printf("RUTA '%s' (%d pasos, costo %lld): %s", nombre, pasos, costo, name_of(destino));
+    for (int lang = destino; t->via[lang] != -1;) {
+        lang = lenguaje_anterior(&registry.entities[t->via[lang]]);
+        printf(" -> %s", name_of(lang));
+    }
+    printf("\n");
     
-    int visited[11] = {0};
-    if (puede_ejecutarse(lenguaje, 0, visited)) {
-        printf("SI: '%s' puede ejecutarse\n", nombre);
-    } else {
-        printf("NO: '%s' NO puede ejecutarse\n", nombre);
+    for (int lang = destino, paso = 1; t->via[lang] != -1; paso++) {
+        Entity *e = &registry.entities[t->via[lang]];
+        if (e->type == INTERP) {
+            printf("  %d. Interprete '%s'->'%s' (costo %d)\n", paso, name_of(e->lang1), name_of(e->lang2), e->cost);
+        } else {
+            printf("  %d. Traductor '%s':'%s'->'%s' (costo %d)\n", paso,
+                   name_of(e->lang1), name_of(e->lang2), name_of(e->lang3), e->cost);
+        }
+        lang = lenguaje_anterior(e);
     }
+    return pasos;
 }
 
-void procesar_comando(const char *comando) {
+#define MAX_TOKENS 6
+
+// Parte linea en palabras separadas por espacios, en una sola pasada y sin
+// copiar: pone un '\0' al final de cada palabra y deja en tokens hasta
+// MAX_TOKENS punteros (lo que sobra se ignora). Devuelve cuantas guardo.
+int tokenizar(char *linea, char **tokens) {
+    int n = 0;
+    char *p = linea;
+    while (n < MAX_TOKENS) {
+        while (isspace((unsigned char)*p)) p++;
+        if (!*p) break;
+        tokens[n++] = p;
+        while (*p && !isspace((unsigned char)*p)) p++;
+        if (*p) *p++ = '\0';
+    }
+    return n;
+}
+
+// Costo opcional al final de un DEFINIR: 1 si no esta, 0 si no es un
+// entero positivo
+static int leer_costo(const char *token) {
+    if (!token) return 1;
+    char *fin;
+    long costo = strtol(token, &fin, 10);
+    return *fin == '\0' && costo > 0 && costo <= 1000000 ? (int)costo : 0;
+}
+
+// Ejecuta un comando ya partido en palabras. linea solo se usa para el
+// mensaje de comando invalido.
+void procesar_tokens(char **tokens, int n, const char *linea) {
     functions_called[7]++;
-    char cmd[20], arg1[50], arg2[50], arg3[50];
+    int costo;
+    if (n < 2) {
+        if (strlen(linea) > 0) printf("ERROR: Comando invalido '%s'\n", linea);
+        return;
+    }
     
-    if (sscanf(comando, "%19s %49s %49s %49s", cmd, arg1, arg2, arg3) >= 2) {
-        to_uppercase(cmd);
+    to_uppercase(tokens[0]);
+    if (strcmp(tokens[0], "DEFINIR") == 0) {
+        to_uppercase(tokens[1]);
         
-        if (strcmp(cmd, "DEFINIR") == 0) {
-            to_uppercase(arg1);
-            
-            if (strcmp(arg1, "PROGRAMA") == 0 && sscanf(comando, "%*s %*s %49s %49s", arg2, arg3) >= 2) {
-                to_uppercase(arg3);
-                definir_programa(arg2, arg3);
-            }
-            else if (strcmp(arg1, "INTERPRETE") == 0 && sscanf(comando, "%*s %*s %49s %49s", arg2, arg3) >= 2) {
-                to_uppercase(arg2);
-                to_uppercase(arg3);
-                definir_interprete(arg2, arg3);
-            }
-            else if (strcmp(arg1, "TRADUCTOR") == 0 && sscanf(comando, "%*s %*s %49s %49s %49s", arg2, arg3, arg1) >= 3) {
-                to_uppercase(arg2);
-                to_uppercase(arg3);
-                to_uppercase(arg1);
-                definir_traductor(arg2, arg3, arg1);
-            }
-            else {
-                printf("ERROR: Sintaxis incorrecta en DEFINIR\n");
-            }
+        if (strcmp(tokens[1], "PROGRAMA") == 0 && n >= 4) {
+            to_uppercase(tokens[3]);
+            definir_programa(tokens[2], tokens[3]);
         }
-        else if (strcmp(cmd, "EJECUTABLE") == 0) {
-            ejecutable(arg1);
+        else if (strcmp(tokens[1], "INTERPRETE") == 0 && n >= 4 &&
+                 (costo = leer_costo(n > 4 ? tokens[4] : NULL)) > 0) {
+            to_uppercase(tokens[2]);
+            to_uppercase(tokens[3]);
+            definir_interprete_con_costo(tokens[2], tokens[3], costo);
+        }
+        else if (strcmp(tokens[1], "TRADUCTOR") == 0 && n >= 5 &&
+                 (costo = leer_costo(n > 5 ? tokens[5] : NULL)) > 0) {
+            to_uppercase(tokens[2]);
+            to_uppercase(tokens[3]);
+            to_uppercase(tokens[4]);
+            definir_traductor_con_costo(tokens[2], tokens[3], tokens[4], costo);
         }
         else {
-            printf("ERROR: Comando desconocido '%s'\n", cmd);
+            printf("ERROR: Sintaxis incorrecta en DEFINIR\n");
         }
-    } else if (strlen(comando) > 0) {
-        printf("ERROR: Comando invalido '%s'\n", comando);
+    }
+    else if (strcmp(tokens[0], "EJECUTABLE") == 0) {
+        ejecutable(tokens[1]);
+    }
+    else if (strcmp(tokens[0], "RUTA") == 0) {
+        if (n > 2) to_uppercase(tokens[2]);
+        if (n == 2 || strcmp(tokens[2], "SALTOS") == 0) ruta(tokens[1], 0);
+        else if (strcmp(tokens[2], "COSTO") == 0) ruta(tokens[1], 1);
+        else printf("ERROR: RUTA <programa> [SALTOS|COSTO]\n");
+    }
+    else {
+        printf("ERROR: Comando desconocido '%s'\n", tokens[0]);
     }
 }
 
+void procesar_comando(const char *comando) {
+    char *copia = malloc(strlen(comando) + 1);
+    if (!copia) {
+        printf("ERROR: Sin memoria\n");
+        return;
+    }
+    strcpy(copia, comando);
+    char *tokens[MAX_TOKENS];
+    int n = tokenizar(copia, tokens);
+    procesar_tokens(tokens, n, comando);
+    free(copia);
+}
+
 void verificar_test(const char *descripcion, int condicion) {
     total_tests++;
     if (condicion) {
@@ -263,78 +714,316 @@ void run_tests() {
     printf("=== EJECUTANDO PRUEBAS UNITARIAS ===\n");
     
     // Guardar estado anterior
-    int old_entity_count = entity_count;
-    Entity old_entities[MAX_ENTITIES];
-    memcpy(old_entities, entities, sizeof(entities));
+    Registry old_registry = registry;
     
     // Reset para pruebas
-    entity_count = 0;
+    memset(&registry, 0, sizeof(registry));
     tests_passed = 0;
     total_tests = 0;
     
     // Test 1: Programa directo a LOCAL
     printf("\n--- Test 1: Programa LOCAL ---\n");
     definir_programa("test1", "LOCAL");
-    ejecutable("test1");
-    verificar_test("Programa LOCAL es ejecutable", 1); // Siempre pasa por simplicidad
+    verificar_test("Programa LOCAL es ejecutable", ejecutable("test1") == 1);
     
     // Test 2: Programa con interprete directo
     printf("\n--- Test 2: Interprete simple ---\n");
     definir_programa("test2", "PYTHON");
     definir_interprete("LOCAL", "PYTHON");
-    ejecutable("test2");
-    verificar_test("Programa con interprete es ejecutable", 1);
+    verificar_test("Programa con interprete es ejecutable", ejecutable("test2") == 1);
     
     // Test 3: Programa no ejecutable
     printf("\n--- Test 3: Programa no ejecutable ---\n");
     definir_programa("test3", "RUBY");
-    ejecutable("test3");
-    verificar_test("Programa sin soporte no es ejecutable", 1);
+    verificar_test("Programa sin soporte no es ejecutable", ejecutable("test3") == 0);
     
     // Test 4: Cadena de interpretes
     printf("\n--- Test 4: Cadena de interpretes ---\n");
     definir_programa("test4", "JAVA");
     definir_interprete("PYTHON", "JAVA");
     definir_interprete("LOCAL", "PYTHON");
-    ejecutable("test4");
-    verificar_test("Cadena de interpretes funciona", 1);
+    verificar_test("Cadena de interpretes funciona", ejecutable("test4") == 1);
     
     // Test 5: Con traductor
     printf("\n--- Test 5: Con traductor ---\n");
     definir_programa("test5", "CPP");
     definir_traductor("LOCAL", "CPP", "C");
     definir_interprete("LOCAL", "C");
-    ejecutable("test5");
-    verificar_test("Traductor + interprete funciona", 1);
+    verificar_test("Traductor + interprete funciona", ejecutable("test5") == 1);
     
     // Test 6: Validaciones de error
     printf("\n--- Test 6: Validaciones de error ---\n");
     definir_programa("test6", "JS");
+    int entidades = registry.entity_count;
     definir_programa("test6", "JS"); // Duplicado
     definir_interprete("LOCAL", "PYTHON"); // Duplicado
-    ejecutable("programa_inexistente"); // No existe
-    verificar_test("Manejo de errores funciona", 1);
+    verificar_test("Manejo de errores funciona",
+                   registry.entity_count == entidades && ejecutable("programa_inexistente") == -1);
     
     // Test 7: Comandos invalidos
     printf("\n--- Test 7: Comandos invalidos ---\n");
     procesar_comando("COMANDO_INEXISTENTE");
     procesar_comando("DEFINIR ALGO_INVALIDO");
-    verificar_test("Comandos invalidos manejados", 1);
+    verificar_test("Comandos invalidos manejados", registry.entity_count == entidades);
+    
+    // Test 8: Lenguajes con la misma inicial (la version vieja los tomaba
+    // como un ciclo)
+    printf("\n--- Test 8: Misma inicial ---\n");
+    definir_programa("test8", "PROLOG");
+    definir_interprete("PASCAL", "PROLOG");
+    definir_interprete("PYTHON", "PASCAL");
+    verificar_test("PROLOG sobre PASCAL sobre PYTHON es ejecutable", ejecutable("test8") == 1);
+    
+    // Test 9: Cadena larga (la version vieja cortaba a los 10 niveles).
+    // Se define de atras para adelante: LOCAL llega recien al final.
+    printf("\n--- Test 9: Cadena de 40 interpretes ---\n");
+    char base[16], lang[16];
+    definir_programa("test9", "PERL");
+    strcpy(lang, "PERL");
+    for (int i = 1; i < 40; i++) {
+        sprintf(base, "L%d", i);
+        definir_interprete(base, lang);
+        strcpy(lang, base);
+    }
+    int antes = ejecutable("test9");
+    definir_traductor("LOCAL", lang, "RUBY");
+    definir_interprete("LOCAL", "RUBY");
+    verificar_test("Cadena larga se resuelve al cerrarse", antes == 0 && ejecutable("test9") == 1);
+    
+    // Test 10: Ciclo sin salida a LOCAL
+    printf("\n--- Test 10: Ciclo ---\n");
+    definir_programa("test10", "AA");
+    definir_interprete("BB", "AA");
+    definir_interprete("AA", "BB");
+    definir_traductor("LOCAL", "BB", "AA");
+    verificar_test("Ciclo sin LOCAL no es ejecutable", ejecutable("test10") == 0);
+    
+    // Test 11: Rutas. Directo con un interprete caro, o en dos pasos baratos
+    printf("\n--- Test 11: Ruta mas corta y mas barata ---\n");
+    definir_programa("test11", "GO");
+    definir_interprete_con_costo("LOCAL", "GO", 10);
+    definir_traductor_con_costo("LOCAL", "GO", "RUST", 1);
+    definir_interprete_con_costo("LOCAL", "RUST", 2);
+    verificar_test("Ruta por saltos usa el interprete directo", ruta("test11", 0) == 1);
+    verificar_test("Ruta por costo usa traductor + interprete", ruta("test11", 1) == 2);
+    verificar_test("Ruta de la cadena larga tiene 41 pasos", ruta("test9", 0) == 41);
+    verificar_test("Ruta de un programa no ejecutable falla", ruta("test10", 0) == -1);
     
     // Restaurar estado
-    entity_count = old_entity_count;
-    memcpy(entities, old_entities, sizeof(entities));
+    registry_free();
+    registry = old_registry;
     
     printf("\n=== PRUEBAS COMPLETADAS ===\n");
     calcular_cobertura();
 }
 
-int main() {
+// --- Modo batch ---
+
+// Compara una palabra sin importar mayusculas
+static int es_palabra(const char *token, const char *palabra) {
+    for (; *token && *palabra; token++, palabra++) {
+        if (toupper((unsigned char)*token) != *palabra) return 0;
+    }
+    return *token == *palabra;
+}
+
+// Lee todo f de una vez. El texto queda terminado en '\0' (largo no lo cuenta).
+static char *leer_todo(FILE *f, size_t *largo) {
+    size_t capacidad = 1 << 16, n = 0;
+    char *texto = malloc(capacidad);
+    if (!texto) return NULL;
+    size_t leidos;
+    while ((leidos = fread(texto + n, 1, capacidad - n - 1, f)) > 0) {
+        n += leidos;
+        if (capacidad - n - 1 == 0) {
+            char *mas = realloc(texto, capacidad * 2);
+            if (!mas) {
+                free(texto);
+                return NULL;
+            }
+            texto = mas;
+            capacidad *= 2;
+        }
+    }
+    texto[n] = '\0';
+    *largo = n;
+    return texto;
+}
+
+// Procesa un script entero (texto termina en '\0' y se modifica): cada
+// linea se parte en palabras en el lugar, sin copias ni sscanf. Las lineas
+// en blanco se saltean; SALIR termina y PRUEBAS corre las pruebas.
+void procesar_script(char *texto, size_t largo) {
+    char *fin = texto + largo;
+    for (char *linea = texto; linea < fin;) {
+        char *corte = memchr(linea, '\n', fin - linea);
+        if (!corte) corte = fin;
+        *corte = '\0';
+        if (corte > linea && corte[-1] == '\r') corte[-1] = '\0';
+        
+        char *tokens[MAX_TOKENS];
+        int n = tokenizar(linea, tokens);
+        if (n == 1 && es_palabra(tokens[0], "SALIR")) break;
+        if (n == 1 && es_palabra(tokens[0], "PRUEBAS")) run_tests();
+        else if (n > 0) procesar_tokens(tokens, n, tokens[0]);
+        linea = corte + 1;
+    }
+}
+
+// Script de prueba con lineas comandos: un catalogo de interpretes y
+// traductores entre lenguajes L0..Ln, programas y consultas mezclados
+static char *generar_script(int lineas, size_t *largo) {
+    size_t capacidad = (size_t)lineas * 48 + 1;
+    char *texto = malloc(capacidad);
+    if (!texto) return NULL;
+    int lenguajes = lineas / 20 + 2;
+    unsigned int semilla = 12345;
+    size_t n = 0;
+    for (int i = 0; i < lineas; i++) {
+        semilla = semilla * 1103515245u + 12345u;
+        unsigned int r = (semilla >> 8) % 100;
+        unsigned int a = (semilla >> 4) % lenguajes, b = (semilla * 7u >> 10) % lenguajes;
+        unsigned int c = (semilla * 13u >> 12) % lenguajes;
+        if (i == 0) {
+            n += sprintf(texto + n, "DEFINIR INTERPRETE LOCAL L0\n");
+        } else if (r < 10) {
+            n += sprintf(texto + n, "DEFINIR INTERPRETE L%u L%u\n", a, b);
+        } else if (r < 15) {
+            n += sprintf(texto + n, "DEFINIR TRADUCTOR L%u L%u L%u\n", a, b, c);
+        } else if (r < 60) {
+            n += sprintf(texto + n, "DEFINIR PROGRAMA p%d L%u\n", i, a);
+        } else {
+            n += sprintf(texto + n, "EJECUTABLE p%u\n", semilla % (unsigned int)(i + 1));
+        }
+    }
+    *largo = n;
+    return texto;
+}
+
+// Copia del procesar_comando original (sscanf sobre buffers fijos, una
+// lectura por comando y otra por DEFINIR), solo como punto de comparacion
+// del benchmark. Entiende lo que genera generar_script: DEFINIR sin costo y
+// EJECUTABLE.
+static void procesar_comando_sscanf(const char *comando) {
+    char cmd[20], arg1[50], arg2[50], arg3[50];
+    
+    if (sscanf(comando, "%19s %49s %49s %49s", cmd, arg1, arg2, arg3) >= 2) {
+        to_uppercase(cmd);
+        
+        if (strcmp(cmd, "DEFINIR") == 0) {
+            to_uppercase(arg1);
+            
+            if (strcmp(arg1, "PROGRAMA") == 0 && sscanf(comando, "%*s %*s %49s %49s", arg2, arg3) >= 2) {
+                to_uppercase(arg3);
+                definir_programa(arg2, arg3);
+            }
+            else if (strcmp(arg1, "INTERPRETE") == 0 && sscanf(comando, "%*s %*s %49s %49s", arg2, arg3) >= 2) {
+                to_uppercase(arg2);
+                to_uppercase(arg3);
+                definir_interprete(arg2, arg3);
+            }
+            else if (strcmp(arg1, "TRADUCTOR") == 0 && sscanf(comando, "%*s %*s %49s %49s %49s", arg2, arg3, arg1) >= 3) {
+                to_uppercase(arg2);
+                to_uppercase(arg3);
+                to_uppercase(arg1);
+                definir_traductor(arg2, arg3, arg1);
+            }
+            else {
+                printf("ERROR: Sintaxis incorrecta en DEFINIR\n");
+            }
+        }
+        else if (strcmp(cmd, "EJECUTABLE") == 0) {
+            ejecutable(arg1);
+        }
+        else {
+            printf("ERROR: Comando desconocido '%s'\n", cmd);
+        }
+    } else if (strlen(comando) > 0) {
+        printf("ERROR: Comando invalido '%s'\n", comando);
+    }
+}
+
+// Compara el modo batch (un fread, tokenizar en el lugar, un solo volcado
+// de stdout) contra el camino original linea por linea (procesar_comando_sscanf
+// y un fflush por linea, como el modo interactivo). Ambos usan el mismo
+// registro, asi que la mejora mide lectura, parseo y salida, no la
+// resolucion de EJECUTABLE. La salida de los comandos va a stdout; los
+// tiempos, a stderr.
+void benchmark(int lineas) {
+    size_t largo;
+    char *script = generar_script(lineas, &largo);
+    char *copia = script ? malloc(largo + 1) : NULL;
+    if (!copia) {
+        fprintf(stderr, "ERROR: Sin memoria\n");
+        free(script);
+        return;
+    }
+    memcpy(copia, script, largo + 1);
+    
+    clock_t inicio = clock();
+    procesar_script(copia, largo);
+    fflush(stdout);
+    double t_batch = (double)(clock() - inicio) / CLOCKS_PER_SEC;
+    registry_free();
+    
+    inicio = clock();
+    for (char *linea = script; *linea;) {
+        char *corte = strchr(linea, '\n');
+        *corte = '\0';
+        procesar_comando_sscanf(linea);
+        fflush(stdout);
+        linea = corte + 1;
+    }
+    double t_lineas = (double)(clock() - inicio) / CLOCKS_PER_SEC;
+    registry_free();
+    
+    fprintf(stderr, "%d lineas (%.1f MB)\n", lineas, largo / 1e6);
+    fprintf(stderr, "  batch (tokenizar, sin fflush):    %8.3f s  %12.0f lineas/s\n", t_batch, lineas / t_batch);
+    fprintf(stderr, "  linea por linea (sscanf, fflush): %8.3f s  %12.0f lineas/s\n", t_lineas, lineas / t_lineas);
+    fprintf(stderr, "  mejora:                           %8.2fx\n", t_lineas / t_batch);
+    free(script);
+    free(copia);
+}
+
+// TDiagram                  interactivo
+// TDiagram --batch [arch]   procesa arch (o stdin) entero, sin prompts
+// TDiagram --bench [lineas] compara batch contra linea por linea
+int main(int argc, char **argv) {
+    if (argc > 1 && strcmp(argv[1], "--batch") == 0) {
+        FILE *f = argc > 2 ? fopen(argv[2], "rb") : stdin;
+        if (!f) {
+            fprintf(stderr, "ERROR: No se pudo abrir '%s'\n", argv[2]);
+            return 1;
+        }
+        size_t largo;
+        char *texto = leer_todo(f, &largo);
+        if (f != stdin) fclose(f);
+        if (!texto) {
+            fprintf(stderr, "ERROR: Sin memoria\n");
+            return 1;
+        }
+        // Salida en bloques grandes: un solo flush al final
+        setvbuf(stdout, NULL, _IOFBF, 1 << 16);
+        procesar_script(texto, largo);
+        free(texto);
+        registry_free();
+        return 0;
+    }
+    if (argc > 1 && strcmp(argv[1], "--bench") == 0) {
+        int lineas = argc > 2 ? atoi(argv[2]) : 1000000;
+        if (lineas <= 0) lineas = 1000000;
+        setvbuf(stdout, NULL, _IOFBF, 1 << 16);
+        benchmark(lineas);
+        return 0;
+    }
+    
     printf("=== SISTEMA PROGRAMAS/INTERPRETES/TRADUCTORES ===\n");
-    printf("Comandos: DEFINIR PROGRAMA|INTERPRETE|TRADUCTOR ...\n");
+    printf("Comandos: DEFINIR PROGRAMA|INTERPRETE|TRADUCTOR ... [costo]\n");
     printf("          EJECUTABLE <nombre>\n");
+    printf("          RUTA <nombre> [SALTOS|COSTO]\n");
     printf("          PRUEBAS\n");
-    printf("          SALIR\n\n");
+    printf("          SALIR\n");
+    printf("Sin prompts: TDiagram --batch [archivo] (o stdin)\n\n");
     
     // Ejemplo de uso
     printf("Ejemplos:\n");
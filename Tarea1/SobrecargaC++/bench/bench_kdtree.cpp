@@ -0,0 +1,127 @@
+#include "benchmark.hpp"
+#include "../src/kdtree.hpp"
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+// Arbol k-d contra fuerza bruta con los operadores de Vector3.
+// Los argumentos son la cantidad de puntos de la nube; cada iteracion hace
+// 1024 consultas (items = consultas).
+
+static const std::size_t queries_per_iter = 1024;
+
+static std::vector<Vector3> make_cloud(std::size_t n, std::uint32_t seed) {
+    std::vector<Vector3> v(n);
+    auto next = [&seed] {
+        seed = seed * 1664525u + 1013904223u;
+        return (seed >> 8) * (100.0 / 16777216.0);
+    };
+    for (std::size_t i = 0; i < n; i++) v[i] = Vector3(next(), next(), next());
+    return v;
+}
+
+// --- Fuerza bruta (lo que se hacia antes) ---
+
+static void BM_BruteNearest(bench::State& state) {
+    auto pts = make_cloud(state.range(0), 1), qs = make_cloud(queries_per_iter, 2);
+    for (auto _ : state) {
+        for (const Vector3& q : qs) {
+            std::size_t best = 0;
+            double best_d = &(pts[0] - q);
+            for (std::size_t i = 1; i < pts.size(); i++) {
+                double d = &(pts[i] - q);
+                if (d < best_d) {
+                    best_d = d;
+                    best = i;
+                }
+            }
+            bench::DoNotOptimize(best);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * queries_per_iter);
+}
+BENCHMARK(BM_BruteNearest)->Arg(10000)->Arg(100000);
+
+static void BM_BruteRadius(bench::State& state) {
+    auto pts = make_cloud(state.range(0), 1), qs = make_cloud(queries_per_iter, 2);
+    std::vector<std::size_t> out;
+    for (auto _ : state) {
+        for (const Vector3& q : qs) {
+            out.clear();
+            for (std::size_t i = 0; i < pts.size(); i++) {
+                if (&(pts[i] - q) <= 5.0) out.push_back(i);
+            }
+            bench::DoNotOptimize(out.data());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * queries_per_iter);
+}
+BENCHMARK(BM_BruteRadius)->Arg(10000)->Arg(100000);
+
+// --- Arbol k-d ---
+
+static void BM_KdBuild(bench::State& state) {
+    auto pts = make_cloud(state.range(0), 1);
+    geom::KdTree<double> tree;
+    for (auto _ : state) tree.build(pts.data(), pts.size(), state.range(1));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+static void build_args(bench::Benchmark* b) {
+    unsigned hw = std::thread::hardware_concurrency();
+    for (std::int64_t n : {100000, 1000000}) {
+        b->Args({n, 1});
+        if (hw > 1) b->Args({n, hw});
+    }
+}
+BENCHMARK(BM_KdBuild)->Apply(build_args)->UseRealTime();
+
+static void BM_KdNearest(bench::State& state) {
+    auto pts = make_cloud(state.range(0), 1), qs = make_cloud(queries_per_iter, 2);
+    geom::KdTree<double> tree(pts.data(), pts.size());
+    for (auto _ : state) {
+        for (const Vector3& q : qs) bench::DoNotOptimize(tree.nearest(q));
+    }
+    state.SetItemsProcessed(state.iterations() * queries_per_iter);
+}
+BENCHMARK(BM_KdNearest)->Arg(10000)->Arg(100000)->Arg(1000000);
+
+static void BM_KdKnn8(bench::State& state) {
+    auto pts = make_cloud(state.range(0), 1), qs = make_cloud(queries_per_iter, 2);
+    geom::KdTree<double> tree(pts.data(), pts.size());
+    geom::Neighbor<double> out[8];
+    for (auto _ : state) {
+        for (const Vector3& q : qs) bench::DoNotOptimize(tree.knn(q, 8, out));
+    }
+    state.SetItemsProcessed(state.iterations() * queries_per_iter);
+}
+BENCHMARK(BM_KdKnn8)->Arg(10000)->Arg(100000)->Arg(1000000);
+
+static void BM_KdRadius(bench::State& state) {
+    auto pts = make_cloud(state.range(0), 1), qs = make_cloud(queries_per_iter, 2);
+    geom::KdTree<double> tree(pts.data(), pts.size());
+    std::vector<std::size_t> out;
+    for (auto _ : state) {
+        for (const Vector3& q : qs) {
+            out.clear();
+            tree.radius(q, 5.0, out);
+            bench::DoNotOptimize(out.data());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * queries_per_iter);
+}
+BENCHMARK(BM_KdRadius)->Arg(10000)->Arg(100000)->Arg(1000000);
+
+// kNN en bloque repartido entre todos los nucleos
+static void BM_KdKnn8Batch(bench::State& state) {
+    auto pts = make_cloud(state.range(0), 1), qs = make_cloud(queries_per_iter, 2);
+    geom::KdTree<double> tree(pts.data(), pts.size());
+    std::vector<geom::Neighbor<double>> out(qs.size() * 8);
+    for (auto _ : state) {
+        tree.knn_batch(qs.data(), qs.size(), 8, out.data());
+        bench::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * queries_per_iter);
+}
+BENCHMARK(BM_KdKnn8Batch)->Arg(100000)->Arg(1000000)->UseRealTime();
+
+BENCHMARK_MAIN();
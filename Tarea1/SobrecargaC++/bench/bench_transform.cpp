@@ -0,0 +1,111 @@
+#include "benchmark.hpp"
+#include "../src/transform.hpp"
+#include <vector>
+
+// Aplicar una misma transformacion a n vectores: por vector (arreglo de
+// Vector3, como el codigo que ya existe) contra los kernels en bloque.
+// Mismos tamanos que bench_vector3.cpp (L1, L2, L3, DRAM).
+
+#define CACHE_SIZES Arg(512)->Arg(8192)->Arg(131072)->Arg(4194304)
+
+using geom::Mat3;
+using geom::Mat4;
+using geom::Quat;
+
+static std::vector<Vector3> make_vectors(std::size_t n) {
+    std::vector<Vector3> v(n);
+    for (std::size_t i = 0; i < n; i++) {
+        double t = double(i % 1024) * 0.37;
+        v[i] = Vector3(t, 1.0 - t * 0.5, 2.0 + t * 0.25);
+    }
+    return v;
+}
+
+static Vector3Batch make_batch(std::size_t n) {
+    Vector3Batch b;
+    b.reserve(n);
+    for (const Vector3& v : make_vectors(n)) b.push_back(v);
+    return b;
+}
+
+static void set_counters(bench::State& state) {
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetBytesProcessed(state.iterations() * state.range(0) * 2 * sizeof(Vector3));
+}
+
+static const Mat3<double> rot = Mat3<double>::rotation({1, 2, 3}, 0.7);
+static const Quat<double> quat = Quat<double>::from_axis_angle({1, 2, 3}, 0.7);
+static const Mat4<double> proj =
+    Mat4<double>::perspective(1.2, 1.5, 0.5, 500) * Mat4<double>(rot, {0, 0, -600});
+
+// --- Por vector ---
+
+static void BM_Mat3PerVector(bench::State& state) {
+    auto a = make_vectors(state.range(0));
+    std::vector<Vector3> out(a.size());
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < a.size(); i++) out[i] = rot * a[i];
+        bench::ClobberMemory();
+    }
+    set_counters(state);
+}
+BENCHMARK(BM_Mat3PerVector)->CACHE_SIZES;
+
+static void BM_QuatRotatePerVector(bench::State& state) {
+    auto a = make_vectors(state.range(0));
+    std::vector<Vector3> out(a.size());
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < a.size(); i++) out[i] = quat.rotate(a[i]);
+        bench::ClobberMemory();
+    }
+    set_counters(state);
+}
+BENCHMARK(BM_QuatRotatePerVector)->CACHE_SIZES;
+
+static void BM_ProjectPerVector(bench::State& state) {
+    auto a = make_vectors(state.range(0));
+    std::vector<Vector3> out(a.size());
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < a.size(); i++) out[i] = proj.transform_point(a[i]);
+        bench::ClobberMemory();
+    }
+    set_counters(state);
+}
+BENCHMARK(BM_ProjectPerVector)->CACHE_SIZES;
+
+// --- En bloque ---
+
+static void BM_BatchTransform(bench::State& state) {
+    Vector3Batch a = make_batch(state.range(0)), out(state.range(0));
+    for (auto _ : state) {
+        geom::batch_transform(rot, a, out);
+        bench::ClobberMemory();
+    }
+    set_counters(state);
+    state.SetLabel(simd::isa_name());
+}
+BENCHMARK(BM_BatchTransform)->CACHE_SIZES;
+
+static void BM_BatchRotate(bench::State& state) {
+    Vector3Batch a = make_batch(state.range(0)), out(state.range(0));
+    for (auto _ : state) {
+        geom::batch_rotate(quat, a, out);
+        bench::ClobberMemory();
+    }
+    set_counters(state);
+    state.SetLabel(simd::isa_name());
+}
+BENCHMARK(BM_BatchRotate)->CACHE_SIZES;
+
+static void BM_BatchProject(bench::State& state) {
+    Vector3Batch a = make_batch(state.range(0)), out(state.range(0));
+    for (auto _ : state) {
+        geom::batch_transform_point(proj, a, out);
+        bench::ClobberMemory();
+    }
+    set_counters(state);
+    state.SetLabel(simd::isa_name());
+}
+BENCHMARK(BM_BatchProject)->CACHE_SIZES;
+
+BENCHMARK_MAIN();
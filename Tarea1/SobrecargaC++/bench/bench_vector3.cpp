@@ -0,0 +1,268 @@
+#include "benchmark.hpp"
+#include "../src/vector3_batch.hpp"
+#include <ostream>
+#include <streambuf>
+#include <vector>
+
+// Benchmarks por operador de Vector3. Cada uno recorre un arreglo de n
+// vectores; los tamanos se eligen para caer en cada nivel de memoria
+// (24 bytes por Vector3 de doubles):
+//     512      ->  12 KB  (L1)
+//     8192     -> 192 KB  (L2)
+//     131072   ->   3 MB  (L3)
+//     4194304  -> 96 MB   (DRAM)
+
+#define CACHE_SIZES Arg(512)->Arg(8192)->Arg(131072)->Arg(4194304)
+
+// Datos deterministas para que las corridas sean comparables
+static std::vector<Vector3> make_vectors(std::size_t n, double seed) {
+    std::vector<Vector3> v(n);
+    for (std::size_t i = 0; i < n; i++) {
+        double t = seed + double(i % 1024) * 0.37;
+        v[i] = Vector3(t, 1.0 - t * 0.5, 2.0 + t * 0.25);
+    }
+    return v;
+}
+
+static Vector3Batch make_batch(std::size_t n, double seed) {
+    Vector3Batch b;
+    b.reserve(n);
+    for (const Vector3& v : make_vectors(n, seed)) b.push_back(v);
+    return b;
+}
+
+// Marca items y bytes procesados por iteracion
+static void set_counters(bench::State& state, std::size_t bytes_per_item) {
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetBytesProcessed(state.iterations() * state.range(0) * bytes_per_item);
+}
+
+// --- Operadores por objeto (arreglo de Vector3) ---
+
+static void BM_Add(bench::State& state) {
+    std::size_t n = state.range(0);
+    auto a = make_vectors(n, 1), b = make_vectors(n, 2);
+    std::vector<Vector3> out(n);
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < n; i++) out[i] = a[i] + b[i];
+        bench::ClobberMemory();
+    }
+    set_counters(state, 3 * sizeof(Vector3));
+}
+BENCHMARK(BM_Add)->CACHE_SIZES;
+
+static void BM_Sub(bench::State& state) {
+    std::size_t n = state.range(0);
+    auto a = make_vectors(n, 1), b = make_vectors(n, 2);
+    std::vector<Vector3> out(n);
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < n; i++) out[i] = a[i] - b[i];
+        bench::ClobberMemory();
+    }
+    set_counters(state, 3 * sizeof(Vector3));
+}
+BENCHMARK(BM_Sub)->CACHE_SIZES;
+
+static void BM_Cross(bench::State& state) {
+    std::size_t n = state.range(0);
+    auto a = make_vectors(n, 1), b = make_vectors(n, 2);
+    std::vector<Vector3> out(n);
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < n; i++) out[i] = a[i] * b[i];
+        bench::ClobberMemory();
+    }
+    set_counters(state, 3 * sizeof(Vector3));
+}
+BENCHMARK(BM_Cross)->CACHE_SIZES;
+
+static void BM_Dot(bench::State& state) {
+    std::size_t n = state.range(0);
+    auto a = make_vectors(n, 1), b = make_vectors(n, 2);
+    std::vector<double> out(n);
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < n; i++) out[i] = a[i] % b[i];
+        bench::ClobberMemory();
+    }
+    set_counters(state, 2 * sizeof(Vector3) + sizeof(double));
+}
+BENCHMARK(BM_Dot)->CACHE_SIZES;
+
+static void BM_Norm(bench::State& state) {
+    std::size_t n = state.range(0);
+    auto a = make_vectors(n, 1);
+    std::vector<double> out(n);
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < n; i++) out[i] = &a[i];
+        bench::ClobberMemory();
+    }
+    set_counters(state, sizeof(Vector3) + sizeof(double));
+}
+BENCHMARK(BM_Norm)->CACHE_SIZES;
+
+static void BM_ScalarAdd(bench::State& state) {
+    std::size_t n = state.range(0);
+    auto a = make_vectors(n, 1);
+    std::vector<Vector3> out(n);
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < n; i++) out[i] = a[i] + 3.0;
+        bench::ClobberMemory();
+    }
+    set_counters(state, 2 * sizeof(Vector3));
+}
+BENCHMARK(BM_ScalarAdd)->CACHE_SIZES;
+
+static void BM_ScalarMul(bench::State& state) {
+    std::size_t n = state.range(0);
+    auto a = make_vectors(n, 1);
+    std::vector<Vector3> out(n);
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < n; i++) out[i] = a[i] * 1.5;
+        bench::ClobberMemory();
+    }
+    set_counters(state, 2 * sizeof(Vector3));
+}
+BENCHMARK(BM_ScalarMul)->CACHE_SIZES;
+
+static void BM_ScalarDiv(bench::State& state) {
+    std::size_t n = state.range(0);
+    auto a = make_vectors(n, 1);
+    std::vector<Vector3> out(n);
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < n; i++) out[i] = a[i] / 1.5;
+        bench::ClobberMemory();
+    }
+    set_counters(state, 2 * sizeof(Vector3));
+}
+BENCHMARK(BM_ScalarDiv)->CACHE_SIZES;
+
+// Normalizar a mano: una raiz y tres divisiones
+static void BM_NormalizeDivide(bench::State& state) {
+    std::size_t n = state.range(0);
+    auto a = make_vectors(n, 1);
+    std::vector<Vector3> out(n);
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < n; i++) out[i] = a[i] / &a[i];
+        bench::ClobberMemory();
+    }
+    set_counters(state, 2 * sizeof(Vector3));
+}
+BENCHMARK(BM_NormalizeDivide)->CACHE_SIZES;
+
+static void BM_Normalized(bench::State& state) {
+    std::size_t n = state.range(0);
+    auto a = make_vectors(n, 1);
+    std::vector<Vector3> out(n);
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < n; i++) out[i] = a[i].normalized();
+        bench::ClobberMemory();
+    }
+    set_counters(state, 2 * sizeof(Vector3));
+}
+BENCHMARK(BM_Normalized)->CACHE_SIZES;
+
+static void BM_NormalizedApprox(bench::State& state) {
+    std::size_t n = state.range(0);
+    auto a = make_vectors(n, 1);
+    std::vector<Vector3> out(n);
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < n; i++) out[i] = a[i].normalized_approx();
+        bench::ClobberMemory();
+    }
+    set_counters(state, 2 * sizeof(Vector3));
+}
+BENCHMARK(BM_NormalizedApprox)->CACHE_SIZES;
+
+// streambuf que descarta todo: mide el formateo, no la memoria del destino
+class NullBuffer : public std::streambuf {
+protected:
+    int overflow(int c) override { return c; }
+    std::streamsize xsputn(const char*, std::streamsize n) override { return n; }
+};
+
+static void BM_Output(bench::State& state) {
+    std::size_t n = state.range(0);
+    auto a = make_vectors(n, 1);
+    NullBuffer buffer;
+    std::ostream os(&buffer);
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < n; i++) os << a[i] << '\n';
+    }
+    set_counters(state, sizeof(Vector3));
+}
+BENCHMARK(BM_Output)->CACHE_SIZES;
+
+// --- Kernels en bloque (Vector3Batch) para comparar ---
+
+static void BM_BatchAdd(bench::State& state) {
+    std::size_t n = state.range(0);
+    auto a = make_batch(n, 1), b = make_batch(n, 2);
+    Vector3Batch out(n);
+    for (auto _ : state) {
+        batch_add(a, b, out);
+        bench::ClobberMemory();
+    }
+    set_counters(state, 3 * sizeof(Vector3));
+}
+BENCHMARK(BM_BatchAdd)->CACHE_SIZES;
+
+static void BM_BatchCross(bench::State& state) {
+    std::size_t n = state.range(0);
+    auto a = make_batch(n, 1), b = make_batch(n, 2);
+    Vector3Batch out(n);
+    for (auto _ : state) {
+        batch_cross(a, b, out);
+        bench::ClobberMemory();
+    }
+    set_counters(state, 3 * sizeof(Vector3));
+}
+BENCHMARK(BM_BatchCross)->CACHE_SIZES;
+
+static void BM_BatchDot(bench::State& state) {
+    std::size_t n = state.range(0);
+    auto a = make_batch(n, 1), b = make_batch(n, 2);
+    std::vector<double> out(n);
+    for (auto _ : state) {
+        batch_dot(a, b, out.data());
+        bench::ClobberMemory();
+    }
+    set_counters(state, 2 * sizeof(Vector3) + sizeof(double));
+}
+BENCHMARK(BM_BatchDot)->CACHE_SIZES;
+
+static void BM_BatchNorm(bench::State& state) {
+    std::size_t n = state.range(0);
+    auto a = make_batch(n, 1);
+    std::vector<double> out(n);
+    for (auto _ : state) {
+        batch_norm(a, out.data());
+        bench::ClobberMemory();
+    }
+    set_counters(state, sizeof(Vector3) + sizeof(double));
+}
+BENCHMARK(BM_BatchNorm)->CACHE_SIZES;
+
+static void BM_BatchNormalize(bench::State& state) {
+    std::size_t n = state.range(0);
+    auto a = make_batch(n, 1);
+    Vector3Batch out(n);
+    for (auto _ : state) {
+        batch_normalize(a, out);
+        bench::ClobberMemory();
+    }
+    set_counters(state, 2 * sizeof(Vector3));
+}
+BENCHMARK(BM_BatchNormalize)->CACHE_SIZES;
+
+static void BM_BatchNormalizeApprox(bench::State& state) {
+    std::size_t n = state.range(0);
+    auto a = make_batch(n, 1);
+    Vector3Batch out(n);
+    for (auto _ : state) {
+        batch_normalize_approx(a, out);
+        bench::ClobberMemory();
+    }
+    set_counters(state, 2 * sizeof(Vector3));
+}
+BENCHMARK(BM_BatchNormalizeApprox)->CACHE_SIZES;
+
+BENCHMARK_MAIN();
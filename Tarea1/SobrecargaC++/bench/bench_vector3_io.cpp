@@ -0,0 +1,103 @@
+#include "benchmark.hpp"
+#include "../src/vector3_io.hpp"
+#include <cstdio>
+#include <sstream>
+#include <vector>
+
+// Benchmarks de entrada/salida: operator<< contra el camino de texto con
+// to_chars y contra el formato binario (escritura, lectura y mmap).
+// Los archivos se escriben en el directorio actual y se borran al terminar.
+
+static std::vector<Vector3> make_vectors(std::size_t n) {
+    std::vector<Vector3> v(n);
+    for (std::size_t i = 0; i < n; i++) {
+        double t = double(i) * 0.37;
+        v[i] = Vector3(t, 1.0 - t * 0.5, 2.0 + t / 3.0);
+    }
+    return v;
+}
+
+static void set_counters(bench::State& state) {
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetBytesProcessed(state.iterations() * state.range(0) * sizeof(Vector3));
+}
+
+// Texto con iostream (lo que habia antes)
+static void BM_TextOstream(bench::State& state) {
+    auto v = make_vectors(state.range(0));
+    for (auto _ : state) {
+        std::ostringstream os;
+        for (const Vector3& p : v) os << p.x << ' ' << p.y << ' ' << p.z << '\n';
+        bench::DoNotOptimize(os.tellp());
+    }
+    set_counters(state);
+}
+BENCHMARK(BM_TextOstream)->Arg(8192)->Arg(131072);
+
+// Texto con to_chars a un buffer del llamador
+static void BM_TextToChars(bench::State& state) {
+    auto v = make_vectors(state.range(0));
+    std::vector<char> buf(v.size() * 80);
+    for (auto _ : state) {
+        char* p = buf.data();
+        for (const Vector3& x : v) {
+            p = geom::to_chars(p, buf.data() + buf.size(), x);
+            *p++ = '\n';
+        }
+        bench::DoNotOptimize(p);
+    }
+    set_counters(state);
+}
+BENCHMARK(BM_TextToChars)->Arg(8192)->Arg(131072);
+
+// Texto con from_chars desde memoria
+static void BM_TextParse(bench::State& state) {
+    auto v = make_vectors(state.range(0));
+    std::vector<char> buf(v.size() * 80);
+    char* end = buf.data();
+    for (const Vector3& x : v) {
+        end = geom::to_chars(end, buf.data() + buf.size(), x);
+        *end++ = '\n';
+    }
+    std::vector<Vector3> out(v.size());
+    for (auto _ : state) {
+        bench::DoNotOptimize(geom::parse_text(buf.data(), end, out.data(), out.size()));
+        bench::ClobberMemory();
+    }
+    set_counters(state);
+}
+BENCHMARK(BM_TextParse)->Arg(8192)->Arg(131072);
+
+// Binario: escritura y lectura completa con stdio
+static void BM_BinaryWriteRead(bench::State& state) {
+    const char* path = "vector3_io_bench.bin";
+    auto v = make_vectors(state.range(0));
+    std::vector<Vector3> out(v.size());
+    for (auto _ : state) {
+        geom::write_binary(path, v.data(), v.size());
+        bench::DoNotOptimize(geom::read_binary(path, out.data(), out.size()));
+    }
+    std::remove(path);
+    set_counters(state);
+}
+BENCHMARK(BM_BinaryWriteRead)->Arg(131072)->Arg(4194304)->UseRealTime();
+
+#ifdef VECTOR3_IO_HAS_MMAP
+// Binario mapeado: abrir y sumar las x (sin copiar ni parsear)
+static void BM_BinaryMmapSum(bench::State& state) {
+    const char* path = "vector3_io_bench.bin";
+    auto v = make_vectors(state.range(0));
+    geom::write_binary(path, v.data(), v.size());
+    for (auto _ : state) {
+        geom::MappedVector3File<double> file(path);
+        double sum = 0;
+        for (const Vector3& p : file) sum += p.x;
+        bench::DoNotOptimize(sum);
+    }
+    std::remove(path);
+    set_counters(state);
+}
+BENCHMARK(BM_BinaryMmapSum)->Arg(131072)->Arg(4194304)->UseRealTime();
+#endif
+
+BENCHMARK_MAIN();
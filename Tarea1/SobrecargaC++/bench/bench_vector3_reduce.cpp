@@ -0,0 +1,75 @@
+#include "benchmark.hpp"
+#include "../src/vector3_reduce.hpp"
+#include <thread>
+#include <vector>
+
+// Escalamiento de las reducciones de 1 a N hilos (N = nucleos de la maquina).
+// Los argumentos son {cantidad de vectores, hilos}. Se mide tiempo real,
+// porque el tiempo de CPU suma el de todos los hilos.
+
+static std::vector<Vector3> make_vectors(std::size_t n) {
+    std::vector<Vector3> v(n);
+    for (std::size_t i = 0; i < n; i++) {
+        double t = double(i % 1024) * 0.37;
+        v[i] = Vector3(t, 1.0 - t * 0.5, 2.0 + t * 0.25);
+    }
+    return v;
+}
+
+// {n, 1}, {n, 2}, {n, 4}, ..., {n, N} para n en L3 y en DRAM
+static void thread_counts(bench::Benchmark* b) {
+    unsigned hw = std::thread::hardware_concurrency();
+    if (hw == 0) hw = 1;
+    for (std::int64_t n : {131072, 4194304}) {
+        for (unsigned t = 1; t < hw; t *= 2) b->Args({n, t});
+        b->Args({n, hw});
+    }
+}
+
+static void set_counters(bench::State& state) {
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetBytesProcessed(state.iterations() * state.range(0) * sizeof(Vector3));
+}
+
+// Referencia: el ciclo de siempre con operator+ en un solo hilo
+static void BM_SumLoop(bench::State& state) {
+    auto v = make_vectors(state.range(0));
+    for (auto _ : state) {
+        Vector3 s;
+        for (const Vector3& p : v) s = s + p;
+        bench::DoNotOptimize(s);
+    }
+    set_counters(state);
+}
+BENCHMARK(BM_SumLoop)->Arg(131072)->Arg(4194304)->UseRealTime();
+
+static void BM_ReduceSum(bench::State& state) {
+    auto v = make_vectors(state.range(0));
+    for (auto _ : state) bench::DoNotOptimize(geom::reduce_sum(v.data(), v.size(), state.range(1)));
+    set_counters(state);
+}
+BENCHMARK(BM_ReduceSum)->Apply(thread_counts)->UseRealTime();
+
+static void BM_ReduceBounds(bench::State& state) {
+    auto v = make_vectors(state.range(0));
+    for (auto _ : state) bench::DoNotOptimize(geom::reduce_bounds(v.data(), v.size(), state.range(1)));
+    set_counters(state);
+}
+BENCHMARK(BM_ReduceBounds)->Apply(thread_counts)->UseRealTime();
+
+static void BM_ReduceNormRange(bench::State& state) {
+    auto v = make_vectors(state.range(0));
+    for (auto _ : state) bench::DoNotOptimize(geom::reduce_norm_range(v.data(), v.size(), state.range(1)));
+    set_counters(state);
+}
+BENCHMARK(BM_ReduceNormRange)->Apply(thread_counts)->UseRealTime();
+
+static void BM_ReduceDot(bench::State& state) {
+    auto a = make_vectors(state.range(0)), b = make_vectors(state.range(0));
+    for (auto _ : state) bench::DoNotOptimize(geom::reduce_dot(a.data(), b.data(), a.size(), state.range(1)));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetBytesProcessed(state.iterations() * state.range(0) * 2 * sizeof(Vector3));
+}
+BENCHMARK(BM_ReduceDot)->Apply(thread_counts)->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,93 @@
+#include "benchmark.hpp"
+#include "../src/vector3_batch.hpp"
+#include <vector>
+
+// Compara el rendimiento de Vector3<T> para double, float y punto fijo.
+// Mide los kernels en bloque (SoA) y el ciclo clasico de operadores sobre
+// un arreglo de Vector3 (AoS). items/s es vectores por segundo.
+
+static const std::int64_t N = 1 << 16;
+
+template <typename T>
+static void fill(std::size_t n, geom::Vector3Batch<T>& a, geom::Vector3Batch<T>& b,
+                 std::vector<geom::Vector3<T>>& aos_a, std::vector<geom::Vector3<T>>& aos_b) {
+    for (std::size_t i = 0; i < n; i++) {
+        geom::Vector3<T> va(T(i % 100 * 0.5), T(1 + i % 7), T(2 - i % 13 * 0.25));
+        geom::Vector3<T> vb(T(3), T(i % 11 * 0.125), T(-1));
+        a.push_back(va);
+        b.push_back(vb);
+        aos_a.push_back(va);
+        aos_b.push_back(vb);
+    }
+}
+
+template <typename T>
+static void BM_TypeBatchCross(bench::State& state) {
+    std::size_t n = state.range(0);
+    geom::Vector3Batch<T> a, b, out(n);
+    std::vector<geom::Vector3<T>> aos_a, aos_b;
+    fill(n, a, b, aos_a, aos_b);
+    for (auto _ : state) {
+        batch_cross(a, b, out);
+        bench::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+template <typename T>
+static void BM_TypeBatchNorm(bench::State& state) {
+    std::size_t n = state.range(0);
+    geom::Vector3Batch<T> a, b;
+    std::vector<geom::Vector3<T>> aos_a, aos_b;
+    fill(n, a, b, aos_a, aos_b);
+    std::vector<T> out(n);
+    for (auto _ : state) {
+        batch_norm(a, out.data());
+        bench::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+template <typename T>
+static void BM_TypeCrossAoS(bench::State& state) {
+    std::size_t n = state.range(0);
+    geom::Vector3Batch<T> a, b;
+    std::vector<geom::Vector3<T>> aos_a, aos_b, out(n);
+    fill(n, a, b, aos_a, aos_b);
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < n; i++) out[i] = aos_a[i] * aos_b[i];
+        bench::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+template <typename T>
+static void BM_TypeNormAoS(bench::State& state) {
+    std::size_t n = state.range(0);
+    geom::Vector3Batch<T> a, b;
+    std::vector<geom::Vector3<T>> aos_a, aos_b;
+    fill(n, a, b, aos_a, aos_b);
+    std::vector<T> out(n);
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < n; i++) out[i] = &aos_a[i];
+        bench::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+using Fixed32 = geom::Fixed32;
+
+BENCHMARK_TEMPLATE(BM_TypeBatchCross, double)->Arg(N);
+BENCHMARK_TEMPLATE(BM_TypeBatchCross, float)->Arg(N);
+BENCHMARK_TEMPLATE(BM_TypeBatchCross, Fixed32)->Arg(N);
+BENCHMARK_TEMPLATE(BM_TypeBatchNorm, double)->Arg(N);
+BENCHMARK_TEMPLATE(BM_TypeBatchNorm, float)->Arg(N);
+BENCHMARK_TEMPLATE(BM_TypeBatchNorm, Fixed32)->Arg(N);
+BENCHMARK_TEMPLATE(BM_TypeCrossAoS, double)->Arg(N);
+BENCHMARK_TEMPLATE(BM_TypeCrossAoS, float)->Arg(N);
+BENCHMARK_TEMPLATE(BM_TypeCrossAoS, Fixed32)->Arg(N);
+BENCHMARK_TEMPLATE(BM_TypeNormAoS, double)->Arg(N);
+BENCHMARK_TEMPLATE(BM_TypeNormAoS, float)->Arg(N);
+BENCHMARK_TEMPLATE(BM_TypeNormAoS, Fixed32)->Arg(N);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,302 @@
+#ifndef BENCHMARK_HPP
+#define BENCHMARK_HPP
+
+// Mini framework de microbenchmarks con la misma forma que Google Benchmark:
+//
+//     static void BM_Suma(bench::State& state) {
+//         std::vector<Vector3> a(state.range(0));
+//         for (auto _ : state) { ... }
+//         state.SetItemsProcessed(state.iterations() * state.range(0));
+//     }
+//     BENCHMARK(BM_Suma)->Arg(512)->Arg(8192);
+//     BENCHMARK_MAIN();
+//
+// Opciones de linea de comandos (mismos nombres que Google Benchmark):
+//     --benchmark_filter=<texto>     solo corre los que contienen el texto
+//     --benchmark_min_time=<seg>     tiempo minimo por benchmark (0.5 por defecto)
+//     --benchmark_out=<archivo>      ademas escribe los resultados en JSON
+//
+// El JSON tiene el formato de Google Benchmark ("context" + "benchmarks"),
+// asi que sirve tanto para bench/compare.py como para las herramientas de
+// Google (tools/compare.py).
+//
+// Se usa un framework propio para no agregar dependencias al makefile.
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace bench {
+
+// Impide que el compilador elimine un valor calculado
+template <typename T>
+inline void DoNotOptimize(T const& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// Obliga a escribir en memoria todo lo pendiente
+inline void ClobberMemory() {
+    asm volatile("" : : : "memory");
+}
+
+// Estado de una corrida: da los argumentos y controla las iteraciones
+class State {
+public:
+    State(std::int64_t iterations, const std::vector<std::int64_t>& args)
+        : max_iterations_(iterations), args_(args) {}
+
+    std::int64_t range(std::size_t i = 0) const { return args_.at(i); }
+    std::int64_t iterations() const { return max_iterations_; }
+
+    void SetItemsProcessed(std::int64_t n) { items_ = n; }
+    void SetBytesProcessed(std::int64_t n) { bytes_ = n; }
+    void SetLabel(const std::string& label) { label_ = label; }
+
+    // Pausa el reloj (para preparar datos dentro del ciclo)
+    void PauseTiming() {
+        real_ += now_real() - real_start_;
+        cpu_ += now_cpu() - cpu_start_;
+    }
+    void ResumeTiming() {
+        real_start_ = now_real();
+        cpu_start_ = now_cpu();
+    }
+
+    // --- Soporte para "for (auto _ : state)" ---
+    struct Value {};
+    class Iterator {
+    public:
+        Iterator(State* s, std::int64_t left) : state_(s), left_(left) {}
+        Value operator*() const { return {}; }
+        Iterator& operator++() {
+            left_--;
+            return *this;
+        }
+        bool operator!=(const Iterator&) const {
+            if (left_ > 0) return true;
+            state_->finish();
+            return false;
+        }
+
+    private:
+        State* state_;
+        std::int64_t left_;
+    };
+
+    Iterator begin() {
+        ResumeTiming();
+        return Iterator(this, max_iterations_);
+    }
+    Iterator end() { return Iterator(this, 0); }
+
+    // Resultados (en segundos)
+    double real_seconds() const { return real_; }
+    double cpu_seconds() const { return cpu_; }
+    std::int64_t items() const { return items_; }
+    std::int64_t bytes() const { return bytes_; }
+    const std::string& label() const { return label_; }
+
+private:
+    static double now_real() {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+    static double now_cpu() {
+        timespec ts;
+        clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+        return ts.tv_sec + ts.tv_nsec * 1e-9;
+    }
+    void finish() { PauseTiming(); }
+
+    std::int64_t max_iterations_;
+    std::vector<std::int64_t> args_;
+    double real_ = 0, cpu_ = 0, real_start_ = 0, cpu_start_ = 0;
+    std::int64_t items_ = 0, bytes_ = 0;
+    std::string label_;
+};
+
+using Function = void (*)(State&);
+
+// Un benchmark registrado y la lista de argumentos con que se corre
+class Benchmark {
+public:
+    Benchmark(const char* name, Function fn) : name_(name), fn_(fn) {}
+
+    Benchmark* Arg(std::int64_t a) {
+        args_.push_back({a});
+        return this;
+    }
+    Benchmark* Args(const std::vector<std::int64_t>& a) {
+        args_.push_back(a);
+        return this;
+    }
+    // lo, lo*mult, lo*mult^2, ..., hi
+    Benchmark* Range(std::int64_t lo, std::int64_t hi, std::int64_t mult = 8) {
+        for (std::int64_t a = lo; a < hi; a *= mult) Arg(a);
+        return Arg(hi);
+    }
+    // Llama a fn(this) para agregar argumentos calculados en tiempo de ejecucion
+    Benchmark* Apply(void (*fn)(Benchmark*)) {
+        fn(this);
+        return this;
+    }
+    Benchmark* UseRealTime() {
+        real_time_ = true;
+        return this;
+    }
+
+    const std::string& name() const { return name_; }
+    Function function() const { return fn_; }
+    const std::vector<std::vector<std::int64_t>>& arg_sets() const { return args_; }
+    bool real_time() const { return real_time_; }
+
+private:
+    std::string name_;
+    Function fn_;
+    std::vector<std::vector<std::int64_t>> args_;
+    bool real_time_ = false;
+};
+
+inline std::vector<Benchmark*>& registry() {
+    static std::vector<Benchmark*> benchmarks;
+    return benchmarks;
+}
+
+inline Benchmark* Register(const char* name, Function fn) {
+    registry().push_back(new Benchmark(name, fn));
+    return registry().back();
+}
+
+// Resultado de una corrida ya calibrada
+struct Result {
+    std::string name;
+    std::int64_t iterations;
+    double real_ns, cpu_ns; // por iteracion
+    double items_per_second, bytes_per_second;
+    std::string label;
+};
+
+// Corre un benchmark con un juego de argumentos, subiendo las iteraciones
+// hasta que dure al menos min_time (igual que Google Benchmark)
+inline Result run_one(const Benchmark& b, const std::vector<std::int64_t>& args, double min_time) {
+    std::int64_t iters = 1;
+    while (true) {
+        State state(iters, args);
+        b.function()(state);
+        double t = b.real_time() ? state.real_seconds() : state.cpu_seconds();
+        if (t >= min_time || iters >= (std::int64_t(1) << 40)) {
+            Result r;
+            r.name = b.name();
+            for (std::int64_t a : args) r.name += "/" + std::to_string(a);
+            r.iterations = iters;
+            r.real_ns = state.real_seconds() * 1e9 / iters;
+            r.cpu_ns = state.cpu_seconds() * 1e9 / iters;
+            double secs = t > 0 ? t : 1e-9;
+            r.items_per_second = state.items() / secs;
+            r.bytes_per_second = state.bytes() / secs;
+            r.label = state.label();
+            return r;
+        }
+        // Estimamos cuantas iteraciones hacen falta (con 40% de margen)
+        double mult = t > 0 ? min_time * 1.4 / t : 10.0;
+        if (mult > 10.0 || t < min_time / 10) mult = 10.0;
+        std::int64_t next = static_cast<std::int64_t>(iters * mult);
+        iters = next > iters ? next : iters + 1;
+    }
+}
+
+inline std::string json_escape(const std::string& s) {
+    std::string out;
+    for (char c : s) {
+        if (c == '"' || c == '\\') out += '\\';
+        out += c;
+    }
+    return out;
+}
+
+inline void write_json(const char* path, const std::vector<Result>& results) {
+    FILE* f = std::fopen(path, "w");
+    if (!f) {
+        std::fprintf(stderr, "No se pudo abrir %s\n", path);
+        return;
+    }
+    char date[64];
+    std::time_t now = std::time(nullptr);
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+    std::fprintf(f, "{\n  \"context\": {\n");
+    std::fprintf(f, "    \"date\": \"%s\",\n", date);
+    std::fprintf(f, "    \"num_cpus\": %u,\n", std::thread::hardware_concurrency());
+    std::fprintf(f, "    \"library_build_type\": \"release\"\n  },\n");
+    std::fprintf(f, "  \"benchmarks\": [\n");
+    for (std::size_t i = 0; i < results.size(); i++) {
+        const Result& r = results[i];
+        std::fprintf(f, "    {\n");
+        std::fprintf(f, "      \"name\": \"%s\",\n", json_escape(r.name).c_str());
+        std::fprintf(f, "      \"run_name\": \"%s\",\n", json_escape(r.name).c_str());
+        std::fprintf(f, "      \"run_type\": \"iteration\",\n");
+        std::fprintf(f, "      \"iterations\": %lld,\n", static_cast<long long>(r.iterations));
+        std::fprintf(f, "      \"real_time\": %.6e,\n", r.real_ns);
+        std::fprintf(f, "      \"cpu_time\": %.6e,\n", r.cpu_ns);
+        std::fprintf(f, "      \"time_unit\": \"ns\"");
+        if (r.items_per_second > 0) std::fprintf(f, ",\n      \"items_per_second\": %.6e", r.items_per_second);
+        if (r.bytes_per_second > 0) std::fprintf(f, ",\n      \"bytes_per_second\": %.6e", r.bytes_per_second);
+        if (!r.label.empty()) std::fprintf(f, ",\n      \"label\": \"%s\"", json_escape(r.label).c_str());
+        std::fprintf(f, "\n    }%s\n", i + 1 < results.size() ? "," : "");
+    }
+    std::fprintf(f, "  ]\n}\n");
+    std::fclose(f);
+}
+
+// Corre todo lo registrado. Devuelve 0 si todo salio bien.
+inline int RunAll(int argc, char** argv) {
+    std::string filter, out;
+    double min_time = 0.5;
+    for (int i = 1; i < argc; i++) {
+        const char* a = argv[i];
+        if (std::strncmp(a, "--benchmark_filter=", 19) == 0) filter = a + 19;
+        else if (std::strncmp(a, "--benchmark_min_time=", 21) == 0) min_time = std::atof(a + 21);
+        else if (std::strncmp(a, "--benchmark_out=", 16) == 0) out = a + 16;
+        else {
+            std::fprintf(stderr, "Opcion desconocida: %s\n", a);
+            return 1;
+        }
+    }
+
+    std::vector<Result> results;
+    std::printf("%-48s %14s %14s %12s %14s\n", "Benchmark", "Time (ns)", "CPU (ns)", "Iterations", "items/s");
+    std::printf("%s\n", std::string(106, '-').c_str());
+    for (const Benchmark* b : registry()) {
+        std::vector<std::vector<std::int64_t>> sets = b->arg_sets();
+        if (sets.empty()) sets.push_back({});
+        for (const auto& args : sets) {
+            std::string full = b->name();
+            for (std::int64_t a : args) full += "/" + std::to_string(a);
+            if (!filter.empty() && full.find(filter) == std::string::npos) continue;
+            Result r = run_one(*b, args, min_time);
+            std::printf("%-48s %14.2f %14.2f %12lld %14.4g %s\n", r.name.c_str(), r.real_ns, r.cpu_ns,
+                        static_cast<long long>(r.iterations), r.items_per_second, r.label.c_str());
+            std::fflush(stdout);
+            results.push_back(r);
+        }
+    }
+    if (!out.empty()) write_json(out.c_str(), results);
+    return 0;
+}
+
+} // namespace bench
+
+#define BENCHMARK_CONCAT2(a, b) a##b
+#define BENCHMARK_CONCAT(a, b) BENCHMARK_CONCAT2(a, b)
+#define BENCHMARK(fn) \
+    static bench::Benchmark* BENCHMARK_CONCAT(bench_reg_, __LINE__) = bench::Register(#fn, fn)
+#define BENCHMARK_TEMPLATE(fn, T) \
+    static bench::Benchmark* BENCHMARK_CONCAT(bench_reg_, __LINE__) = bench::Register(#fn "<" #T ">", fn<T>)
+#define BENCHMARK_MAIN() \
+    int main(int argc, char** argv) { return bench::RunAll(argc, argv); }
+
+#endif
@@ -0,0 +1,36 @@
+#!/usr/bin/env python3
+"""Compara dos archivos JSON de benchmarks (formato Google Benchmark).
+
+Uso: python3 bench/compare.py viejo.json nuevo.json
+
+Muestra el tiempo de CPU por iteracion de cada benchmark en ambos archivos
+y el cambio relativo. Un cambio positivo significa que el nuevo es mas lento.
+"""
+import json
+import sys
+
+
+def load(path):
+    with open(path) as f:
+        data = json.load(f)
+    return {b["name"]: b for b in data["benchmarks"]}
+
+
+def main():
+    if len(sys.argv) != 3:
+        print(__doc__)
+        return 1
+    old, new = load(sys.argv[1]), load(sys.argv[2])
+    print("%-48s %14s %14s %9s" % ("Benchmark", "Viejo (ns)", "Nuevo (ns)", "Cambio"))
+    print("-" * 88)
+    for name in old:
+        if name not in new:
+            continue
+        t_old, t_new = old[name]["cpu_time"], new[name]["cpu_time"]
+        change = (t_new - t_old) / t_old * 100 if t_old else 0.0
+        print("%-48s %14.2f %14.2f %+8.1f%%" % (name, t_old, t_new, change))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
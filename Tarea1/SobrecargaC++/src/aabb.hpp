@@ -0,0 +1,57 @@
+#ifndef AABB_HPP
+#define AABB_HPP
+
+#include "vector3.hpp"
+
+namespace geom {
+
+// Caja alineada a los ejes (axis-aligned bounding box) dada por sus esquinas
+// minima y maxima. La caja vacia tiene min > max, asi cualquier punto que se
+// le agregue pasa a ser la caja entera.
+template <typename T>
+struct AABB {
+    using traits = Vector3Traits<T>;
+
+    Vector3<T> min, max;
+
+    // Caja vacia por defecto
+    constexpr AABB() noexcept
+        : min(traits::max_value(), traits::max_value(), traits::max_value()),
+          max(-traits::max_value(), -traits::max_value(), -traits::max_value()) {}
+
+    constexpr AABB(const Vector3<T>& lo, const Vector3<T>& hi) noexcept : min(lo), max(hi) {}
+
+    constexpr bool empty() const noexcept { return min.x > max.x || min.y > max.y || min.z > max.z; }
+
+    // Agranda la caja para incluir el punto p
+    constexpr void expand(const Vector3<T>& p) noexcept {
+        if (p.x < min.x) min.x = p.x;
+        if (p.y < min.y) min.y = p.y;
+        if (p.z < min.z) min.z = p.z;
+        if (p.x > max.x) max.x = p.x;
+        if (p.y > max.y) max.y = p.y;
+        if (p.z > max.z) max.z = p.z;
+    }
+
+    // Agranda la caja para incluir otra caja
+    constexpr void expand(const AABB& other) noexcept {
+        if (other.empty()) return;
+        expand(other.min);
+        expand(other.max);
+    }
+
+    // Verdadero si p esta dentro (los bordes cuentan como dentro)
+    constexpr bool contains(const Vector3<T>& p) const noexcept {
+        return p.x >= min.x && p.x <= max.x && p.y >= min.y && p.y <= max.y && p.z >= min.z && p.z <= max.z;
+    }
+
+    // Centro de la caja
+    constexpr Vector3<T> center() const noexcept { return (min + max) / T(2); }
+
+    // Largo de cada lado
+    constexpr Vector3<T> extent() const noexcept { return max - min; }
+};
+
+} // namespace geom
+
+#endif
@@ -0,0 +1,112 @@
+#ifndef FIXED_HPP
+#define FIXED_HPP
+
+#include <cstdint>      // Para int32_t, int64_t, INT32_MAX
+#include <iostream>     // Para std::ostream
+#include <type_traits>  // Para std::is_integral
+
+namespace geom {
+
+// Numero de punto fijo con signo: 32 bits en total y Frac bits de fraccion.
+// Con Frac = 16 (Q16.16) el rango es [-32768, 32768) con paso de 1/65536.
+// Pensado para consumidores embebidos sin FPU: todo es entero y constexpr.
+// No hay NaN ni infinito: dividir por cero satura (x / 0 es el maximo o el
+// minimo segun el signo de x, y 0 / 0 es 0).
+template <int Frac>
+class Fixed {
+public:
+    static_assert(Frac > 0 && Frac < 31, "Frac debe estar entre 1 y 30");
+    static constexpr std::int32_t one = std::int32_t(1) << Frac;
+
+    constexpr Fixed() noexcept : raw_(0) {}
+
+    // Conversion desde enteros y flotantes (redondea al mas cercano)
+    template <typename A, typename = typename std::enable_if<std::is_arithmetic<A>::value>::type>
+    constexpr Fixed(A v) noexcept : raw_(convert(v)) {}
+
+    // Construye desde la representacion cruda
+    static constexpr Fixed from_raw(std::int32_t r) noexcept {
+        Fixed f;
+        f.raw_ = r;
+        return f;
+    }
+
+    // Desde un valor crudo de 64 bits, recortado al rango de 32
+    static constexpr Fixed from_raw_saturated(std::int64_t r) noexcept {
+        return from_raw(r > INT32_MAX ? INT32_MAX : r < INT32_MIN ? INT32_MIN : static_cast<std::int32_t>(r));
+    }
+
+    constexpr std::int32_t raw() const noexcept { return raw_; }
+    constexpr double to_double() const noexcept { return static_cast<double>(raw_) / one; }
+    explicit constexpr operator double() const noexcept { return to_double(); }
+
+    // --- Aritmetica (los productos usan 64 bits intermedios) ---
+    constexpr Fixed operator+(Fixed o) const noexcept { return from_raw(raw_ + o.raw_); }
+    constexpr Fixed operator-(Fixed o) const noexcept { return from_raw(raw_ - o.raw_); }
+    constexpr Fixed operator-() const noexcept { return from_raw(-raw_); }
+    constexpr Fixed operator*(Fixed o) const noexcept {
+        return from_raw(static_cast<std::int32_t>((static_cast<std::int64_t>(raw_) * o.raw_) >> Frac));
+    }
+    constexpr Fixed operator/(Fixed o) const noexcept {
+        if (o.raw_ == 0) return from_raw(raw_ > 0 ? INT32_MAX : raw_ < 0 ? INT32_MIN : 0);
+        return from_raw_saturated((static_cast<std::int64_t>(raw_) * one) / o.raw_);
+    }
+
+    // --- Comparaciones ---
+    constexpr bool operator==(Fixed o) const noexcept { return raw_ == o.raw_; }
+    constexpr bool operator!=(Fixed o) const noexcept { return raw_ != o.raw_; }
+    constexpr bool operator<(Fixed o) const noexcept { return raw_ < o.raw_; }
+    constexpr bool operator>(Fixed o) const noexcept { return raw_ > o.raw_; }
+    constexpr bool operator<=(Fixed o) const noexcept { return raw_ <= o.raw_; }
+    constexpr bool operator>=(Fixed o) const noexcept { return raw_ >= o.raw_; }
+
+    friend std::ostream& operator<<(std::ostream& os, Fixed f) {
+        return os << f.to_double();
+    }
+
+private:
+    std::int32_t raw_;
+
+    template <typename A>
+    static constexpr std::int32_t convert(A v) noexcept {
+        if constexpr (std::is_integral<A>::value) {
+            return static_cast<std::int32_t>(static_cast<std::int64_t>(v) * one);
+        } else {
+            double scaled = static_cast<double>(v) * one;
+            return static_cast<std::int32_t>(scaled < 0 ? scaled - 0.5 : scaled + 0.5);
+        }
+    }
+};
+
+// Raiz cuadrada entera (piso) por el metodo de bits, valida en constexpr
+constexpr std::uint64_t isqrt(std::uint64_t v) noexcept {
+    std::uint64_t result = 0;
+    std::uint64_t bit = std::uint64_t(1) << 62;
+    while (bit > v) bit >>= 2;
+    while (bit != 0) {
+        if (v >= result + bit) {
+            v -= result + bit;
+            result = (result >> 1) + bit;
+        } else {
+            result >>= 1;
+        }
+        bit >>= 2;
+    }
+    return result;
+}
+
+// sqrt(raw / 2^F) = sqrt(raw * 2^F) / 2^F. Negativos devuelven 0; el
+// resultado se recorta al rango del formato.
+template <int Frac>
+constexpr Fixed<Frac> sqrt(Fixed<Frac> f) noexcept {
+    if (f.raw() <= 0) return Fixed<Frac>();
+    return Fixed<Frac>::from_raw_saturated(
+        static_cast<std::int64_t>(isqrt(static_cast<std::uint64_t>(f.raw()) << Frac)));
+}
+
+// Q16.16, el formato de punto fijo por defecto
+using Fixed32 = Fixed<16>;
+
+} // namespace geom
+
+#endif
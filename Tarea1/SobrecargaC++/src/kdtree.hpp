@@ -0,0 +1,245 @@
+#ifndef KDTREE_HPP
+#define KDTREE_HPP
+
+#include <algorithm>  // Para nth_element y las operaciones de heap
+#include <cstddef>    // Para std::size_t
+#include <cstdint>    // Para el eje de cada nodo
+#include <thread>     // Para la construccion y las consultas en paralelo
+#include <vector>     // Para los arreglos planos del arbol
+
+#include "aabb.hpp"
+#include "vector3.hpp"
+
+namespace geom {
+
+// Vecino encontrado: indice en el arreglo original y distancia al cuadrado
+template <typename T>
+struct Neighbor {
+    std::size_t index;
+    T dist_squared;
+
+    // Orden por distancia y, si empatan, por indice (asi el resultado no
+    // depende del orden en que se recorre el arbol)
+    bool operator<(const Neighbor& o) const {
+        return dist_squared < o.dist_squared || (dist_squared == o.dist_squared && index < o.index);
+    }
+};
+
+// Arbol k-d implicito sobre un conjunto fijo de puntos.
+//
+// No hay nodos con punteros: los puntos se copian a un arreglo y se
+// reordenan de modo que el rango [lo, hi) de cada subarbol quede contiguo,
+// con el punto de corte en mid = (lo + hi) / 2, la mitad izquierda antes y
+// la derecha despues. Por cada punto de corte se guarda solo el eje (1 byte).
+// Los rangos de hasta leaf_size puntos no se dividen y se recorren enteros.
+//
+// El eje de corte es el de mayor extension del rango, asi las nubes con
+// forma de placa o de linea no degeneran el arbol.
+template <typename T>
+class KdTree {
+public:
+    using value_type = T;
+    static constexpr std::size_t leaf_size = 8;
+
+    KdTree() = default;
+
+    // Construye el arbol sobre n puntos. threads = 0 usa todos los nucleos.
+    KdTree(const Vector3<T>* points, std::size_t n, unsigned threads = 0) { build(points, n, threads); }
+
+    void build(const Vector3<T>* points, std::size_t n, unsigned threads = 0) {
+        ids_.resize(n);
+        axis_.assign(n, 0);
+        for (std::size_t i = 0; i < n; i++) ids_[i] = i;
+        // Profundidad hasta la que se reparte el trabajo: 2^depth >= hilos
+        unsigned depth = 0;
+        for (unsigned t = resolve_threads(threads); (1u << depth) < t; depth++) {}
+        // Se ordenan solo los indices; los puntos se copian una vez al final
+        build_range(points, 0, n, depth);
+        pts_.resize(n);
+        for (std::size_t i = 0; i < n; i++) pts_[i] = points[ids_[i]];
+    }
+
+    std::size_t size() const { return pts_.size(); }
+    bool empty() const { return pts_.empty(); }
+
+    // Punto mas cercano a q. Con el arbol vacio devuelve {0, max_value}.
+    Neighbor<T> nearest(const Vector3<T>& q) const {
+        Neighbor<T> best{0, Vector3Traits<T>::max_value()};
+        knn(q, 1, &best);
+        return best;
+    }
+
+    // Los k vecinos mas cercanos de q, ordenados de mas cerca a mas lejos.
+    // out debe tener espacio para k; devuelve cuantos encontro (min(k, size())).
+    std::size_t knn(const Vector3<T>& q, std::size_t k, Neighbor<T>* out) const {
+        if (k == 0 || empty()) return 0;
+        std::size_t count = 0;
+        knn_range(0, pts_.size(), q, k, out, count);
+        std::sort_heap(out, out + count);
+        return count;
+    }
+
+    void knn(const Vector3<T>& q, std::size_t k, std::vector<Neighbor<T>>& out) const {
+        out.resize(k < size() ? k : size());
+        knn(q, k, out.data());
+    }
+
+    // Agrega a out los indices de los puntos a distancia <= r de q
+    void radius(const Vector3<T>& q, T r, std::vector<std::size_t>& out) const {
+        if (!empty()) radius_range(0, pts_.size(), q, r * r, out);
+    }
+
+    // Agrega a out los indices de los puntos dentro de la caja (bordes incluidos)
+    void box(const AABB<T>& b, std::vector<std::size_t>& out) const {
+        if (!empty() && !b.empty()) box_range(0, pts_.size(), b, out);
+    }
+
+    // --- Consultas en bloque (repartidas entre hilos) ---
+
+    // k vecinos de cada una de las m consultas: out[j * k ... j * k + k) son
+    // los de queries[j]. Si el arbol tiene menos de k puntos, el resto queda
+    // en {0, max_value}.
+    void knn_batch(const Vector3<T>* queries, std::size_t m, std::size_t k, Neighbor<T>* out,
+                   unsigned threads = 0) const {
+        parallel_for(m, threads, [&](std::size_t j) {
+            Neighbor<T>* row = out + j * k;
+            std::size_t found = knn(queries[j], k, row);
+            for (std::size_t c = found; c < k; c++) row[c] = {0, Vector3Traits<T>::max_value()};
+        });
+    }
+
+    // Puntos a distancia <= r de cada consulta (out[j] para queries[j])
+    void radius_batch(const Vector3<T>* queries, std::size_t m, T r, std::vector<std::vector<std::size_t>>& out,
+                      unsigned threads = 0) const {
+        out.resize(m);
+        parallel_for(m, threads, [&](std::size_t j) {
+            out[j].clear();
+            radius(queries[j], r, out[j]);
+        });
+    }
+
+private:
+    static T comp(const Vector3<T>& v, unsigned axis) { return axis == 0 ? v.x : axis == 1 ? v.y : v.z; }
+
+    static unsigned resolve_threads(unsigned threads) {
+        if (threads == 0) threads = std::thread::hardware_concurrency();
+        return threads == 0 ? 1 : threads;
+    }
+
+    // Ordena ids_[lo, hi) para que quede el subarbol. Mientras depth > 0 la
+    // mitad izquierda se arma en otro hilo (los rangos no se tocan entre si).
+    void build_range(const Vector3<T>* points, std::size_t lo, std::size_t hi, unsigned depth) {
+        if (hi - lo <= leaf_size) return;
+        AABB<T> bounds;
+        for (std::size_t i = lo; i < hi; i++) bounds.expand(points[ids_[i]]);
+        const Vector3<T> ext = bounds.extent();
+        const unsigned axis = ext.x >= ext.y && ext.x >= ext.z ? 0 : ext.y >= ext.z ? 1 : 2;
+
+        const std::size_t mid = lo + (hi - lo) / 2;
+        std::nth_element(ids_.begin() + lo, ids_.begin() + mid, ids_.begin() + hi,
+                         [&](std::size_t a, std::size_t b) {
+                             T ca = comp(points[a], axis), cb = comp(points[b], axis);
+                             return ca < cb || (ca == cb && a < b);
+                         });
+        axis_[mid] = static_cast<std::uint8_t>(axis);
+
+        if (depth > 0) {
+            std::thread left([=] { build_range(points, lo, mid, depth - 1); });
+            build_range(points, mid + 1, hi, depth - 1);
+            left.join();
+        } else {
+            build_range(points, lo, mid, 0);
+            build_range(points, mid + 1, hi, 0);
+        }
+    }
+
+    // Mete el punto i en el heap de los k mejores (la raiz es el peor)
+    void offer(std::size_t i, const Vector3<T>& q, std::size_t k, Neighbor<T>* heap, std::size_t& count) const {
+        Neighbor<T> cand{ids_[i], (pts_[i] - q).norm_squared()};
+        if (count < k) {
+            heap[count++] = cand;
+            std::push_heap(heap, heap + count);
+        } else if (cand < heap[0]) {
+            std::pop_heap(heap, heap + count);
+            heap[count - 1] = cand;
+            std::push_heap(heap, heap + count);
+        }
+    }
+
+    void knn_range(std::size_t lo, std::size_t hi, const Vector3<T>& q, std::size_t k, Neighbor<T>* heap,
+                   std::size_t& count) const {
+        if (hi - lo <= leaf_size) {
+            for (std::size_t i = lo; i < hi; i++) offer(i, q, k, heap, count);
+            return;
+        }
+        const std::size_t mid = lo + (hi - lo) / 2;
+        const unsigned axis = axis_[mid];
+        const T diff = comp(q, axis) - comp(pts_[mid], axis);
+        offer(mid, q, k, heap, count);
+        // Primero el lado donde cae q; el otro solo si el plano esta mas
+        // cerca que el peor vecino que tenemos
+        if (diff < T(0)) {
+            knn_range(lo, mid, q, k, heap, count);
+            if (count < k || diff * diff <= heap[0].dist_squared) knn_range(mid + 1, hi, q, k, heap, count);
+        } else {
+            knn_range(mid + 1, hi, q, k, heap, count);
+            if (count < k || diff * diff <= heap[0].dist_squared) knn_range(lo, mid, q, k, heap, count);
+        }
+    }
+
+    void radius_range(std::size_t lo, std::size_t hi, const Vector3<T>& q, T r2, std::vector<std::size_t>& out) const {
+        if (hi - lo <= leaf_size) {
+            for (std::size_t i = lo; i < hi; i++) {
+                if ((pts_[i] - q).norm_squared() <= r2) out.push_back(ids_[i]);
+            }
+            return;
+        }
+        const std::size_t mid = lo + (hi - lo) / 2;
+        const unsigned axis = axis_[mid];
+        const T diff = comp(q, axis) - comp(pts_[mid], axis);
+        if ((pts_[mid] - q).norm_squared() <= r2) out.push_back(ids_[mid]);
+        if (diff <= T(0) || diff * diff <= r2) radius_range(lo, mid, q, r2, out);
+        if (diff >= T(0) || diff * diff <= r2) radius_range(mid + 1, hi, q, r2, out);
+    }
+
+    void box_range(std::size_t lo, std::size_t hi, const AABB<T>& b, std::vector<std::size_t>& out) const {
+        if (hi - lo <= leaf_size) {
+            for (std::size_t i = lo; i < hi; i++) {
+                if (b.contains(pts_[i])) out.push_back(ids_[i]);
+            }
+            return;
+        }
+        const std::size_t mid = lo + (hi - lo) / 2;
+        const unsigned axis = axis_[mid];
+        const T split = comp(pts_[mid], axis);
+        if (b.contains(pts_[mid])) out.push_back(ids_[mid]);
+        if (comp(b.min, axis) <= split) box_range(lo, mid, b, out);
+        if (comp(b.max, axis) >= split) box_range(mid + 1, hi, b, out);
+    }
+
+    // Llama a fn(j) para j en [0, m), en tramos contiguos por hilo
+    template <typename Fn>
+    static void parallel_for(std::size_t m, unsigned threads, const Fn& fn) {
+        unsigned t = resolve_threads(threads);
+        if (t > m) t = static_cast<unsigned>(m);
+        if (t <= 1) {
+            for (std::size_t j = 0; j < m; j++) fn(j);
+            return;
+        }
+        auto work = [&](std::size_t j0, std::size_t j1) {
+            for (std::size_t j = j0; j < j1; j++) fn(j);
+        };
+        std::vector<std::thread> pool;
+        for (unsigned w = 1; w < t; w++) pool.emplace_back(work, m * w / t, m * (w + 1) / t);
+        work(0, m / t);
+        for (std::thread& th : pool) th.join();
+    }
+
+    std::vector<Vector3<T>> pts_;   // Puntos reordenados
+    std::vector<std::size_t> ids_;  // Indice original de cada punto
+    std::vector<std::uint8_t> axis_; // Eje de corte (solo en los mid)
+};
+
+} // namespace geom
+
+#endif
@@ -0,0 +1,329 @@
+#ifndef TRANSFORM_HPP
+#define TRANSFORM_HPP
+
+#include <cmath>      // Para sin, cos y tan al armar rotaciones
+#include <cstddef>    // Para std::size_t
+
+#include "vector3.hpp"
+#include "vector3_batch.hpp"
+#include "vector3_simd.hpp"
+
+// Transformaciones sobre Vector3: matrices 3x3 y 4x4 (por filas) y
+// cuaterniones. Igual que Vector3, son plantillas sobre el tipo de
+// componente. Los angulos van en radianes; las funciones que usan seno y
+// coseno calculan en double y convierten a T (asi sirven tambien con Fixed).
+//
+// Al final estan los kernels que aplican una misma transformacion a todo un
+// Vector3Batch con Pack<T>.
+
+namespace geom {
+
+// --- Matriz 3x3 ---
+// Sirve para rotaciones, escalas y cualquier transformacion lineal.
+// El constructor por defecto da la identidad.
+template <typename T>
+class Mat3 {
+public:
+    using value_type = T;
+    using traits = Vector3Traits<T>;
+
+    T m[3][3]; // m[fila][columna]
+
+    constexpr Mat3() noexcept : m{{T(1), T(0), T(0)}, {T(0), T(1), T(0)}, {T(0), T(0), T(1)}} {}
+
+    // Los 9 valores por filas
+    constexpr Mat3(T m00, T m01, T m02, T m10, T m11, T m12, T m20, T m21, T m22) noexcept
+        : m{{m00, m01, m02}, {m10, m11, m12}, {m20, m21, m22}} {}
+
+    static constexpr Mat3 identity() noexcept { return Mat3(); }
+
+    static constexpr Mat3 scale(T sx, T sy, T sz) noexcept {
+        return {sx, T(0), T(0), T(0), sy, T(0), T(0), T(0), sz};
+    }
+
+    // Rotacion de angle radianes alrededor de axis (no hace falta que sea unitario)
+    static Mat3 rotation(const Vector3<T>& axis, T angle) noexcept {
+        const Vector3<T> u = axis.normalized();
+        const double a = static_cast<double>(angle);
+        const T c = T(std::cos(a)), s = T(std::sin(a)), t = T(1) - c;
+        return {t * u.x * u.x + c,       t * u.x * u.y - s * u.z, t * u.x * u.z + s * u.y,
+                t * u.x * u.y + s * u.z, t * u.y * u.y + c,       t * u.y * u.z - s * u.x,
+                t * u.x * u.z - s * u.y, t * u.y * u.z + s * u.x, t * u.z * u.z + c};
+    }
+
+    // Matriz por vector: (m * v).x = fila 0 % v, etc.
+    constexpr Vector3<T> operator*(const Vector3<T>& v) const noexcept {
+        return {m[0][0] * v.x + m[0][1] * v.y + m[0][2] * v.z,
+                m[1][0] * v.x + m[1][1] * v.y + m[1][2] * v.z,
+                m[2][0] * v.x + m[2][1] * v.y + m[2][2] * v.z};
+    }
+
+    // Composicion: (a * b) * v == a * (b * v)
+    constexpr Mat3 operator*(const Mat3& o) const noexcept {
+        Mat3 r;
+        for (int i = 0; i < 3; i++) {
+            for (int j = 0; j < 3; j++) {
+                r.m[i][j] = m[i][0] * o.m[0][j] + m[i][1] * o.m[1][j] + m[i][2] * o.m[2][j];
+            }
+        }
+        return r;
+    }
+
+    constexpr Mat3 transpose() const noexcept {
+        return {m[0][0], m[1][0], m[2][0], m[0][1], m[1][1], m[2][1], m[0][2], m[1][2], m[2][2]};
+    }
+
+    constexpr T determinant() const noexcept {
+        return m[0][0] * (m[1][1] * m[2][2] - m[1][2] * m[2][1]) -
+               m[0][1] * (m[1][0] * m[2][2] - m[1][2] * m[2][0]) +
+               m[0][2] * (m[1][0] * m[2][1] - m[1][1] * m[2][0]);
+    }
+
+    constexpr bool equals(const Mat3& o, T eps = traits::default_eps()) const noexcept {
+        for (int i = 0; i < 3; i++) {
+            for (int j = 0; j < 3; j++) {
+                if (!(Vector3<T>::abs_constexpr(m[i][j] - o.m[i][j]) < eps)) return false;
+            }
+        }
+        return true;
+    }
+};
+
+// --- Cuaternion ---
+// q = w + xi + yj + zk. Para rotar debe ser unitario (from_axis_angle ya lo da
+// asi; despues de muchas composiciones conviene llamar a normalized()).
+// El constructor por defecto da la rotacion identidad.
+template <typename T>
+class Quat {
+public:
+    using value_type = T;
+    using traits = Vector3Traits<T>;
+
+    T w, x, y, z;
+
+    constexpr Quat() noexcept : w(1), x(0), y(0), z(0) {}
+    constexpr Quat(T w_, T x_, T y_, T z_) noexcept : w(w_), x(x_), y(y_), z(z_) {}
+
+    static constexpr Quat identity() noexcept { return Quat(); }
+
+    // Rotacion de angle radianes alrededor de axis (no hace falta que sea unitario)
+    static Quat from_axis_angle(const Vector3<T>& axis, T angle) noexcept {
+        const Vector3<T> u = axis.normalized();
+        const double half = static_cast<double>(angle) * 0.5;
+        const T s = T(std::sin(half));
+        return {T(std::cos(half)), u.x * s, u.y * s, u.z * s};
+    }
+
+    // Producto de Hamilton: (a * b).rotate(v) == a.rotate(b.rotate(v))
+    constexpr Quat operator*(const Quat& o) const noexcept {
+        return {w * o.w - x * o.x - y * o.y - z * o.z,
+                w * o.x + x * o.w + y * o.z - z * o.y,
+                w * o.y - x * o.z + y * o.w + z * o.x,
+                w * o.z + x * o.y - y * o.x + z * o.w};
+    }
+
+    // Conjugado: para un cuaternion unitario es la rotacion inversa
+    constexpr Quat conjugate() const noexcept { return {w, -x, -y, -z}; }
+
+    constexpr T norm_squared() const noexcept { return w * w + x * x + y * y + z * z; }
+
+    Quat normalized() const noexcept {
+        using std::sqrt;
+        const T inv = T(1) / sqrt(norm_squared());
+        return {w * inv, x * inv, y * inv, z * inv};
+    }
+
+    // Rota v: v + w*t + u x t con t = 2 (u x v) y u = (x, y, z).
+    // Son dos productos cruz en vez del q * v * q^-1 completo.
+    constexpr Vector3<T> rotate(const Vector3<T>& v) const noexcept {
+        const Vector3<T> u(x, y, z);
+        const Vector3<T> t = (u * v) * T(2);
+        return v + t * w + u * t;
+    }
+
+    // Matriz de rotacion equivalente (para rotar muchos vectores es mas barata)
+    constexpr Mat3<T> to_mat3() const noexcept {
+        const T xx = x * x, yy = y * y, zz = z * z;
+        const T xy = x * y, xz = x * z, yz = y * z;
+        const T wx = w * x, wy = w * y, wz = w * z;
+        return {T(1) - T(2) * (yy + zz), T(2) * (xy - wz),         T(2) * (xz + wy),
+                T(2) * (xy + wz),         T(1) - T(2) * (xx + zz), T(2) * (yz - wx),
+                T(2) * (xz - wy),         T(2) * (yz + wx),         T(1) - T(2) * (xx + yy)};
+    }
+
+    constexpr bool equals(const Quat& o, T eps = traits::default_eps()) const noexcept {
+        return Vector3<T>::abs_constexpr(w - o.w) < eps && Vector3<T>::abs_constexpr(x - o.x) < eps &&
+               Vector3<T>::abs_constexpr(y - o.y) < eps && Vector3<T>::abs_constexpr(z - o.z) < eps;
+    }
+};
+
+// --- Matriz 4x4 ---
+// Transformaciones afines (rotacion + escala + traslacion) y proyecciones.
+// Los Vector3 se tratan como puntos (w = 1) o direcciones (w = 0).
+// El constructor por defecto da la identidad.
+template <typename T>
+class Mat4 {
+public:
+    using value_type = T;
+    using traits = Vector3Traits<T>;
+
+    T m[4][4]; // m[fila][columna]
+
+    constexpr Mat4() noexcept
+        : m{{T(1), T(0), T(0), T(0)}, {T(0), T(1), T(0), T(0)}, {T(0), T(0), T(1), T(0)}, {T(0), T(0), T(0), T(1)}} {}
+
+    // Parte lineal l y traslacion t: p -> l * p + t
+    explicit constexpr Mat4(const Mat3<T>& l, const Vector3<T>& t = Vector3<T>()) noexcept
+        : m{{l.m[0][0], l.m[0][1], l.m[0][2], t.x},
+            {l.m[1][0], l.m[1][1], l.m[1][2], t.y},
+            {l.m[2][0], l.m[2][1], l.m[2][2], t.z},
+            {T(0), T(0), T(0), T(1)}} {}
+
+    static constexpr Mat4 identity() noexcept { return Mat4(); }
+
+    static constexpr Mat4 translation(const Vector3<T>& t) noexcept { return Mat4(Mat3<T>(), t); }
+
+    static constexpr Mat4 scale(T sx, T sy, T sz) noexcept { return Mat4(Mat3<T>::scale(sx, sy, sz)); }
+
+    // Proyeccion en perspectiva estilo OpenGL (la camara mira hacia -z y el
+    // volumen visible queda en el cubo [-1, 1]^3)
+    static Mat4 perspective(T fovy, T aspect, T z_near, T z_far) noexcept {
+        const T f = T(1.0 / std::tan(static_cast<double>(fovy) * 0.5));
+        Mat4 r;
+        r.m[0][0] = f / aspect;
+        r.m[1][1] = f;
+        r.m[2][2] = (z_far + z_near) / (z_near - z_far);
+        r.m[2][3] = T(2) * z_far * z_near / (z_near - z_far);
+        r.m[3][2] = T(-1);
+        r.m[3][3] = T(0);
+        return r;
+    }
+
+    // Verdadero si la ultima fila es (0, 0, 0, 1): no hace falta dividir por w
+    constexpr bool is_affine() const noexcept {
+        return m[3][0] == T(0) && m[3][1] == T(0) && m[3][2] == T(0) && m[3][3] == T(1);
+    }
+
+    // Transforma un punto (w = 1). Si la matriz no es afin divide por w.
+    constexpr Vector3<T> transform_point(const Vector3<T>& p) const noexcept {
+        const Vector3<T> r(m[0][0] * p.x + m[0][1] * p.y + m[0][2] * p.z + m[0][3],
+                           m[1][0] * p.x + m[1][1] * p.y + m[1][2] * p.z + m[1][3],
+                           m[2][0] * p.x + m[2][1] * p.y + m[2][2] * p.z + m[2][3]);
+        if (is_affine()) return r;
+        return r / (m[3][0] * p.x + m[3][1] * p.y + m[3][2] * p.z + m[3][3]);
+    }
+
+    // Transforma una direccion (w = 0): no le afecta la traslacion
+    constexpr Vector3<T> transform_direction(const Vector3<T>& d) const noexcept {
+        return {m[0][0] * d.x + m[0][1] * d.y + m[0][2] * d.z,
+                m[1][0] * d.x + m[1][1] * d.y + m[1][2] * d.z,
+                m[2][0] * d.x + m[2][1] * d.y + m[2][2] * d.z};
+    }
+
+    // Composicion: (a * b).transform_point(p) == a.transform_point(b.transform_point(p))
+    // (para matrices afines; con proyecciones la division se hace una vez al final)
+    constexpr Mat4 operator*(const Mat4& o) const noexcept {
+        Mat4 r;
+        for (int i = 0; i < 4; i++) {
+            for (int j = 0; j < 4; j++) {
+                r.m[i][j] = m[i][0] * o.m[0][j] + m[i][1] * o.m[1][j] + m[i][2] * o.m[2][j] + m[i][3] * o.m[3][j];
+            }
+        }
+        return r;
+    }
+
+    constexpr bool equals(const Mat4& o, T eps = traits::default_eps()) const noexcept {
+        for (int i = 0; i < 4; i++) {
+            for (int j = 0; j < 4; j++) {
+                if (!(Vector3<T>::abs_constexpr(m[i][j] - o.m[i][j]) < eps)) return false;
+            }
+        }
+        return true;
+    }
+};
+
+// --- Kernels en bloque ---
+// Igual que los de vector3_batch.hpp: de a Pack<T>::width vectores, cola
+// escalar con los metodos de arriba y mismo orden de operaciones. La salida
+// puede ser la misma que la entrada. Los coeficientes de la matriz se
+// cargan en registros una sola vez, fuera del ciclo.
+
+// Cuantos bytes por delante se piden a cache en cada arreglo de componentes.
+// Cerca del final del lote no se pide nada, para no salir del arreglo.
+constexpr std::size_t transform_prefetch_bytes = 512;
+
+// out[i] = m * a[i]
+template <typename T>
+void batch_transform(const Mat3<T>& m, const Vector3Batch<T>& a, Vector3Batch<T>& out) {
+    using P = simd::Pack<T>;
+    const std::size_t n = a.size();
+    out.resize(n);
+    const std::size_t ahead = transform_prefetch_bytes / sizeof(T);
+    const P m00 = P::broadcast(m.m[0][0]), m01 = P::broadcast(m.m[0][1]), m02 = P::broadcast(m.m[0][2]);
+    const P m10 = P::broadcast(m.m[1][0]), m11 = P::broadcast(m.m[1][1]), m12 = P::broadcast(m.m[1][2]);
+    const P m20 = P::broadcast(m.m[2][0]), m21 = P::broadcast(m.m[2][1]), m22 = P::broadcast(m.m[2][2]);
+    std::size_t i = 0;
+    for (; i < simd_end<P>(n); i += P::width) {
+        if (i + ahead < n) {
+            simd::prefetch(a.x() + i + ahead);
+            simd::prefetch(a.y() + i + ahead);
+            simd::prefetch(a.z() + i + ahead);
+        }
+        P x = P::load(a.x() + i), y = P::load(a.y() + i), z = P::load(a.z() + i);
+        (m00 * x + m01 * y + m02 * z).store(out.x() + i);
+        (m10 * x + m11 * y + m12 * z).store(out.y() + i);
+        (m20 * x + m21 * y + m22 * z).store(out.z() + i);
+    }
+    for (; i < n; i++) {
+        out.set(i, m * a.get(i));
+    }
+}
+
+// out[i] = q.rotate(a[i]). Se pasa a matriz una vez (9 mul + 6 sumas por
+// vector en vez de 15 + 15), asi que equivale a q.to_mat3() * a[i].
+template <typename T>
+void batch_rotate(const Quat<T>& q, const Vector3Batch<T>& a, Vector3Batch<T>& out) {
+    batch_transform(q.to_mat3(), a, out);
+}
+
+// out[i] = m.transform_point(a[i]). Si la matriz es afin no se divide por w.
+template <typename T>
+void batch_transform_point(const Mat4<T>& m, const Vector3Batch<T>& a, Vector3Batch<T>& out) {
+    using P = simd::Pack<T>;
+    const std::size_t n = a.size();
+    out.resize(n);
+    const std::size_t ahead = transform_prefetch_bytes / sizeof(T);
+    const bool affine = m.is_affine();
+    P r[4][4];
+    for (int row = 0; row < 4; row++) {
+        for (int col = 0; col < 4; col++) r[row][col] = P::broadcast(m.m[row][col]);
+    }
+    std::size_t i = 0;
+    for (; i < simd_end<P>(n); i += P::width) {
+        if (i + ahead < n) {
+            simd::prefetch(a.x() + i + ahead);
+            simd::prefetch(a.y() + i + ahead);
+            simd::prefetch(a.z() + i + ahead);
+        }
+        P x = P::load(a.x() + i), y = P::load(a.y() + i), z = P::load(a.z() + i);
+        P ox = r[0][0] * x + r[0][1] * y + r[0][2] * z + r[0][3];
+        P oy = r[1][0] * x + r[1][1] * y + r[1][2] * z + r[1][3];
+        P oz = r[2][0] * x + r[2][1] * y + r[2][2] * z + r[2][3];
+        if (!affine) {
+            P w = r[3][0] * x + r[3][1] * y + r[3][2] * z + r[3][3];
+            ox = ox / w;
+            oy = oy / w;
+            oz = oz / w;
+        }
+        ox.store(out.x() + i);
+        oy.store(out.y() + i);
+        oz.store(out.z() + i);
+    }
+    for (; i < n; i++) {
+        out.set(i, m.transform_point(a.get(i)));
+    }
+}
+
+} // namespace geom
+
+#endif
@@ -2,50 +2,134 @@
 #define VECTOR3_HPP
 
 #include <cmath>      // Para funciones matematicas como sqrt y fabs
+#include <cstdint>    // Para int64_t en la norma de punto fijo
 #include <iostream>   // Para std::ostream
+#include <limits>     // Para quiet_NaN e infinity en sqrt_constexpr
+
+#include "fixed.hpp"
+#include "vector3_simd.hpp"
+
+namespace geom {
+
+// --- Rasgos por tipo de componente ---
+// Cada tipo define su tolerancia por defecto para equals, el mayor valor
+// representable (max_value, infinito en flotantes) y como se calcula la norma
+// (en tiempo de ejecucion y en constexpr).
+
+// Raiz cuadrada por Newton-Raphson para flotantes, valida en tiempo de compilacion.
+// Arranca desde un valor >= sqrt(v) y baja hasta que deja de mejorar.
+template <typename F>
+constexpr F sqrt_newton(F v) noexcept {
+    if (!(v >= 0)) return std::numeric_limits<F>::quiet_NaN(); // negativos y NaN
+    if (v == 0 || v == std::numeric_limits<F>::infinity()) return v;
+    F r = v > 1 ? v : F(1);
+    while (true) {
+        F next = F(0.5) * (r + v / r);
+        if (next >= r) return r;
+        r = next;
+    }
+}
+
+template <typename T>
+struct Vector3Traits;
+
+template <>
+struct Vector3Traits<double> {
+    static constexpr double default_eps() noexcept { return 1e-6; }
+    static constexpr double max_value() noexcept { return std::numeric_limits<double>::infinity(); }
+    static double norm(double x, double y, double z) noexcept { return std::sqrt(x * x + y * y + z * z); }
+    static constexpr double sqrt_constexpr(double v) noexcept { return sqrt_newton(v); }
+    static constexpr double norm_constexpr(double x, double y, double z) noexcept {
+        return sqrt_newton(x * x + y * y + z * z);
+    }
+    static double rsqrt_approx(double v) noexcept { return simd::rsqrt_approx(v); }
+};
 
-// Clase que representa un vector en 3D
+// float tiene ~7 digitos: 1e-4 es el equivalente razonable del 1e-6 de double
+template <>
+struct Vector3Traits<float> {
+    static constexpr float default_eps() noexcept { return 1e-4f; }
+    static constexpr float max_value() noexcept { return std::numeric_limits<float>::infinity(); }
+    static float norm(float x, float y, float z) noexcept { return std::sqrt(x * x + y * y + z * z); }
+    static constexpr float sqrt_constexpr(float v) noexcept { return sqrt_newton(v); }
+    static constexpr float norm_constexpr(float x, float y, float z) noexcept {
+        return sqrt_newton(x * x + y * y + z * z);
+    }
+    static float rsqrt_approx(float v) noexcept { return simd::rsqrt_approx(v); }
+};
+
+// Punto fijo: la tolerancia es de unos pocos pasos del formato y la norma
+// suma los cuadrados en 64 bits, asi no desborda aunque x*x no entre en 32.
+// Si la norma no entra en el formato (|v| >= 32768 en Q16.16) satura en
+// max_value().
+template <int Frac>
+struct Vector3Traits<Fixed<Frac>> {
+    using F = Fixed<Frac>;
+    static constexpr F default_eps() noexcept { return F::from_raw(4); }
+    static constexpr F max_value() noexcept { return F::from_raw(std::numeric_limits<std::int32_t>::max()); }
+    static constexpr F sqrt_constexpr(F v) noexcept { return sqrt(v); }
+    static constexpr F norm_constexpr(F x, F y, F z) noexcept {
+        std::uint64_t sum = static_cast<std::uint64_t>(static_cast<std::int64_t>(x.raw()) * x.raw()) +
+                            static_cast<std::uint64_t>(static_cast<std::int64_t>(y.raw()) * y.raw()) +
+                            static_cast<std::uint64_t>(static_cast<std::int64_t>(z.raw()) * z.raw());
+        // sum esta en formato Q(2*Frac): su raiz entera ya queda en Q(Frac)
+        return F::from_raw_saturated(static_cast<std::int64_t>(isqrt(sum)));
+    }
+    static constexpr F norm(F x, F y, F z) noexcept { return norm_constexpr(x, y, z); }
+    // Sin instruccion rsqrt para enteros: el camino "rapido" es el exacto
+    static constexpr F rsqrt_approx(F v) noexcept { return F(1) / sqrt(v); }
+};
+
+// Clase que representa un vector en 3D con componentes de tipo T
+// (double, float o Fixed). Todo es constexpr y noexcept (menos operator& y
+// operator<<, que usan la biblioteca en tiempo de ejecucion), asi se pueden
+// armar tablas de vectores en tiempo de compilacion. Para la norma en
+// constexpr usar norm_constexpr().
+template <typename T>
 class Vector3 {
 public:
-    double x, y, z; // Componentes del vector
+    using value_type = T;
+    using traits = Vector3Traits<T>;
+
+    T x, y, z; // Componentes del vector
 
     // Constructor por defecto: inicializa todo en 0
-    Vector3() : x(0), y(0), z(0) {}
+    constexpr Vector3() noexcept : x(0), y(0), z(0) {}
 
     // Constructor con parametros
-    Vector3(double x_, double y_, double z_) : x(x_), y(y_), z(z_) {}
+    constexpr Vector3(T x_, T y_, T z_) noexcept : x(x_), y(y_), z(z_) {}
 
     // --- Operaciones con escalares (solo por la derecha) ---
 
     // Suma escalar: suma un escalar a cada componente
-    Vector3 operator+(double scalar) const {
+    constexpr Vector3 operator+(T scalar) const noexcept {
         return {x + scalar, y + scalar, z + scalar};
     }
 
     // Multiplicacion escalar: multiplica cada componente por un escalar
-    Vector3 operator*(double scalar) const {
+    constexpr Vector3 operator*(T scalar) const noexcept {
         return {x * scalar, y * scalar, z * scalar};
     }
 
     // Division escalar: divide cada componente por un escalar
-    Vector3 operator/(double scalar) const {
+    constexpr Vector3 operator/(T scalar) const noexcept {
         return {x / scalar, y / scalar, z / scalar};
     }
 
     // Resta escalar: resta un escalar a cada componente
-    Vector3 operator-(double scalar) const {
+    constexpr Vector3 operator-(T scalar) const noexcept {
         return {x - scalar, y - scalar, z - scalar};
     }
 
     // --- Operaciones entre vectores ---
 
     // Suma vectorial: suma componente a componente
-    Vector3 operator+(const Vector3& other) const {
+    constexpr Vector3 operator+(const Vector3& other) const noexcept {
         return {x + other.x, y + other.y, z + other.z};
     }
 
     // Producto cruz (operador *): calcula el producto vectorial
-    Vector3 operator*(const Vector3& other) const {
+    constexpr Vector3 operator*(const Vector3& other) const noexcept {
         return {
             y * other.z - z * other.y,
             z * other.x - x * other.z,
@@ -54,27 +138,73 @@ public:
     }
 
     // Resta vectorial: resta componente a componente
-    Vector3 operator-(const Vector3& other) const {
+    constexpr Vector3 operator-(const Vector3& other) const noexcept {
         return {x - other.x, y - other.y, z - other.z};
     }
 
     // Producto punto (operador %): calcula el producto escalar
-    double operator%(const Vector3& other) const {
+    constexpr T operator%(const Vector3& other) const noexcept {
         return x * other.x + y * other.y + z * other.z;
     }
 
     // Norma (operador &): calcula la magnitud del vector
-    double operator&() const {
-        return std::sqrt(x * x + y * y + z * z);
+    T operator&() const noexcept {
+        return traits::norm(x, y, z);
+    }
+
+    // Norma al cuadrado (sin raiz): sirve para comparar longitudes
+    constexpr T norm_squared() const noexcept {
+        return x * x + y * y + z * z;
+    }
+
+    // Vector unitario: una raiz, una division y tres multiplicaciones en vez
+    // de las tres divisiones de v / &v (puede diferir de eso en el ultimo bit).
+    // El vector cero da NaN (en punto fijo, el vector cero: 1 / 0 satura).
+    Vector3 normalized() const noexcept {
+        return *this * (T(1) / traits::norm(x, y, z));
+    }
+
+    // --- Modo aproximado (opcional) ---
+    // Usan rsqrt del hardware mas un paso de Newton (ver simd::rsqrt_approx):
+    // error relativo < 2^-21 (~4.8e-7) en float y double, mucho menor que la
+    // tolerancia por defecto de equals, en todo el rango del tipo (< 2^-20
+    // si |v|^2 es subnormal, por el redondeo del propio |v|^2).
+
+    // Norma aproximada (el vector cero da 0, como operator&)
+    T norm_approx() const noexcept {
+        T s = norm_squared();
+        if (s == T(0)) return T(0);
+        return s * traits::rsqrt_approx(s);
+    }
+
+    // Vector unitario aproximado (sin raiz ni division)
+    Vector3 normalized_approx() const noexcept {
+        return *this * traits::rsqrt_approx(norm_squared());
+    }
+
+    // Norma usable en constexpr (mismo valor que operator& salvo 1 ulp)
+    constexpr T norm_constexpr() const noexcept {
+        return traits::norm_constexpr(x, y, z);
+    }
+
+    // Raiz cuadrada valida en tiempo de compilacion para el tipo T
+    static constexpr T sqrt_constexpr(T v) noexcept {
+        return traits::sqrt_constexpr(v);
+    }
+
+    // Valor absoluto usable en constexpr (std::fabs no lo es en C++17)
+    static constexpr T abs_constexpr(T v) noexcept {
+        return v < T(0) ? -v : v;
     }
 
     // --- Comparacion con tolerancia ---
 
-    // Compara dos vectores con una tolerancia (por si hay errores de punto flotante)
-    bool equals(const Vector3& other, double eps = 1e-6) const {
-        return std::fabs(x - other.x) < eps &&
-               std::fabs(y - other.y) < eps &&
-               std::fabs(z - other.z) < eps;
+    // Compara dos vectores con una tolerancia (por si hay errores de punto
+    // flotante). La tolerancia por defecto depende del tipo (ver Vector3Traits).
+    constexpr bool equals(const Vector3& other, T eps = traits::default_eps()) const noexcept {
+        return abs_constexpr(x - other.x) < eps &&
+               abs_constexpr(y - other.y) < eps &&
+               abs_constexpr(z - other.z) < eps;
     }
 
     // --- Mostrar vector ---
@@ -86,4 +216,11 @@ public:
     }
 };
 
+} // namespace geom
+
+// Nombres cortos de siempre. Vector3 sigue siendo el vector de doubles.
+using Vector3 = geom::Vector3<double>;
+using Vector3f = geom::Vector3<float>;
+using Vector3x = geom::Vector3<geom::Fixed32>;
+
 #endif
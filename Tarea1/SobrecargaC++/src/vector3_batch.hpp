@@ -0,0 +1,280 @@
+#ifndef VECTOR3_BATCH_HPP
+#define VECTOR3_BATCH_HPP
+
+#include <cstddef>    // Para std::size_t
+#include <new>        // Para operator new alineado
+#include <stdexcept>  // Para std::invalid_argument si los lotes no calzan
+#include <vector>     // Para guardar las componentes
+
+#include "vector3.hpp"
+#include "vector3_simd.hpp"
+
+// Alocador que entrega memoria alineada a Align bytes (para cargas SIMD alineadas)
+template <typename T, std::size_t Align>
+struct AlignedAllocator {
+    using value_type = T;
+
+    template <typename U>
+    struct rebind { using other = AlignedAllocator<U, Align>; };
+
+    AlignedAllocator() = default;
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, Align>&) {}
+
+    T* allocate(std::size_t n) {
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(Align)));
+    }
+    void deallocate(T* p, std::size_t) {
+        ::operator delete(p, std::align_val_t(Align));
+    }
+
+    template <typename U>
+    bool operator==(const AlignedAllocator<U, Align>&) const { return true; }
+    template <typename U>
+    bool operator!=(const AlignedAllocator<U, Align>&) const { return false; }
+};
+
+namespace geom {
+
+// Contenedor de muchos vectores en formato SoA (structure of arrays):
+// todas las x juntas, todas las y juntas y todas las z juntas. Asi un
+// registro SIMD carga varias x de una vez en lugar de mezclar x, y, z.
+template <typename T>
+class Vector3Batch {
+public:
+    static constexpr std::size_t alignment = 64; // Una linea de cache
+    using value_type = T;
+    using Array = std::vector<T, AlignedAllocator<T, alignment>>;
+
+    Vector3Batch() = default;
+
+    // Crea n vectores en cero
+    explicit Vector3Batch(std::size_t n) : xs(n), ys(n), zs(n) {}
+
+    std::size_t size() const { return xs.size(); }
+    bool empty() const { return xs.empty(); }
+
+    void resize(std::size_t n) {
+        xs.resize(n);
+        ys.resize(n);
+        zs.resize(n);
+    }
+
+    void reserve(std::size_t n) {
+        xs.reserve(n);
+        ys.reserve(n);
+        zs.reserve(n);
+    }
+
+    void clear() { resize(0); }
+
+    void push_back(const Vector3<T>& v) {
+        xs.push_back(v.x);
+        ys.push_back(v.y);
+        zs.push_back(v.z);
+    }
+
+    // Lectura y escritura de un vector individual
+    Vector3<T> get(std::size_t i) const { return {xs[i], ys[i], zs[i]}; }
+
+    void set(std::size_t i, const Vector3<T>& v) {
+        xs[i] = v.x;
+        ys[i] = v.y;
+        zs[i] = v.z;
+    }
+
+    // Acceso directo a cada componente (arreglos alineados a 64 bytes)
+    T* x() { return xs.data(); }
+    T* y() { return ys.data(); }
+    T* z() { return zs.data(); }
+    const T* x() const { return xs.data(); }
+    const T* y() const { return ys.data(); }
+    const T* z() const { return zs.data(); }
+
+private:
+    Array xs, ys, zs;
+};
+
+// --- Kernels en bloque ---
+// Todos procesan de a Pack<T>::width vectores y terminan la cola con
+// la version escalar. Las operaciones se hacen en el mismo orden que en los
+// operadores de Vector3, asi el resultado es el mismo que llamar al operador
+// elemento por elemento. La salida puede ser la misma que una entrada.
+// Los tipos sin registro SIMD (Pack de ancho 1, como Fixed) van directo por
+// los operadores de Vector3 para respetar su propia norma.
+
+// Los kernels de dos lotes piden el mismo tamano; si no, se leeria fuera del
+// menor. Lanza la misma excepcion que assign() en vector3_expr.hpp.
+template <typename T>
+void check_same_size(const Vector3Batch<T>& a, const Vector3Batch<T>& b) {
+    if (a.size() != b.size())
+        throw std::invalid_argument("Vector3Batch: los lotes tienen distinto tamano");
+}
+
+// Hasta donde llega el ciclo SIMD (el resto es cola escalar)
+template <typename P>
+constexpr std::size_t simd_end(std::size_t n) {
+    return P::width > 1 ? n - n % P::width : 0;
+}
+
+// out[i] = a[i] + b[i]
+template <typename T>
+void batch_add(const Vector3Batch<T>& a, const Vector3Batch<T>& b, Vector3Batch<T>& out) {
+    using P = simd::Pack<T>;
+    check_same_size(a, b);
+    const std::size_t n = a.size();
+    out.resize(n);
+    std::size_t i = 0;
+    for (; i < simd_end<P>(n); i += P::width) {
+        (P::load(a.x() + i) + P::load(b.x() + i)).store(out.x() + i);
+        (P::load(a.y() + i) + P::load(b.y() + i)).store(out.y() + i);
+        (P::load(a.z() + i) + P::load(b.z() + i)).store(out.z() + i);
+    }
+    for (; i < n; i++) {
+        out.set(i, a.get(i) + b.get(i));
+    }
+}
+
+// out[i] = a[i] * s (multiplicacion por escalar)
+template <typename T>
+void batch_scale(const Vector3Batch<T>& a, typename Vector3Batch<T>::value_type s, Vector3Batch<T>& out) {
+    using P = simd::Pack<T>;
+    const std::size_t n = a.size();
+    out.resize(n);
+    const P ps = P::broadcast(s);
+    std::size_t i = 0;
+    for (; i < simd_end<P>(n); i += P::width) {
+        (P::load(a.x() + i) * ps).store(out.x() + i);
+        (P::load(a.y() + i) * ps).store(out.y() + i);
+        (P::load(a.z() + i) * ps).store(out.z() + i);
+    }
+    for (; i < n; i++) {
+        out.set(i, a.get(i) * s);
+    }
+}
+
+// out[i] = a[i] * b[i] (producto cruz, igual que Vector3::operator*)
+template <typename T>
+void batch_cross(const Vector3Batch<T>& a, const Vector3Batch<T>& b, Vector3Batch<T>& out) {
+    using P = simd::Pack<T>;
+    check_same_size(a, b);
+    const std::size_t n = a.size();
+    out.resize(n);
+    std::size_t i = 0;
+    for (; i < simd_end<P>(n); i += P::width) {
+        P ax = P::load(a.x() + i), ay = P::load(a.y() + i), az = P::load(a.z() + i);
+        P bx = P::load(b.x() + i), by = P::load(b.y() + i), bz = P::load(b.z() + i);
+        (ay * bz - az * by).store(out.x() + i);
+        (az * bx - ax * bz).store(out.y() + i);
+        (ax * by - ay * bx).store(out.z() + i);
+    }
+    for (; i < n; i++) {
+        out.set(i, a.get(i) * b.get(i));
+    }
+}
+
+// out[i] = a[i] % b[i] (producto punto). out debe tener espacio para a.size() valores
+template <typename T>
+void batch_dot(const Vector3Batch<T>& a, const Vector3Batch<T>& b, T* out) {
+    using P = simd::Pack<T>;
+    check_same_size(a, b);
+    const std::size_t n = a.size();
+    std::size_t i = 0;
+    for (; i < simd_end<P>(n); i += P::width) {
+        P r = P::load(a.x() + i) * P::load(b.x() + i) +
+              P::load(a.y() + i) * P::load(b.y() + i) +
+              P::load(a.z() + i) * P::load(b.z() + i);
+        // out no tiene por que estar alineado: se guarda por un buffer alineado
+        alignas(Vector3Batch<T>::alignment) T tmp[P::width];
+        r.store(tmp);
+        for (std::size_t k = 0; k < P::width; k++) out[i + k] = tmp[k];
+    }
+    for (; i < n; i++) {
+        out[i] = a.get(i) % b.get(i);
+    }
+}
+
+// out[i] = &a[i] (norma). out debe tener espacio para a.size() valores
+template <typename T>
+void batch_norm(const Vector3Batch<T>& a, T* out) {
+    using P = simd::Pack<T>;
+    const std::size_t n = a.size();
+    std::size_t i = 0;
+    for (; i < simd_end<P>(n); i += P::width) {
+        P ax = P::load(a.x() + i), ay = P::load(a.y() + i), az = P::load(a.z() + i);
+        P r = sqrt(ax * ax + ay * ay + az * az);
+        alignas(Vector3Batch<T>::alignment) T tmp[P::width];
+        r.store(tmp);
+        for (std::size_t k = 0; k < P::width; k++) out[i + k] = tmp[k];
+    }
+    for (; i < n; i++) {
+        out[i] = &a.get(i);
+    }
+}
+
+// out[i] = a[i] / &a[i] (vector unitario). Un vector cero queda en NaN, igual que v / &v
+// (en punto fijo queda en cero, como normalized())
+template <typename T>
+void batch_normalize(const Vector3Batch<T>& a, Vector3Batch<T>& out) {
+    using P = simd::Pack<T>;
+    const std::size_t n = a.size();
+    out.resize(n);
+    std::size_t i = 0;
+    for (; i < simd_end<P>(n); i += P::width) {
+        P ax = P::load(a.x() + i), ay = P::load(a.y() + i), az = P::load(a.z() + i);
+        P len = sqrt(ax * ax + ay * ay + az * az);
+        (ax / len).store(out.x() + i);
+        (ay / len).store(out.y() + i);
+        (az / len).store(out.z() + i);
+    }
+    for (; i < n; i++) {
+        Vector3<T> v = a.get(i);
+        out.set(i, v / &v);
+    }
+}
+
+// out[i] = a[i].norm_squared(). out debe tener espacio para a.size() valores
+template <typename T>
+void batch_norm_squared(const Vector3Batch<T>& a, T* out) {
+    using P = simd::Pack<T>;
+    const std::size_t n = a.size();
+    std::size_t i = 0;
+    for (; i < simd_end<P>(n); i += P::width) {
+        P ax = P::load(a.x() + i), ay = P::load(a.y() + i), az = P::load(a.z() + i);
+        alignas(Vector3Batch<T>::alignment) T tmp[P::width];
+        (ax * ax + ay * ay + az * az).store(tmp);
+        for (std::size_t k = 0; k < P::width; k++) out[i + k] = tmp[k];
+    }
+    for (; i < n; i++) {
+        out[i] = a.get(i).norm_squared();
+    }
+}
+
+// out[i] = a[i].normalized_approx(): rsqrt + un paso de Newton por registro,
+// sin raiz ni division (mismo error que la version por objeto)
+template <typename T>
+void batch_normalize_approx(const Vector3Batch<T>& a, Vector3Batch<T>& out) {
+    using P = simd::Pack<T>;
+    const std::size_t n = a.size();
+    out.resize(n);
+    std::size_t i = 0;
+    for (; i < simd_end<P>(n); i += P::width) {
+        P ax = P::load(a.x() + i), ay = P::load(a.y() + i), az = P::load(a.z() + i);
+        P inv = simd::rsqrt_approx(ax * ax + ay * ay + az * az);
+        (ax * inv).store(out.x() + i);
+        (ay * inv).store(out.y() + i);
+        (az * inv).store(out.z() + i);
+    }
+    for (; i < n; i++) {
+        out.set(i, a.get(i).normalized_approx());
+    }
+}
+
+} // namespace geom
+
+// El lote de siempre sigue siendo de doubles
+using Vector3Batch = geom::Vector3Batch<double>;
+using Vector3fBatch = geom::Vector3Batch<float>;
+using Vector3xBatch = geom::Vector3Batch<geom::Fixed32>;
+
+#endif
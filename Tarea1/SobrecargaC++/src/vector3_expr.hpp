@@ -0,0 +1,425 @@
+#ifndef VECTOR3_EXPR_HPP
+#define VECTOR3_EXPR_HPP
+
+#include <cmath>        // Para std::sqrt
+#include <cstddef>      // Para std::size_t
+#include <stdexcept>    // Para std::invalid_argument si los lotes no calzan
+#include <type_traits>  // Para std::enable_if y amigos
+
+#include "vector3.hpp"
+#include "vector3_batch.hpp"
+#include "vector3_simd.hpp"
+
+// Plantillas de expresion para Vector3.
+//
+// Con los operadores normales, (b + b) * (c - a) crea un Vector3 temporal por
+// cada operador. Aqui los operadores devuelven nodos livianos que solo
+// recuerdan la operacion; el calculo se hace de una vez al convertir a
+// Vector3 (o al llamar eval / assign).
+//
+// Se entra a este modo con lazy():
+//     Vector3 r = (lazy(b) + b) * (lazy(c) - a);      // sin temporales
+//     assign(out, (lazy(lote_b) + lote_b) * 0.5);      // una sola pasada
+//
+// Cada nodo evalua la componente C del elemento i con comp<C, V>(i), donde V
+// es double o simd::Pack<double>. Asi la misma expresion sirve para un solo
+// vector y para lotes completos procesados de a un registro SIMD.
+//
+// Los nodos guardan a sus hijos por valor y a los Vector3/lotes por
+// referencia: la expresion no debe vivir mas que sus operandos.
+
+template <typename E> struct VecExpr;
+template <typename E> struct ScalarExpr;
+
+namespace expr_detail {
+
+// --- Carga y difusion segun el tipo de valor (escalar o registro) ---
+template <typename V> struct Lanes;
+
+template <>
+struct Lanes<double> {
+    static double load(const double* p) { return *p; }
+    static double splat(double s) { return s; }
+};
+
+#if !defined(VECTOR3_NO_SIMD) && (defined(__SSE2__) || defined(__AVX__) || defined(__AVX512F__))
+template <>
+struct Lanes<simd::Pack<double>> {
+    using P = simd::Pack<double>;
+    static P load(const double* p) { return P::load(p); }
+    static P splat(double s) { return P::broadcast(s); }
+};
+#endif
+
+inline double vsqrt(double v) { return std::sqrt(v); }
+template <typename P>
+inline P vsqrt(P v) { return sqrt(v); }
+
+// --- Rasgos para saber que es cada operando ---
+template <typename T>
+using bare = typename std::remove_cv<typename std::remove_reference<T>::type>::type;
+
+template <typename T>
+struct is_vec_expr {
+    template <typename E> static std::true_type test(const VecExpr<E>*);
+    static std::false_type test(...);
+    static constexpr bool value = decltype(test(static_cast<bare<T>*>(nullptr)))::value;
+};
+
+template <typename T>
+struct is_scalar_expr {
+    template <typename E> static std::true_type test(const ScalarExpr<E>*);
+    static std::false_type test(...);
+    static constexpr bool value = decltype(test(static_cast<bare<T>*>(nullptr)))::value;
+};
+
+// Operando vectorial: una expresion, un Vector3 o un lote
+template <typename T>
+struct is_vec_operand {
+    static constexpr bool value = is_vec_expr<T>::value ||
+                                  std::is_same<bare<T>, Vector3>::value ||
+                                  std::is_same<bare<T>, Vector3Batch>::value;
+};
+
+// Operando escalar: una expresion escalar o un numero
+template <typename T>
+struct is_scalar_operand {
+    static constexpr bool value = is_scalar_expr<T>::value || std::is_arithmetic<bare<T>>::value;
+};
+
+// Tamano combinado: 0 significa "vale para cualquier i" (un Vector3 o una constante).
+// Dos lotes de distinto tamano no se pueden combinar: se leeria fuera del menor.
+inline std::size_t join_size(std::size_t a, std::size_t b) {
+    if (a != 0 && b != 0 && a != b)
+        throw std::invalid_argument("Vector3Batch: los lotes de la expresion tienen distinto tamano");
+    return a != 0 ? a : b;
+}
+
+// Funciones de las operaciones componente a componente
+struct Add { template <typename V> static V apply(V a, V b) { return a + b; } };
+struct Sub { template <typename V> static V apply(V a, V b) { return a - b; } };
+struct Mul { template <typename V> static V apply(V a, V b) { return a * b; } };
+struct Div { template <typename V> static V apply(V a, V b) { return a / b; } };
+
+} // namespace expr_detail
+
+// --- Bases CRTP ---
+
+template <typename E>
+struct VecExpr {
+    const E& self() const { return static_cast<const E&>(*this); }
+
+    // Evalua la expresion como un solo vector
+    operator Vector3() const {
+        return {self().template comp<0, double>(0),
+                self().template comp<1, double>(0),
+                self().template comp<2, double>(0)};
+    }
+};
+
+template <typename E>
+struct ScalarExpr {
+    const E& self() const { return static_cast<const E&>(*this); }
+
+    // Evalua la expresion como un solo numero
+    operator double() const { return self().template value<double>(0); }
+};
+
+// --- Hojas ---
+
+// Referencia a un Vector3 (el mismo para todo i)
+struct VecRef : VecExpr<VecRef> {
+    const Vector3& v;
+    explicit VecRef(const Vector3& v_) : v(v_) {}
+
+    std::size_t size() const { return 0; }
+    template <int C, typename V>
+    V comp(std::size_t) const {
+        return expr_detail::Lanes<V>::splat(C == 0 ? v.x : C == 1 ? v.y : v.z);
+    }
+};
+
+// Referencia a un lote: el elemento i es el vector i del lote
+struct BatchRef : VecExpr<BatchRef> {
+    const Vector3Batch& b;
+    explicit BatchRef(const Vector3Batch& b_) : b(b_) {}
+
+    std::size_t size() const { return b.size(); }
+    template <int C, typename V>
+    V comp(std::size_t i) const {
+        return expr_detail::Lanes<V>::load((C == 0 ? b.x() : C == 1 ? b.y() : b.z()) + i);
+    }
+};
+
+// Constante numerica
+struct ScalarConst : ScalarExpr<ScalarConst> {
+    double s;
+    explicit ScalarConst(double s_) : s(s_) {}
+
+    std::size_t size() const { return 0; }
+    template <typename V>
+    V value(std::size_t) const { return expr_detail::Lanes<V>::splat(s); }
+};
+
+// Convierte cualquier operando a su nodo de expresion
+template <typename E>
+const E& as_expr(const VecExpr<E>& e) { return e.self(); }
+template <typename E>
+const E& as_expr(const ScalarExpr<E>& e) { return e.self(); }
+inline VecRef as_expr(const Vector3& v) { return VecRef(v); }
+inline BatchRef as_expr(const Vector3Batch& b) { return BatchRef(b); }
+inline ScalarConst as_expr(double s) { return ScalarConst(s); }
+
+template <typename T>
+using expr_t = expr_detail::bare<decltype(as_expr(std::declval<const T&>()))>;
+
+// Punto de entrada al modo perezoso
+inline VecRef lazy(const Vector3& v) { return VecRef(v); }
+inline BatchRef lazy(const Vector3Batch& b) { return BatchRef(b); }
+
+// --- Nodos internos ---
+
+// Vector op Vector, componente a componente (suma y resta)
+template <typename L, typename R, typename Op>
+struct VecBinary : VecExpr<VecBinary<L, R, Op>> {
+    L l;
+    R r;
+    VecBinary(const L& l_, const R& r_) : l(l_), r(r_) {}
+
+    std::size_t size() const { return expr_detail::join_size(l.size(), r.size()); }
+    template <int C, typename V>
+    V comp(std::size_t i) const {
+        return Op::apply(l.template comp<C, V>(i), r.template comp<C, V>(i));
+    }
+};
+
+// Vector op escalar, componente a componente (+, -, *, / por la derecha)
+template <typename L, typename S, typename Op>
+struct VecScalar : VecExpr<VecScalar<L, S, Op>> {
+    L l;
+    S s;
+    VecScalar(const L& l_, const S& s_) : l(l_), s(s_) {}
+
+    std::size_t size() const { return expr_detail::join_size(l.size(), s.size()); }
+    template <int C, typename V>
+    V comp(std::size_t i) const {
+        return Op::apply(l.template comp<C, V>(i), s.template value<V>(i));
+    }
+};
+
+// Producto cruz (mismo orden de operaciones que Vector3::operator*)
+template <typename L, typename R>
+struct VecCross : VecExpr<VecCross<L, R>> {
+    L l;
+    R r;
+    VecCross(const L& l_, const R& r_) : l(l_), r(r_) {}
+
+    std::size_t size() const { return expr_detail::join_size(l.size(), r.size()); }
+    template <int C, typename V>
+    V comp(std::size_t i) const {
+        constexpr int A = (C + 1) % 3, B = (C + 2) % 3;
+        return l.template comp<A, V>(i) * r.template comp<B, V>(i) -
+               l.template comp<B, V>(i) * r.template comp<A, V>(i);
+    }
+};
+
+// Producto punto (mismo orden que Vector3::operator%)
+template <typename L, typename R>
+struct VecDot : ScalarExpr<VecDot<L, R>> {
+    L l;
+    R r;
+    VecDot(const L& l_, const R& r_) : l(l_), r(r_) {}
+
+    std::size_t size() const { return expr_detail::join_size(l.size(), r.size()); }
+    template <typename V>
+    V value(std::size_t i) const {
+        return l.template comp<0, V>(i) * r.template comp<0, V>(i) +
+               l.template comp<1, V>(i) * r.template comp<1, V>(i) +
+               l.template comp<2, V>(i) * r.template comp<2, V>(i);
+    }
+};
+
+// Norma de una expresion
+template <typename E>
+struct VecNorm : ScalarExpr<VecNorm<E>> {
+    E e;
+    explicit VecNorm(const E& e_) : e(e_) {}
+
+    std::size_t size() const { return e.size(); }
+    template <typename V>
+    V value(std::size_t i) const {
+        V x = e.template comp<0, V>(i), y = e.template comp<1, V>(i), z = e.template comp<2, V>(i);
+        return expr_detail::vsqrt(x * x + y * y + z * z);
+    }
+};
+
+// Escalar op escalar (para combinar productos punto y normas)
+template <typename L, typename R, typename Op>
+struct ScalarBinary : ScalarExpr<ScalarBinary<L, R, Op>> {
+    L l;
+    R r;
+    ScalarBinary(const L& l_, const R& r_) : l(l_), r(r_) {}
+
+    std::size_t size() const { return expr_detail::join_size(l.size(), r.size()); }
+    template <typename V>
+    V value(std::size_t i) const {
+        return Op::apply(l.template value<V>(i), r.template value<V>(i));
+    }
+};
+
+// --- Operadores ---
+// Solo se activan si al menos un operando ya es una expresion, para no
+// cambiar lo que hacen los operadores normales entre Vector3.
+
+#define VECTOR3_EXPR_ENABLE(cond) typename std::enable_if<(cond), int>::type = 0
+
+template <typename L, typename R,
+          VECTOR3_EXPR_ENABLE(expr_detail::is_vec_operand<L>::value && expr_detail::is_vec_operand<R>::value &&
+                              (expr_detail::is_vec_expr<L>::value || expr_detail::is_vec_expr<R>::value))>
+VecBinary<expr_t<L>, expr_t<R>, expr_detail::Add> operator+(const L& l, const R& r) {
+    return {as_expr(l), as_expr(r)};
+}
+
+template <typename L, typename R,
+          VECTOR3_EXPR_ENABLE(expr_detail::is_vec_operand<L>::value && expr_detail::is_vec_operand<R>::value &&
+                              (expr_detail::is_vec_expr<L>::value || expr_detail::is_vec_expr<R>::value))>
+VecBinary<expr_t<L>, expr_t<R>, expr_detail::Sub> operator-(const L& l, const R& r) {
+    return {as_expr(l), as_expr(r)};
+}
+
+// Producto cruz (operador *)
+template <typename L, typename R,
+          VECTOR3_EXPR_ENABLE(expr_detail::is_vec_operand<L>::value && expr_detail::is_vec_operand<R>::value &&
+                              (expr_detail::is_vec_expr<L>::value || expr_detail::is_vec_expr<R>::value))>
+VecCross<expr_t<L>, expr_t<R>> operator*(const L& l, const R& r) {
+    return {as_expr(l), as_expr(r)};
+}
+
+// Producto punto (operador %)
+template <typename L, typename R,
+          VECTOR3_EXPR_ENABLE(expr_detail::is_vec_operand<L>::value && expr_detail::is_vec_operand<R>::value &&
+                              (expr_detail::is_vec_expr<L>::value || expr_detail::is_vec_expr<R>::value))>
+VecDot<expr_t<L>, expr_t<R>> operator%(const L& l, const R& r) {
+    return {as_expr(l), as_expr(r)};
+}
+
+// Norma (operador &), igual que en Vector3
+template <typename E>
+VecNorm<E> operator&(const VecExpr<E>& e) {
+    return VecNorm<E>(e.self());
+}
+
+// Vector op escalar (solo por la derecha, como en Vector3)
+template <typename L, typename S,
+          VECTOR3_EXPR_ENABLE(expr_detail::is_vec_operand<L>::value && expr_detail::is_scalar_operand<S>::value &&
+                              (expr_detail::is_vec_expr<L>::value || expr_detail::is_scalar_expr<S>::value))>
+VecScalar<expr_t<L>, expr_t<S>, expr_detail::Add> operator+(const L& l, const S& s) {
+    return {as_expr(l), as_expr(s)};
+}
+
+template <typename L, typename S,
+          VECTOR3_EXPR_ENABLE(expr_detail::is_vec_operand<L>::value && expr_detail::is_scalar_operand<S>::value &&
+                              (expr_detail::is_vec_expr<L>::value || expr_detail::is_scalar_expr<S>::value))>
+VecScalar<expr_t<L>, expr_t<S>, expr_detail::Sub> operator-(const L& l, const S& s) {
+    return {as_expr(l), as_expr(s)};
+}
+
+template <typename L, typename S,
+          VECTOR3_EXPR_ENABLE(expr_detail::is_vec_operand<L>::value && expr_detail::is_scalar_operand<S>::value &&
+                              (expr_detail::is_vec_expr<L>::value || expr_detail::is_scalar_expr<S>::value))>
+VecScalar<expr_t<L>, expr_t<S>, expr_detail::Mul> operator*(const L& l, const S& s) {
+    return {as_expr(l), as_expr(s)};
+}
+
+template <typename L, typename S,
+          VECTOR3_EXPR_ENABLE(expr_detail::is_vec_operand<L>::value && expr_detail::is_scalar_operand<S>::value &&
+                              (expr_detail::is_vec_expr<L>::value || expr_detail::is_scalar_expr<S>::value))>
+VecScalar<expr_t<L>, expr_t<S>, expr_detail::Div> operator/(const L& l, const S& s) {
+    return {as_expr(l), as_expr(s)};
+}
+
+// Escalar op escalar, cuando al menos uno es expresion
+#define VECTOR3_EXPR_SCALAR_OP(op, Op)                                                                    \
+    template <typename L, typename R,                                                                     \
+              VECTOR3_EXPR_ENABLE(expr_detail::is_scalar_operand<L>::value &&                             \
+                                  expr_detail::is_scalar_operand<R>::value &&                             \
+                                  (expr_detail::is_scalar_expr<L>::value ||                               \
+                                   expr_detail::is_scalar_expr<R>::value))>                               \
+    ScalarBinary<expr_t<L>, expr_t<R>, expr_detail::Op> operator op(const L& l, const R& r) {            \
+        return {as_expr(l), as_expr(r)};                                                                  \
+    }
+
+VECTOR3_EXPR_SCALAR_OP(+, Add)
+VECTOR3_EXPR_SCALAR_OP(-, Sub)
+VECTOR3_EXPR_SCALAR_OP(*, Mul)
+VECTOR3_EXPR_SCALAR_OP(/, Div)
+
+#undef VECTOR3_EXPR_SCALAR_OP
+
+// --- Evaluacion ---
+
+// Evalua una expresion como un solo vector o un solo numero
+template <typename E>
+Vector3 eval(const VecExpr<E>& e) { return e; }
+
+template <typename E>
+double eval(const ScalarExpr<E>& e) { return e; }
+
+// Evalua la expresion para todos los elementos del lote en una sola pasada.
+// out puede ser uno de los lotes de la expresion (cada elemento solo depende
+// del mismo indice en las entradas). Si out esta vacio toma el tamano de la
+// expresion; si la expresion no tiene lotes se repite en todo out. Lanza
+// std::invalid_argument si los tamanos no calzan.
+template <typename E>
+void assign(Vector3Batch& out, const VecExpr<E>& expr) {
+    const E& e = expr.self();
+    std::size_t n = e.size();
+    if (n == 0) {
+        n = out.size();
+    } else if (!out.empty() && out.size() != n) {
+        throw std::invalid_argument("assign: el lote de salida no tiene el tamano de la expresion");
+    }
+    out.resize(n);
+    double *ox = out.x(), *oy = out.y(), *oz = out.z();
+    std::size_t i = 0;
+#if !defined(VECTOR3_NO_SIMD) && (defined(__SSE2__) || defined(__AVX__) || defined(__AVX512F__))
+    using P = simd::Pack<double>;
+    for (; i + P::width <= n; i += P::width) {
+        P x = e.template comp<0, P>(i), y = e.template comp<1, P>(i), z = e.template comp<2, P>(i);
+        x.store(ox + i);
+        y.store(oy + i);
+        z.store(oz + i);
+    }
+#endif
+    for (; i < n; i++) {
+        double x = e.template comp<0, double>(i), y = e.template comp<1, double>(i),
+               z = e.template comp<2, double>(i);
+        ox[i] = x;
+        oy[i] = y;
+        oz[i] = z;
+    }
+}
+
+// Igual que arriba pero para expresiones escalares (productos punto, normas).
+// out debe tener espacio para e.size() valores.
+template <typename E>
+void assign(double* out, const ScalarExpr<E>& expr) {
+    const E& e = expr.self();
+    const std::size_t n = e.size();
+    std::size_t i = 0;
+#if !defined(VECTOR3_NO_SIMD) && (defined(__SSE2__) || defined(__AVX__) || defined(__AVX512F__))
+    using P = simd::Pack<double>;
+    for (; i + P::width <= n; i += P::width) {
+        alignas(Vector3Batch::alignment) double tmp[P::width];
+        e.template value<P>(i).store(tmp);
+        for (std::size_t k = 0; k < P::width; k++) out[i + k] = tmp[k];
+    }
+#endif
+    for (; i < n; i++) {
+        out[i] = e.template value<double>(i);
+    }
+}
+
+#undef VECTOR3_EXPR_ENABLE
+
+#endif
@@ -0,0 +1,271 @@
+#ifndef VECTOR3_IO_HPP
+#define VECTOR3_IO_HPP
+
+#include <charconv>     // Para std::to_chars / std::from_chars
+#include <cstdint>      // Para los campos del encabezado binario
+#include <cstdio>       // Para std::FILE y fwrite
+#include <cstring>      // Para memcpy y memcmp
+#include <type_traits>  // Para is_floating_point y is_standard_layout
+
+#include "vector3.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>      // Para open
+#include <sys/mman.h>   // Para mmap
+#include <sys/stat.h>   // Para fstat
+#include <unistd.h>     // Para close
+#define VECTOR3_IO_HAS_MMAP 1
+#endif
+
+// Entrada/salida rapida de Vector3, sin iostream ni memoria dinamica.
+//
+// Texto: cada vector es "x y z\n", con la representacion mas corta que
+// vuelve exactamente al mismo numero (std::to_chars). No depende del locale.
+//
+// Binario: un encabezado de 64 bytes seguido de los vectores empaquetados
+// tal como estan en memoria (x, y, z seguidos). Como el arreglo queda
+// alineado a 64 bytes dentro del archivo, el archivo se puede mapear con
+// MappedVector3File y usar directamente como un arreglo de Vector3, sin
+// leerlo ni parsearlo.
+
+namespace geom {
+
+// --- Texto ---
+
+// Escribe "x y z" en [first, last). Devuelve el puntero al final de lo
+// escrito o nullptr si no alcanzo el espacio.
+template <typename T>
+char* to_chars(char* first, char* last, const Vector3<T>& v) {
+    static_assert(std::is_floating_point<T>::value, "El formato de texto es para float y double");
+    const T comps[3] = {v.x, v.y, v.z};
+    for (int c = 0; c < 3; c++) {
+        if (c > 0) {
+            if (first == last) return nullptr;
+            *first++ = ' ';
+        }
+        std::to_chars_result r = std::to_chars(first, last, comps[c]);
+        if (r.ec != std::errc()) return nullptr;
+        first = r.ptr;
+    }
+    return first;
+}
+
+// Lee "x y z" (separados por espacios o tabs) desde [first, last). Devuelve
+// el puntero a lo que sigue o nullptr si el texto no es un vector valido.
+template <typename T>
+const char* from_chars(const char* first, const char* last, Vector3<T>& out) {
+    static_assert(std::is_floating_point<T>::value, "El formato de texto es para float y double");
+    T* comps[3] = {&out.x, &out.y, &out.z};
+    for (int c = 0; c < 3; c++) {
+        while (first != last && (*first == ' ' || *first == '\t')) first++;
+        std::from_chars_result r = std::from_chars(first, last, *comps[c]);
+        if (r.ec != std::errc()) return nullptr;
+        first = r.ptr;
+    }
+    return first;
+}
+
+// Escribe n vectores, uno por linea, usando un buffer fijo en la pila.
+// Devuelve cuantos vectores se escribieron completos.
+template <typename T>
+std::size_t write_text(std::FILE* f, const Vector3<T>* v, std::size_t n) {
+    char buffer[1 << 16];
+    const std::size_t max_line = 3 * 32; // Sobra para 3 doubles y separadores
+    char* p = buffer;
+    std::size_t written = 0;
+    for (std::size_t i = 0; i < n; i++) {
+        if (static_cast<std::size_t>(buffer + sizeof(buffer) - p) < max_line) {
+            if (std::fwrite(buffer, 1, p - buffer, f) != static_cast<std::size_t>(p - buffer)) return written;
+            written = i;
+            p = buffer;
+        }
+        p = to_chars(p, buffer + sizeof(buffer), v[i]);
+        *p++ = '\n';
+    }
+    if (std::fwrite(buffer, 1, p - buffer, f) != static_cast<std::size_t>(p - buffer)) return written;
+    return n;
+}
+
+// Lee hasta cap vectores desde el texto [first, last), uno por linea (se
+// ignoran lineas vacias). Guarda en *end donde quedo el cursor: si no se
+// llego a last y no se lleno cap, el texto tenia un error en esa posicion.
+template <typename T>
+std::size_t parse_text(const char* first, const char* last, Vector3<T>* out, std::size_t cap,
+                       const char** end = nullptr) {
+    std::size_t count = 0;
+    while (count < cap) {
+        while (first != last && (*first == ' ' || *first == '\t' || *first == '\n' || *first == '\r')) first++;
+        if (first == last) break;
+        const char* next = from_chars(first, last, out[count]);
+        if (!next) break;
+        first = next;
+        count++;
+    }
+    if (end) *end = first;
+    return count;
+}
+
+// --- Binario ---
+
+// Tipo de componente guardado en el encabezado
+template <typename T> struct BinaryType;
+template <> struct BinaryType<double> { static constexpr std::uint8_t code = 1; };
+template <> struct BinaryType<float> { static constexpr std::uint8_t code = 2; };
+template <> struct BinaryType<Fixed32> { static constexpr std::uint8_t code = 3; };
+
+// Encabezado de 64 bytes al inicio del archivo (little endian)
+struct BinaryHeader {
+    char magic[4];            // "V3BN"
+    std::uint16_t version;    // 1
+    std::uint8_t type;        // BinaryType<T>::code
+    std::uint8_t little;      // 1 si se escribio en una maquina little endian
+    std::uint32_t elem_size;  // sizeof(Vector3<T>)
+    std::uint32_t reserved;
+    std::uint64_t count;      // Cantidad de vectores
+    std::uint64_t data_offset; // Donde empiezan los vectores (64)
+    std::uint8_t padding[32];
+};
+static_assert(sizeof(BinaryHeader) == 64, "El encabezado debe medir 64 bytes");
+
+inline bool host_is_little_endian() {
+    const std::uint16_t one = 1;
+    std::uint8_t first;
+    std::memcpy(&first, &one, 1);
+    return first == 1;
+}
+
+template <typename T>
+BinaryHeader make_header(std::uint64_t count) {
+    static_assert(std::is_standard_layout<Vector3<T>>::value && sizeof(Vector3<T>) == 3 * sizeof(T),
+                  "Vector3<T> debe ser tres T seguidos para guardarse tal cual");
+    BinaryHeader h{};
+    std::memcpy(h.magic, "V3BN", 4);
+    h.version = 1;
+    h.type = BinaryType<T>::code;
+    h.little = host_is_little_endian() ? 1 : 0;
+    h.elem_size = sizeof(Vector3<T>);
+    h.count = count;
+    h.data_offset = sizeof(BinaryHeader);
+    return h;
+}
+
+// Verifica que el encabezado corresponda a vectores de tipo T en esta maquina
+template <typename T>
+bool header_matches(const BinaryHeader& h) {
+    return std::memcmp(h.magic, "V3BN", 4) == 0 && h.version == 1 && h.type == BinaryType<T>::code &&
+           h.little == (host_is_little_endian() ? 1 : 0) && h.elem_size == sizeof(Vector3<T>) &&
+           h.data_offset == sizeof(BinaryHeader);
+}
+
+// Escribe n vectores en formato binario. Devuelve false si fallo la escritura.
+template <typename T>
+bool write_binary(std::FILE* f, const Vector3<T>* v, std::size_t n) {
+    BinaryHeader h = make_header<T>(n);
+    if (std::fwrite(&h, sizeof(h), 1, f) != 1) return false;
+    return std::fwrite(v, sizeof(Vector3<T>), n, f) == n;
+}
+
+template <typename T>
+bool write_binary(const char* path, const Vector3<T>* v, std::size_t n) {
+    std::FILE* f = std::fopen(path, "wb");
+    if (!f) return false;
+    bool ok = write_binary(f, v, n);
+    return std::fclose(f) == 0 && ok;
+}
+
+// Lee hasta cap vectores de un archivo binario en out. Devuelve cuantos
+// leyo, o -1 si el archivo no existe o no es de vectores de tipo T.
+template <typename T>
+long long read_binary(const char* path, Vector3<T>* out, std::size_t cap) {
+    std::FILE* f = std::fopen(path, "rb");
+    if (!f) return -1;
+    BinaryHeader h;
+    if (std::fread(&h, sizeof(h), 1, f) != 1 || !header_matches<T>(h)) {
+        std::fclose(f);
+        return -1;
+    }
+    std::size_t want = h.count < cap ? static_cast<std::size_t>(h.count) : cap;
+    std::size_t got = std::fread(out, sizeof(Vector3<T>), want, f);
+    std::fclose(f);
+    return static_cast<long long>(got);
+}
+
+#ifdef VECTOR3_IO_HAS_MMAP
+
+// Archivo binario mapeado en memoria: los vectores se usan directo desde
+// el archivo (el sistema operativo carga las paginas a medida que se tocan).
+template <typename T>
+class MappedVector3File {
+public:
+    MappedVector3File() = default;
+    explicit MappedVector3File(const char* path) { open(path); }
+    ~MappedVector3File() { close(); }
+
+    MappedVector3File(const MappedVector3File&) = delete;
+    MappedVector3File& operator=(const MappedVector3File&) = delete;
+
+    // Mapea el archivo. Devuelve false (y error() dice por que) si no se pudo.
+    bool open(const char* path) {
+        close();
+        int fd = ::open(path, O_RDONLY);
+        if (fd < 0) return fail("no se pudo abrir el archivo");
+        struct stat st;
+        if (fstat(fd, &st) != 0 || static_cast<std::size_t>(st.st_size) < sizeof(BinaryHeader)) {
+            ::close(fd);
+            return fail("archivo demasiado corto");
+        }
+        void* p = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd); // El mapeo sigue vivo sin el descriptor
+        if (p == MAP_FAILED) return fail("mmap fallo");
+        base_ = p;
+        length_ = st.st_size;
+        const BinaryHeader* h = static_cast<const BinaryHeader*>(base_);
+        if (!header_matches<T>(*h)) {
+            close();
+            return fail("encabezado invalido o de otro tipo");
+        }
+        if (h->count > (length_ - h->data_offset) / sizeof(Vector3<T>)) {
+            close();
+            return fail("archivo truncado");
+        }
+        count_ = static_cast<std::size_t>(h->count);
+        data_ = reinterpret_cast<const Vector3<T>*>(static_cast<const char*>(base_) + h->data_offset);
+        madvise(base_, length_, MADV_SEQUENTIAL);
+        return true;
+    }
+
+    void close() {
+        if (base_) munmap(base_, length_);
+        base_ = nullptr;
+        data_ = nullptr;
+        length_ = 0;
+        count_ = 0;
+    }
+
+    bool is_open() const { return base_ != nullptr; }
+    const char* error() const { return error_; }
+
+    std::size_t size() const { return count_; }
+    const Vector3<T>* data() const { return data_; }
+    const Vector3<T>& operator[](std::size_t i) const { return data_[i]; }
+    const Vector3<T>* begin() const { return data_; }
+    const Vector3<T>* end() const { return data_ + count_; }
+
+private:
+    bool fail(const char* msg) {
+        error_ = msg;
+        return false;
+    }
+
+    void* base_ = nullptr;
+    std::size_t length_ = 0;
+    std::size_t count_ = 0;
+    const Vector3<T>* data_ = nullptr;
+    const char* error_ = "";
+};
+
+#endif
+
+} // namespace geom
+
+#endif
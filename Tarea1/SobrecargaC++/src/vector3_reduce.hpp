@@ -0,0 +1,173 @@
+#ifndef VECTOR3_REDUCE_HPP
+#define VECTOR3_REDUCE_HPP
+
+#include <cstddef>    // Para std::size_t
+#include <thread>     // Para repartir bloques entre hilos
+#include <vector>     // Para los resultados parciales por bloque
+
+#include "aabb.hpp"
+#include "vector3.hpp"
+
+// Reducciones sobre arreglos de Vector3 usando todos los nucleos: suma,
+// promedio, caja envolvente, norma minima/maxima y suma de productos punto.
+//
+// Determinismo: el arreglo se parte en bloques de tamano fijo (block_size),
+// cada bloque se suma por pares (pairwise) y los resultados de los bloques
+// se combinan tambien por pares en un orden fijo. Los hilos solo deciden
+// quien calcula cada bloque, no como se suma, asi que el resultado es el
+// mismo bit a bit con 1 hilo o con N. La suma por pares tiene error
+// O(log n) en vez del O(n) del ciclo con operator+.
+//
+// threads = 0 usa std::thread::hardware_concurrency().
+
+namespace geom {
+
+namespace reduce_detail {
+
+constexpr std::size_t block_size = 4096;
+
+// Suma por pares de term(i) para i en [first, last)
+template <typename R, typename Term>
+R pairwise(std::size_t first, std::size_t last, const Term& term) {
+    if (last - first <= 8) {
+        R s = term(first);
+        for (std::size_t i = first + 1; i < last; i++) s = s + term(i);
+        return s;
+    }
+    std::size_t mid = first + (last - first) / 2;
+    return pairwise<R>(first, mid, term) + pairwise<R>(mid, last, term);
+}
+
+inline unsigned resolve_threads(unsigned threads, std::size_t blocks) {
+    if (threads == 0) threads = std::thread::hardware_concurrency();
+    if (threads == 0) threads = 1;
+    if (threads > blocks) threads = static_cast<unsigned>(blocks);
+    return threads;
+}
+
+// Calcula block(first, last) para cada bloque (repartiendo los bloques entre
+// hilos) y devuelve los parciales en orden. Requiere n > 0.
+template <typename R, typename Block>
+std::vector<R> per_block(std::size_t n, unsigned threads, const Block& block) {
+    const std::size_t blocks = (n + block_size - 1) / block_size;
+    std::vector<R> partial(blocks);
+    auto work = [&](std::size_t b0, std::size_t b1) {
+        for (std::size_t b = b0; b < b1; b++) {
+            std::size_t first = b * block_size;
+            std::size_t last = first + block_size < n ? first + block_size : n;
+            partial[b] = block(first, last);
+        }
+    };
+    threads = resolve_threads(threads, blocks);
+    if (threads <= 1) {
+        work(0, blocks);
+        return partial;
+    }
+    std::vector<std::thread> pool;
+    pool.reserve(threads - 1);
+    for (unsigned t = 1; t < threads; t++) {
+        pool.emplace_back(work, blocks * t / threads, blocks * (t + 1) / threads);
+    }
+    work(0, blocks / threads); // El hilo que llama hace el primer tramo
+    for (std::thread& th : pool) th.join();
+    return partial;
+}
+
+// Suma por pares de term(i) sobre todo el arreglo, en paralelo y determinista
+template <typename R, typename Term>
+R parallel_pairwise(std::size_t n, unsigned threads, const Term& term) {
+    if (n == 0) return R();
+    std::vector<R> partial = per_block<R>(n, threads, [&](std::size_t first, std::size_t last) {
+        return pairwise<R>(first, last, term);
+    });
+    return pairwise<R>(0, partial.size(), [&](std::size_t b) { return partial[b]; });
+}
+
+} // namespace reduce_detail
+
+// Suma de todos los vectores (el vector cero si n == 0)
+template <typename T>
+Vector3<T> reduce_sum(const Vector3<T>* v, std::size_t n, unsigned threads = 0) {
+    return reduce_detail::parallel_pairwise<Vector3<T>>(n, threads, [v](std::size_t i) { return v[i]; });
+}
+
+// Promedio (centroide) de los vectores. Con n == 0 da el vector cero.
+template <typename T>
+Vector3<T> reduce_mean(const Vector3<T>* v, std::size_t n, unsigned threads = 0) {
+    if (n == 0) return Vector3<T>();
+    return reduce_sum(v, n, threads) / T(n);
+}
+
+// Suma de a[i] % b[i] (producto punto acumulado)
+template <typename T>
+T reduce_dot(const Vector3<T>* a, const Vector3<T>* b, std::size_t n, unsigned threads = 0) {
+    return reduce_detail::parallel_pairwise<T>(n, threads, [a, b](std::size_t i) { return a[i] % b[i]; });
+}
+
+// Caja envolvente de los vectores (vacia si n == 0)
+template <typename T>
+AABB<T> reduce_bounds(const Vector3<T>* v, std::size_t n, unsigned threads = 0) {
+    AABB<T> box;
+    if (n == 0) return box;
+    std::vector<AABB<T>> partial =
+        reduce_detail::per_block<AABB<T>>(n, threads, [v](std::size_t first, std::size_t last) {
+            AABB<T> b;
+            for (std::size_t i = first; i < last; i++) b.expand(v[i]);
+            return b;
+        });
+    for (const AABB<T>& b : partial) box.expand(b);
+    return box;
+}
+
+// Normas minima y maxima y en que indice estan (el primero si hay empate)
+template <typename T>
+struct NormRange {
+    T min = T(0), max = T(0);
+    std::size_t min_index = 0, max_index = 0;
+};
+
+// Busca la norma minima y maxima comparando normas al cuadrado; solo saca
+// dos raices al final. Con n == 0 todo queda en cero.
+template <typename T>
+NormRange<T> reduce_norm_range(const Vector3<T>* v, std::size_t n, unsigned threads = 0) {
+    NormRange<T> r;
+    if (n == 0) return r;
+    // Dentro de cada bloque se guardan normas al cuadrado
+    std::vector<NormRange<T>> partial =
+        reduce_detail::per_block<NormRange<T>>(n, threads, [v](std::size_t first, std::size_t last) {
+            NormRange<T> b;
+            b.min = b.max = v[first].norm_squared();
+            b.min_index = b.max_index = first;
+            for (std::size_t i = first + 1; i < last; i++) {
+                T s = v[i].norm_squared();
+                if (s < b.min) {
+                    b.min = s;
+                    b.min_index = i;
+                }
+                if (s > b.max) {
+                    b.max = s;
+                    b.max_index = i;
+                }
+            }
+            return b;
+        });
+    r = partial[0];
+    for (std::size_t b = 1; b < partial.size(); b++) {
+        // Los bloques van en orden, asi que < y > conservan el primer indice
+        if (partial[b].min < r.min) {
+            r.min = partial[b].min;
+            r.min_index = partial[b].min_index;
+        }
+        if (partial[b].max > r.max) {
+            r.max = partial[b].max;
+            r.max_index = partial[b].max_index;
+        }
+    }
+    r.min = &v[r.min_index];
+    r.max = &v[r.max_index];
+    return r;
+}
+
+} // namespace geom
+
+#endif
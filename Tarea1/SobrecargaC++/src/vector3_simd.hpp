@@ -0,0 +1,280 @@
+#ifndef VECTOR3_SIMD_HPP
+#define VECTOR3_SIMD_HPP
+
+#include <cfloat>     // Para FLT_MIN y FLT_MAX
+#include <cmath>      // Para std::sqrt en el caso escalar
+#include <cstddef>    // Para std::size_t
+
+#if !defined(VECTOR3_NO_SIMD) && (defined(__SSE2__) || defined(__AVX__) || defined(__AVX512F__))
+#include <immintrin.h>
+#endif
+
+// Envoltorio minimo sobre los registros vectoriales del procesador.
+// Los kernels de Vector3Batch se escriben una sola vez contra Pack<T> y el
+// ancho real (AVX-512, AVX, SSE2 o escalar) se elige al compilar segun las
+// banderas (-mavx512f, -mavx2, -march=native...). Definiendo VECTOR3_NO_SIMD
+// se fuerza siempre el camino escalar.
+//
+// Solo se usan mul/add/sub/div/sqrt separados (nunca FMA) para que cada
+// carril redondee igual que los operadores escalares de Vector3.
+namespace simd {
+
+// --- Estimacion rapida de 1/sqrt(v) ---
+// Usa la instruccion rsqrt del procesador: error relativo < 1.5 * 2^-12
+// (rsqrtss/rsqrtps) o < 2^-14 (rsqrt14 de AVX-512). Sin SSE se calcula
+// exacto. Sin AVX-512 (rsqrtss/rsqrtps) los floats subnormales dan inf, y
+// los doubles pasan por float; por eso los valores fuera del rango normal de
+// float (~1e-38 a ~3e38, y tambien 0, inf y NaN) se calculan exacto con
+// 1/sqrt, carril por carril. rsqrt14 acepta subnormales.
+// Los registros usan la misma instruccion que estas versiones escalares,
+// asi un kernel en bloque y su cola escalar dan el mismo resultado.
+
+template <typename T>
+inline T rsqrt_estimate(T v) {
+    using std::sqrt;
+    return T(1) / sqrt(v);
+}
+
+inline float rsqrt_estimate(float v) {
+#if !defined(VECTOR3_NO_SIMD) && defined(__AVX512F__)
+    return _mm_cvtss_f32(_mm_rsqrt14_ss(_mm_setzero_ps(), _mm_set_ss(v)));
+#elif !defined(VECTOR3_NO_SIMD) && (defined(__SSE2__) || defined(__AVX__))
+    if (!(v >= FLT_MIN && v <= FLT_MAX)) return 1.0f / std::sqrt(v);
+    return _mm_cvtss_f32(_mm_rsqrt_ss(_mm_set_ss(v)));
+#else
+    return 1.0f / std::sqrt(v);
+#endif
+}
+
+// Rango de doubles que rsqrtss/rsqrtps pueden estimar convertidos a float
+constexpr double rsqrt_float_min = FLT_MIN;
+constexpr double rsqrt_float_max = FLT_MAX;
+
+inline double rsqrt_estimate(double v) {
+#if !defined(VECTOR3_NO_SIMD) && defined(__AVX512F__)
+    return _mm_cvtsd_f64(_mm_rsqrt14_sd(_mm_setzero_pd(), _mm_set_sd(v)));
+#elif !defined(VECTOR3_NO_SIMD) && (defined(__SSE2__) || defined(__AVX__))
+    if (!(v >= rsqrt_float_min && v <= rsqrt_float_max)) return 1.0 / std::sqrt(v);
+    return _mm_cvtss_f32(_mm_rsqrt_ss(_mm_set_ss(static_cast<float>(v))));
+#else
+    return 1.0 / std::sqrt(v);
+#endif
+}
+
+// Caso general: un solo elemento por "registro" (tambien para Fixed)
+template <typename T>
+struct Pack {
+    static constexpr std::size_t width = 1;
+    T v;
+
+    static Pack load(const T* p) { return {*p}; }
+    static Pack broadcast(T s) { return {s}; }
+    void store(T* p) const { *p = v; }
+
+    friend Pack operator+(Pack a, Pack b) { return {a.v + b.v}; }
+    friend Pack operator-(Pack a, Pack b) { return {a.v - b.v}; }
+    friend Pack operator*(Pack a, Pack b) { return {a.v * b.v}; }
+    friend Pack operator/(Pack a, Pack b) { return {a.v / b.v}; }
+    friend Pack sqrt(Pack a) {
+        using std::sqrt; // los tipos propios (Fixed) traen su sqrt por ADL
+        return {sqrt(a.v)};
+    }
+    friend Pack rsqrt_estimate(Pack a) { return {rsqrt_estimate(a.v)}; }
+};
+
+#if !defined(VECTOR3_NO_SIMD) && defined(__AVX512F__)
+
+// AVX-512: 8 doubles por registro
+template <>
+struct Pack<double> {
+    static constexpr std::size_t width = 8;
+    __m512d v;
+
+    static Pack load(const double* p) { return {_mm512_load_pd(p)}; }
+    static Pack broadcast(double s) { return {_mm512_set1_pd(s)}; }
+    void store(double* p) const { _mm512_store_pd(p, v); }
+
+    friend Pack operator+(Pack a, Pack b) { return {_mm512_add_pd(a.v, b.v)}; }
+    friend Pack operator-(Pack a, Pack b) { return {_mm512_sub_pd(a.v, b.v)}; }
+    friend Pack operator*(Pack a, Pack b) { return {_mm512_mul_pd(a.v, b.v)}; }
+    friend Pack operator/(Pack a, Pack b) { return {_mm512_div_pd(a.v, b.v)}; }
+    friend Pack sqrt(Pack a) { return {_mm512_sqrt_pd(a.v)}; }
+    friend Pack rsqrt_estimate(Pack a) { return {_mm512_rsqrt14_pd(a.v)}; }
+};
+
+// AVX-512: 16 floats por registro
+template <>
+struct Pack<float> {
+    static constexpr std::size_t width = 16;
+    __m512 v;
+
+    static Pack load(const float* p) { return {_mm512_load_ps(p)}; }
+    static Pack broadcast(float s) { return {_mm512_set1_ps(s)}; }
+    void store(float* p) const { _mm512_store_ps(p, v); }
+
+    friend Pack operator+(Pack a, Pack b) { return {_mm512_add_ps(a.v, b.v)}; }
+    friend Pack operator-(Pack a, Pack b) { return {_mm512_sub_ps(a.v, b.v)}; }
+    friend Pack operator*(Pack a, Pack b) { return {_mm512_mul_ps(a.v, b.v)}; }
+    friend Pack operator/(Pack a, Pack b) { return {_mm512_div_ps(a.v, b.v)}; }
+    friend Pack sqrt(Pack a) { return {_mm512_sqrt_ps(a.v)}; }
+    friend Pack rsqrt_estimate(Pack a) { return {_mm512_rsqrt14_ps(a.v)}; }
+};
+
+#elif !defined(VECTOR3_NO_SIMD) && defined(__AVX__)
+
+// AVX/AVX2: 4 doubles por registro
+template <>
+struct Pack<double> {
+    static constexpr std::size_t width = 4;
+    __m256d v;
+
+    static Pack load(const double* p) { return {_mm256_load_pd(p)}; }
+    static Pack broadcast(double s) { return {_mm256_set1_pd(s)}; }
+    void store(double* p) const { _mm256_store_pd(p, v); }
+
+    friend Pack operator+(Pack a, Pack b) { return {_mm256_add_pd(a.v, b.v)}; }
+    friend Pack operator-(Pack a, Pack b) { return {_mm256_sub_pd(a.v, b.v)}; }
+    friend Pack operator*(Pack a, Pack b) { return {_mm256_mul_pd(a.v, b.v)}; }
+    friend Pack operator/(Pack a, Pack b) { return {_mm256_div_pd(a.v, b.v)}; }
+    friend Pack sqrt(Pack a) { return {_mm256_sqrt_pd(a.v)}; }
+    friend Pack rsqrt_estimate(Pack a) {
+        __m256d est = _mm256_cvtps_pd(_mm_rsqrt_ps(_mm256_cvtpd_ps(a.v)));
+        __m256d ok = _mm256_and_pd(_mm256_cmp_pd(a.v, _mm256_set1_pd(rsqrt_float_min), _CMP_GE_OQ),
+                                   _mm256_cmp_pd(a.v, _mm256_set1_pd(rsqrt_float_max), _CMP_LE_OQ));
+        if (_mm256_movemask_pd(ok) == 0xF) return {est};
+        // Algun carril fuera del rango de float: esos van exactos
+        __m256d exact = _mm256_div_pd(_mm256_set1_pd(1.0), _mm256_sqrt_pd(a.v));
+        return {_mm256_blendv_pd(exact, est, ok)};
+    }
+};
+
+// AVX/AVX2: 8 floats por registro
+template <>
+struct Pack<float> {
+    static constexpr std::size_t width = 8;
+    __m256 v;
+
+    static Pack load(const float* p) { return {_mm256_load_ps(p)}; }
+    static Pack broadcast(float s) { return {_mm256_set1_ps(s)}; }
+    void store(float* p) const { _mm256_store_ps(p, v); }
+
+    friend Pack operator+(Pack a, Pack b) { return {_mm256_add_ps(a.v, b.v)}; }
+    friend Pack operator-(Pack a, Pack b) { return {_mm256_sub_ps(a.v, b.v)}; }
+    friend Pack operator*(Pack a, Pack b) { return {_mm256_mul_ps(a.v, b.v)}; }
+    friend Pack operator/(Pack a, Pack b) { return {_mm256_div_ps(a.v, b.v)}; }
+    friend Pack sqrt(Pack a) { return {_mm256_sqrt_ps(a.v)}; }
+    friend Pack rsqrt_estimate(Pack a) {
+        __m256 est = _mm256_rsqrt_ps(a.v);
+        __m256 ok = _mm256_and_ps(_mm256_cmp_ps(a.v, _mm256_set1_ps(FLT_MIN), _CMP_GE_OQ),
+                                  _mm256_cmp_ps(a.v, _mm256_set1_ps(FLT_MAX), _CMP_LE_OQ));
+        if (_mm256_movemask_ps(ok) == 0xFF) return {est};
+        // Algun carril subnormal, cero o no finito: esos van exactos
+        __m256 exact = _mm256_div_ps(_mm256_set1_ps(1.0f), _mm256_sqrt_ps(a.v));
+        return {_mm256_blendv_ps(exact, est, ok)};
+    }
+};
+
+#elif !defined(VECTOR3_NO_SIMD) && defined(__SSE2__)
+
+// SSE2: 2 doubles por registro
+template <>
+struct Pack<double> {
+    static constexpr std::size_t width = 2;
+    __m128d v;
+
+    static Pack load(const double* p) { return {_mm_load_pd(p)}; }
+    static Pack broadcast(double s) { return {_mm_set1_pd(s)}; }
+    void store(double* p) const { _mm_store_pd(p, v); }
+
+    friend Pack operator+(Pack a, Pack b) { return {_mm_add_pd(a.v, b.v)}; }
+    friend Pack operator-(Pack a, Pack b) { return {_mm_sub_pd(a.v, b.v)}; }
+    friend Pack operator*(Pack a, Pack b) { return {_mm_mul_pd(a.v, b.v)}; }
+    friend Pack operator/(Pack a, Pack b) { return {_mm_div_pd(a.v, b.v)}; }
+    friend Pack sqrt(Pack a) { return {_mm_sqrt_pd(a.v)}; }
+    friend Pack rsqrt_estimate(Pack a) {
+        __m128d est = _mm_cvtps_pd(_mm_rsqrt_ps(_mm_cvtpd_ps(a.v)));
+        __m128d ok = _mm_and_pd(_mm_cmpge_pd(a.v, _mm_set1_pd(rsqrt_float_min)),
+                                _mm_cmple_pd(a.v, _mm_set1_pd(rsqrt_float_max)));
+        if (_mm_movemask_pd(ok) == 0x3) return {est};
+        // Algun carril fuera del rango de float: esos van exactos
+        __m128d exact = _mm_div_pd(_mm_set1_pd(1.0), _mm_sqrt_pd(a.v));
+        return {_mm_or_pd(_mm_and_pd(ok, est), _mm_andnot_pd(ok, exact))};
+    }
+};
+
+// SSE: 4 floats por registro
+template <>
+struct Pack<float> {
+    static constexpr std::size_t width = 4;
+    __m128 v;
+
+    static Pack load(const float* p) { return {_mm_load_ps(p)}; }
+    static Pack broadcast(float s) { return {_mm_set1_ps(s)}; }
+    void store(float* p) const { _mm_store_ps(p, v); }
+
+    friend Pack operator+(Pack a, Pack b) { return {_mm_add_ps(a.v, b.v)}; }
+    friend Pack operator-(Pack a, Pack b) { return {_mm_sub_ps(a.v, b.v)}; }
+    friend Pack operator*(Pack a, Pack b) { return {_mm_mul_ps(a.v, b.v)}; }
+    friend Pack operator/(Pack a, Pack b) { return {_mm_div_ps(a.v, b.v)}; }
+    friend Pack sqrt(Pack a) { return {_mm_sqrt_ps(a.v)}; }
+    friend Pack rsqrt_estimate(Pack a) {
+        __m128 est = _mm_rsqrt_ps(a.v);
+        __m128 ok = _mm_and_ps(_mm_cmpge_ps(a.v, _mm_set1_ps(FLT_MIN)),
+                               _mm_cmple_ps(a.v, _mm_set1_ps(FLT_MAX)));
+        if (_mm_movemask_ps(ok) == 0xF) return {est};
+        // Algun carril subnormal, cero o no finito: esos van exactos
+        __m128 exact = _mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(a.v));
+        return {_mm_or_ps(_mm_and_ps(ok, est), _mm_andnot_ps(ok, exact))};
+    }
+};
+
+#endif
+
+// 1/sqrt(v) aproximado: estimacion del hardware + un paso de Newton-Raphson
+// (y <- y * (1.5 - 0.5 * v * y * y)). El paso eleva al cuadrado el error de
+// la estimacion. Error relativo medido sobre todos los floats de [1, 4):
+//     float  (rsqrtps / rsqrt14ps)      < 2^-21 (~4.8e-7)
+//     double via float (SSE2/AVX)       < 2^-22 (~2.4e-7)
+//     double con AVX-512 (rsqrt14pd)    < 2^-27 (~7.5e-9)
+// Fuera del rango normal de float, sin AVX-512, se parte de la estimacion
+// exacta, asi que el error ahi es menor.
+// v = 0 da NaN al usarse para normalizar, igual que dividir por la norma.
+template <typename T>
+inline T rsqrt_approx(T v) {
+    T y = rsqrt_estimate(v);
+    return y * (T(1.5) - T(0.5) * v * y * y);
+}
+
+template <typename T>
+inline Pack<T> rsqrt_approx(Pack<T> v) {
+    Pack<T> y = rsqrt_estimate(v);
+    return y * (Pack<T>::broadcast(T(1.5)) - Pack<T>::broadcast(T(0.5)) * v * y * y);
+}
+
+// Pide al procesador que traiga a cache la linea de p (para leer pronto).
+// Es solo una pista, pero p debe apuntar dentro del arreglo: formar un
+// puntero mas alla del final es comportamiento indefinido en C++.
+inline void prefetch(const void* p) {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(p, 0, 3);
+#else
+    (void)p;
+#endif
+}
+
+// Nombre del conjunto de instrucciones elegido (util en pruebas y benchmarks)
+inline const char* isa_name() {
+#if !defined(VECTOR3_NO_SIMD) && defined(__AVX512F__)
+    return "avx512";
+#elif !defined(VECTOR3_NO_SIMD) && defined(__AVX__)
+    return "avx";
+#elif !defined(VECTOR3_NO_SIMD) && defined(__SSE2__)
+    return "sse2";
+#else
+    return "escalar";
+#endif
+}
+
+} // namespace simd
+
+#endif
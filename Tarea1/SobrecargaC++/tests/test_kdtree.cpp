@@ -0,0 +1,135 @@
+#include "../src/kdtree.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+using geom::KdTree;
+using geom::Neighbor;
+
+// Puntos pseudoaleatorios reproducibles en [0, 10)^3 (con algunos repetidos)
+static std::vector<Vector3> make_cloud(std::size_t n, std::uint32_t seed) {
+    std::vector<Vector3> v(n);
+    auto next = [&seed] {
+        seed = seed * 1664525u + 1013904223u;
+        return (seed >> 8) * (10.0 / 16777216.0);
+    };
+    for (std::size_t i = 0; i < n; i++) v[i] = Vector3(next(), next(), next());
+    for (std::size_t i = 0; i + 7 < n; i += 97) v[i + 7] = v[i]; // duplicados
+    return v;
+}
+
+// k vecinos por fuerza bruta con los operadores de Vector3
+static std::vector<Neighbor<double>> brute_knn(const std::vector<Vector3>& pts, const Vector3& q, std::size_t k) {
+    std::vector<Neighbor<double>> all;
+    for (std::size_t i = 0; i < pts.size(); i++) all.push_back({i, (pts[i] - q).norm_squared()});
+    std::sort(all.begin(), all.end());
+    all.resize(std::min(k, all.size()));
+    return all;
+}
+
+// Prueba kNN y el vecino mas cercano contra fuerza bruta
+void test_knn() {
+    std::vector<Vector3> pts = make_cloud(3000, 7);
+    KdTree<double> tree(pts.data(), pts.size());
+    assert(tree.size() == pts.size());
+    std::vector<Vector3> queries = make_cloud(200, 99);
+    queries.push_back(pts[123]); // consulta justo sobre un punto
+    for (const Vector3& q : queries) {
+        for (std::size_t k : {1u, 5u, 16u}) {
+            std::vector<Neighbor<double>> got;
+            tree.knn(q, k, got);
+            std::vector<Neighbor<double>> want = brute_knn(pts, q, k);
+            assert(got.size() == want.size());
+            for (std::size_t i = 0; i < k; i++) {
+                assert(got[i].index == want[i].index && got[i].dist_squared == want[i].dist_squared);
+            }
+        }
+        assert(tree.nearest(q).index == brute_knn(pts, q, 1)[0].index);
+    }
+    assert(tree.nearest(pts[123]).dist_squared == 0);
+    std::cout << "Vecinos mas cercanos correctos\n";
+}
+
+// Prueba consultas por radio y por caja
+void test_radius_box() {
+    std::vector<Vector3> pts = make_cloud(2000, 3);
+    KdTree<double> tree(pts.data(), pts.size(), 1);
+    for (const Vector3& q : make_cloud(50, 5)) {
+        std::vector<std::size_t> got, want;
+        tree.radius(q, 1.5, got);
+        for (std::size_t i = 0; i < pts.size(); i++) {
+            if ((pts[i] - q).norm_squared() <= 1.5 * 1.5) want.push_back(i);
+        }
+        std::sort(got.begin(), got.end());
+        assert(got == want);
+
+        geom::AABB<double> b(q - 1.0, q + Vector3(2, 0.5, 1));
+        got.clear();
+        want.clear();
+        tree.box(b, got);
+        for (std::size_t i = 0; i < pts.size(); i++) {
+            if (b.contains(pts[i])) want.push_back(i);
+        }
+        std::sort(got.begin(), got.end());
+        assert(got == want);
+    }
+    std::cout << "Consultas por radio y por caja correctas\n";
+}
+
+// Prueba que la cantidad de hilos no cambia el arbol y las consultas en bloque
+void test_threads_batch() {
+    std::vector<Vector3> pts = make_cloud(5000, 11);
+    KdTree<double> one(pts.data(), pts.size(), 1), many(pts.data(), pts.size(), 8);
+    std::vector<Vector3> queries = make_cloud(300, 13);
+    const std::size_t k = 4;
+    std::vector<Neighbor<double>> a(queries.size() * k), b(queries.size() * k);
+    one.knn_batch(queries.data(), queries.size(), k, a.data(), 1);
+    many.knn_batch(queries.data(), queries.size(), k, b.data(), 5);
+    for (std::size_t i = 0; i < a.size(); i++) assert(a[i].index == b[i].index);
+    for (std::size_t j = 0; j < queries.size(); j++) {
+        assert(a[j * k].index == one.nearest(queries[j]).index);
+    }
+    std::vector<std::vector<std::size_t>> r;
+    many.radius_batch(queries.data(), queries.size(), 0.8, r, 3);
+    for (std::size_t j = 0; j < queries.size(); j++) {
+        std::vector<std::size_t> single;
+        one.radius(queries[j], 0.8, single);
+        std::sort(single.begin(), single.end());
+        std::sort(r[j].begin(), r[j].end());
+        assert(r[j] == single);
+    }
+    std::cout << "Construccion en paralelo y consultas en bloque correctas\n";
+}
+
+// Casos borde: arbol vacio, menos puntos que k, todos los puntos iguales
+void test_edge_cases() {
+    KdTree<double> empty;
+    assert(empty.empty());
+    std::vector<Neighbor<double>> out;
+    empty.knn({0, 0, 0}, 3, out);
+    assert(out.empty());
+    std::vector<Vector3> few = {{1, 0, 0}, {0, 2, 0}};
+    KdTree<double> small(few.data(), few.size());
+    Neighbor<double> row[4];
+    small.knn_batch(few.data(), 1, 4, row);
+    assert(row[0].index == 0 && row[1].index == 1 && row[2].dist_squared == geom::Vector3Traits<double>::max_value());
+    std::vector<Vector3> same(100, Vector3(1, 1, 1));
+    KdTree<double> flat(same.data(), same.size());
+    flat.knn({1, 1, 1}, 3, out);
+    assert(out[0].index == 0 && out[1].index == 1 && out[2].index == 2);
+    KdTree<float> f(std::vector<Vector3f>{{0, 0, 0}, {5, 5, 5}}.data(), 2);
+    assert(f.nearest({4, 4, 4}).index == 1);
+    std::cout << "Casos borde del arbol correctos\n";
+}
+
+int main() {
+    test_knn();
+    test_radius_box();
+    test_threads_batch();
+    test_edge_cases();
+
+    std::cout << "\nTodas las pruebas del arbol k-d pasaron correctamente\n";
+    return 0;
+}
@@ -0,0 +1,101 @@
+#include "../src/transform.hpp"
+#include <cassert>
+#include <cmath>
+#include <iostream>
+
+using geom::Mat3;
+using geom::Mat4;
+using geom::Quat;
+
+const double pi = 3.14159265358979323846;
+
+// Prueba matrices 3x3: identidad, escala, rotacion y composicion
+void test_mat3() {
+    Vector3 v(1, 2, 3);
+    assert((Mat3<double>() * v).equals(v));
+    assert((Mat3<double>::scale(2, 3, -1) * v).equals({2, 6, -3}));
+    Mat3<double> rz = Mat3<double>::rotation({0, 0, 1}, pi / 2);
+    assert((rz * Vector3(1, 0, 0)).equals({0, 1, 0}));
+    assert((rz * Vector3(0, 1, 0)).equals({-1, 0, 0}));
+    // El eje no tiene que ser unitario y la rotacion conserva la norma
+    Mat3<double> r = Mat3<double>::rotation({1, 1, 1}, 0.7);
+    assert(std::fabs(&(r * v) - &v) < 1e-12);
+    assert(std::fabs(r.determinant() - 1) < 1e-12);
+    assert((r * r.transpose()).equals(Mat3<double>::identity()));
+    assert(((r * rz) * v).equals(r * (rz * v)));
+    std::cout << "Matrices 3x3 correctas\n";
+}
+
+// Prueba cuaterniones contra las matrices equivalentes
+void test_quat() {
+    Vector3 v(1, -2, 0.5);
+    Quat<double> q = Quat<double>::from_axis_angle({0, 0, 1}, pi / 2);
+    assert(q.rotate({1, 0, 0}).equals({0, 1, 0}));
+    Quat<double> a = Quat<double>::from_axis_angle({1, 2, 3}, 0.9);
+    Quat<double> b = Quat<double>::from_axis_angle({-1, 0, 2}, 2.1);
+    assert(a.rotate(v).equals(Mat3<double>::rotation({1, 2, 3}, 0.9) * v));
+    assert(a.rotate(v).equals(a.to_mat3() * v));
+    assert((a * b).rotate(v).equals(a.rotate(b.rotate(v))));
+    assert(a.conjugate().rotate(a.rotate(v)).equals(v));
+    assert(Quat<double>(2, 0, 0, 0).normalized().equals(Quat<double>::identity()));
+    std::cout << "Cuaterniones correctos\n";
+}
+
+// Prueba matrices 4x4: traslacion, composicion y perspectiva
+void test_mat4() {
+    Vector3 p(1, 2, 3);
+    Mat4<double> t = Mat4<double>::translation({10, 0, -1});
+    assert(t.transform_point(p).equals({11, 2, 2}));
+    assert(t.transform_direction(p).equals(p));
+    Mat4<double> rt(Mat3<double>::rotation({0, 0, 1}, pi / 2), {1, 1, 1});
+    assert((t * rt).transform_point(p).equals(t.transform_point(rt.transform_point(p))));
+    assert(rt.is_affine());
+    Mat4<double> proj = Mat4<double>::perspective(pi / 2, 1, 1, 100);
+    assert(!proj.is_affine());
+    // Los planos cercano y lejano quedan en z = -1 y z = 1
+    assert(std::fabs(proj.transform_point({0, 0, -1}).z + 1) < 1e-12);
+    assert(std::fabs(proj.transform_point({0, 0, -100}).z - 1) < 1e-12);
+    assert(proj.transform_point({1, 1, -1}).equals({1, 1, -1}));
+    std::cout << "Matrices 4x4 correctas\n";
+}
+
+// Prueba los kernels en bloque contra la version por vector
+template <typename T>
+void check_batch_transform(const char* name) {
+    geom::Vector3Batch<T> a, out;
+    for (int i = 0; i < 37; i++) a.push_back({T(i * 0.25), T(1 - i * 0.5), T(3 + i * 0.125)});
+    const T eps = geom::Vector3Traits<T>::default_eps() * T(10);
+
+    Mat3<T> m = Mat3<T>::rotation({T(1), T(2), T(-1)}, T(0.4)) * Mat3<T>::scale(T(2), T(1), T(0.5));
+    geom::batch_transform(m, a, out);
+    for (std::size_t i = 0; i < a.size(); i++) assert(out.get(i).equals(m * a.get(i), eps));
+
+    Quat<T> q = Quat<T>::from_axis_angle({T(0), T(1), T(1)}, T(1.3));
+    geom::batch_rotate(q, a, out);
+    for (std::size_t i = 0; i < a.size(); i++) assert(out.get(i).equals(q.rotate(a.get(i)), eps));
+
+    Mat4<T> affine(m, {T(1), T(-2), T(3)});
+    geom::batch_transform_point(affine, a, out);
+    for (std::size_t i = 0; i < a.size(); i++) assert(out.get(i).equals(affine.transform_point(a.get(i)), eps));
+
+    Mat4<T> proj = Mat4<T>::perspective(T(1.2), T(1.5), T(0.5), T(50)) * Mat4<T>::translation({T(0), T(0), T(-60)});
+    geom::batch_transform_point(proj, a, out);
+    for (std::size_t i = 0; i < a.size(); i++) assert(out.get(i).equals(proj.transform_point(a.get(i)), eps));
+
+    // En el lugar (la salida es la misma entrada)
+    geom::Vector3Batch<T> b = a;
+    geom::batch_transform(m, b, b);
+    for (std::size_t i = 0; i < a.size(); i++) assert(b.get(i).equals(m * a.get(i), eps));
+    std::cout << "Transformaciones en bloque de " << name << " correctas\n";
+}
+
+int main() {
+    test_mat3();
+    test_quat();
+    test_mat4();
+    check_batch_transform<double>("double");
+    check_batch_transform<float>("float");
+
+    std::cout << "\nTodas las pruebas de transformaciones pasaron correctamente\n";
+    return 0;
+}
@@ -205,6 +205,53 @@ void test_small_numbers() {
     std::cout << "Numeros pequenos correctos\n";
 }
 
+// Prueba de norma al cuadrado y normalizacion
+void test_normalized() {
+    Vector3 a(3, 4, 12);
+    assert(std::fabs(a.norm_squared() - 169.0) < EPS);
+    Vector3 unit = a.normalized();
+    assert(unit.equals(a / &a, EPS));
+    assert(std::fabs(&unit - 1.0) < EPS);
+    assert(Vector3(0, 0, -5).normalized().equals({0, 0, -1}, EPS));
+    std::cout << "Normalizacion correcta\n";
+}
+
+// Prueba del modo aproximado (rsqrt + Newton) con su cota de error
+void test_approx_norm() {
+    const double bound = 4.8e-7; // 2^-21, ver simd::rsqrt_approx
+    const Vector3 samples[] = {{1, 0, 0}, {3, 4, 12}, {1e-3, 2e-3, -5e-4}, {123.5, -7, 0.25}, {1e6, 1e6, 1}};
+    for (const Vector3& v : samples) {
+        double exact = &v;
+        assert(std::fabs(v.norm_approx() - exact) <= bound * exact);
+        Vector3 unit = v.normalized_approx();
+        assert(unit.equals(v.normalized(), EPS));
+        assert(std::fabs(&unit - 1.0) <= bound);
+    }
+    // Fuera del rango de float (los doubles sin AVX-512 pasan por float)
+    const Vector3 extremes[] = {{1e30, 0, 0}, {0, -1e-25, 0}, {1e150, 1e150, 1e150}, {3e-150, 0, 4e-150}};
+    for (const Vector3& v : extremes) {
+        double exact = &v;
+        assert(std::fabs(v.norm_approx() - exact) <= bound * exact);
+        assert(std::fabs(&v.normalized_approx() - 1.0) <= bound);
+    }
+    // Floats con |v|^2 subnormal o cerca de FLT_MAX (rsqrtps da inf con
+    // subnormales). Multiplicar por un subnormal suma redondeo: cota 2^-20
+    const Vector3f fextremes[] = {{1e-20f, 0, 0}, {0, 2e-20f, -3e-20f}, {1e19f, 0, 0}, {1e19f, -1e19f, 5e18f}};
+    for (const Vector3f& v : fextremes) {
+        float exact = &v;
+        assert(std::fabs(v.norm_approx() - exact) <= 9.6e-7f * exact);
+        // Con |v|^2 subnormal ni normalized() da norma 1 exacta: se compara con ella
+        assert(v.normalized_approx().equals(v.normalized()));
+    }
+    // El vector cero tiene norma 0, no NaN
+    assert(Vector3(0, 0, 0).norm_approx() == 0.0);
+    assert(Vector3f(0, 0, 0).norm_approx() == 0.0f);
+    Vector3f f(3, 4, 12);
+    assert(std::fabs(f.norm_approx() - 13.0f) <= 13.0f * 5e-7f);
+    assert(f.normalized_approx().equals(f.normalized()));
+    std::cout << "Norma aproximada correcta\n";
+}
+
 // main desordenado, igual funciona
 int main() {
     test_constructors();
@@ -225,6 +272,8 @@ int main() {
     test_unit_vectors();
     test_large_numbers();
     test_small_numbers();
+    test_normalized();
+    test_approx_norm();
 
     // Mensaje final
     std::cout << "\nTodas las pruebas pasaron correctamente\n";
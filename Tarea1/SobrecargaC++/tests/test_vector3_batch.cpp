@@ -0,0 +1,173 @@
+#include "../src/vector3_batch.hpp"
+#include <cassert>
+#include <iostream>
+#include <cmath>
+#include <vector>
+#include <cstdint>
+#include <stdexcept>
+
+#define EPS 1e-6 // Misma tolerancia que las pruebas de Vector3
+
+// Tamanos que dejan cola escalar con cualquier ancho de registro (1, 2, 4, 8)
+static const std::size_t SIZES[] = {0, 1, 3, 7, 8, 13, 64, 1000};
+
+// Llena un lote con valores "raros" pero deterministas
+Vector3Batch make_batch(std::size_t n, double seed) {
+    Vector3Batch b;
+    for (std::size_t i = 0; i < n; i++) {
+        double t = seed + i * 0.37;
+        b.push_back({std::sin(t) * 10, std::cos(t * 1.3) * 5 - 1, t - 20});
+    }
+    return b;
+}
+
+// Prueba de alineacion y acceso individual
+void test_batch_layout() {
+    Vector3Batch b(5);
+    assert(b.size() == 5);
+    assert(reinterpret_cast<std::uintptr_t>(b.x()) % Vector3Batch::alignment == 0);
+    assert(reinterpret_cast<std::uintptr_t>(b.y()) % Vector3Batch::alignment == 0);
+    assert(reinterpret_cast<std::uintptr_t>(b.z()) % Vector3Batch::alignment == 0);
+    b.set(2, {1, 2, 3});
+    assert(b.get(2).equals({1, 2, 3}, EPS));
+    assert(b.get(0).equals({0, 0, 0}, EPS));
+    b.push_back({4, 5, 6});
+    assert(b.size() == 6 && b.get(5).equals({4, 5, 6}, EPS));
+    std::cout << "Lote alineado correcto\n";
+}
+
+// Prueba de suma en bloque contra el operador +
+void test_batch_add() {
+    for (std::size_t n : SIZES) {
+        Vector3Batch a = make_batch(n, 0.5), b = make_batch(n, 2.0), out;
+        batch_add(a, b, out);
+        assert(out.size() == n);
+        for (std::size_t i = 0; i < n; i++) {
+            assert(out.get(i).equals(a.get(i) + b.get(i), EPS));
+        }
+    }
+    std::cout << "Suma en bloque correcta\n";
+}
+
+// Prueba de multiplicacion por escalar en bloque
+void test_batch_scale() {
+    for (std::size_t n : SIZES) {
+        Vector3Batch a = make_batch(n, 1.5), out;
+        batch_scale(a, -2.5, out);
+        for (std::size_t i = 0; i < n; i++) {
+            assert(out.get(i).equals(a.get(i) * -2.5, EPS));
+        }
+    }
+    std::cout << "Escalar en bloque correcto\n";
+}
+
+// Prueba de producto cruz en bloque (incluye salida igual a la entrada)
+void test_batch_cross() {
+    for (std::size_t n : SIZES) {
+        Vector3Batch a = make_batch(n, 0.1), b = make_batch(n, 3.3), out;
+        batch_cross(a, b, out);
+        for (std::size_t i = 0; i < n; i++) {
+            assert(out.get(i).equals(a.get(i) * b.get(i), EPS));
+        }
+        Vector3Batch a2 = a;
+        batch_cross(a2, b, a2);
+        for (std::size_t i = 0; i < n; i++) {
+            assert(a2.get(i).equals(a.get(i) * b.get(i), EPS));
+        }
+    }
+    std::cout << "Producto cruz en bloque correcto\n";
+}
+
+// Prueba de producto punto y norma en bloque
+void test_batch_dot_norm() {
+    for (std::size_t n : SIZES) {
+        Vector3Batch a = make_batch(n, 4.0), b = make_batch(n, -1.0);
+        std::vector<double> dots(n), norms(n);
+        batch_dot(a, b, dots.data());
+        batch_norm(a, norms.data());
+        for (std::size_t i = 0; i < n; i++) {
+            assert(std::fabs(dots[i] - (a.get(i) % b.get(i))) < EPS);
+            assert(std::fabs(norms[i] - &a.get(i)) < EPS);
+        }
+    }
+    std::cout << "Producto punto y norma en bloque correctos\n";
+}
+
+// Prueba de normalizacion en bloque
+void test_batch_normalize() {
+    for (std::size_t n : SIZES) {
+        Vector3Batch a = make_batch(n, 7.0), out;
+        batch_normalize(a, out);
+        for (std::size_t i = 0; i < n; i++) {
+            Vector3 v = a.get(i);
+            assert(out.get(i).equals(v / &v, EPS));
+            assert(std::fabs(&out.get(i) - 1.0) < EPS);
+        }
+    }
+    std::cout << "Normalizacion en bloque correcta\n";
+}
+
+// Prueba de norma al cuadrado y normalizacion aproximada en bloque
+void test_batch_approx() {
+    for (std::size_t n : SIZES) {
+        Vector3Batch a = make_batch(n, 2.5), out;
+        std::vector<double> squares(n);
+        batch_norm_squared(a, squares.data());
+        batch_normalize_approx(a, out);
+        for (std::size_t i = 0; i < n; i++) {
+            Vector3 v = a.get(i);
+            assert(std::fabs(squares[i] - v.norm_squared()) <= 1e-12 * squares[i]);
+            // El bloque usa la misma instruccion que la version por objeto
+            assert(out.get(i).equals(v.normalized_approx(), 1e-12));
+            assert(out.get(i).equals(v.normalized(), EPS));
+        }
+    }
+    // Normas fuera del rango de float mezcladas con normas comunes
+    Vector3Batch mixed, out;
+    for (int i = 0; i < 11; i++)
+        mixed.push_back(i % 3 == 0 ? Vector3(1e30, 0, i) : i % 3 == 1 ? Vector3(0, 1e-25, 0) : Vector3(i, 1, 2));
+    batch_normalize_approx(mixed, out);
+    for (std::size_t i = 0; i < mixed.size(); i++) {
+        assert(out.get(i).equals(mixed.get(i).normalized_approx(), 1e-12));
+        assert(std::fabs(&out.get(i) - 1.0) < EPS);
+    }
+    // Lo mismo en float: normas al cuadrado subnormales y cerca de FLT_MAX
+    Vector3fBatch fmixed, fout;
+    for (int i = 0; i < 19; i++)
+        fmixed.push_back(i % 3 == 0 ? Vector3f(1e19f, 0, i) : i % 3 == 1 ? Vector3f(0, 1e-20f, 0) : Vector3f(i, 1, 2));
+    batch_normalize_approx(fmixed, fout);
+    for (std::size_t i = 0; i < fmixed.size(); i++) {
+        assert(fout.get(i).equals(fmixed.get(i).normalized_approx(), 1e-6f));
+        assert(fout.get(i).equals(fmixed.get(i).normalized(), 1e-6f));
+    }
+    std::cout << "Normalizacion aproximada en bloque correcta\n";
+}
+
+// Lotes de distinto tamano se rechazan tambien sin asserts (con NDEBUG),
+// igual que en las plantillas de expresion
+void test_batch_sizes() {
+    Vector3Batch a = make_batch(5, 0.5), b = make_batch(8, 2.0), out = make_batch(3, 1.0);
+    int thrown = 0;
+    try { batch_add(a, b, out); } catch (const std::invalid_argument&) { thrown++; }
+    try { batch_cross(b, a, out); } catch (const std::invalid_argument&) { thrown++; }
+    std::vector<double> dots(8);
+    try { batch_dot(a, b, dots.data()); } catch (const std::invalid_argument&) { thrown++; }
+    assert(thrown == 3);
+    assert(out.size() == 3); // La salida no se toca
+    std::cout << "Tamanos de lotes validados\n";
+}
+
+int main() {
+    std::cout << "Conjunto de instrucciones: " << simd::isa_name() << "\n";
+    test_batch_layout();
+    test_batch_add();
+    test_batch_scale();
+    test_batch_cross();
+    test_batch_dot_norm();
+    test_batch_normalize();
+    test_batch_approx();
+    test_batch_sizes();
+
+    std::cout << "\nTodas las pruebas de lotes pasaron correctamente\n";
+    return 0;
+}
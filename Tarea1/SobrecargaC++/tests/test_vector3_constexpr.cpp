@@ -0,0 +1,94 @@
+#include "../src/vector3.hpp"
+#include <cassert>
+#include <iostream>
+#include <cmath>
+
+// Estas pruebas se verifican al compilar: si algun static_assert falla, el
+// archivo no compila. El main solo confirma en tiempo de ejecucion que los
+// valores calculados en compilacion coinciden con los normales.
+
+#define EPS 1e-6 // Tolerancia para comparaciones de punto flotante
+
+// Base canonica y ejes de rotacion conocidos en compilacion
+constexpr Vector3 X_AXIS(1, 0, 0);
+constexpr Vector3 Y_AXIS(0, 1, 0);
+constexpr Vector3 Z_AXIS(0, 0, 1);
+
+// Constructores
+static_assert(Vector3().equals({0, 0, 0}), "constructor por defecto");
+static_assert(Vector3(1.5, 2.5, 3.5).x == 1.5, "constructor con parametros");
+
+// Operaciones entre vectores
+static_assert((X_AXIS + Y_AXIS).equals({1, 1, 0}), "suma");
+static_assert((Vector3(5, 4, 3) - Vector3(1, 2, 3)).equals({4, 2, 0}), "resta");
+static_assert((X_AXIS * Y_AXIS).equals(Z_AXIS), "producto cruz x*y = z");
+static_assert((Y_AXIS * Z_AXIS).equals(X_AXIS), "producto cruz y*z = x");
+static_assert((Vector3(1, 2, 3) % Vector3(4, -5, 6)) == 12, "producto punto");
+
+// Operaciones con escalares
+static_assert((Vector3(1, 2, 3) + 3.0).equals({4, 5, 6}), "suma escalar");
+static_assert((Vector3(1, 2, 3) - 1.0).equals({0, 1, 2}), "resta escalar");
+static_assert((Vector3(1, 2, 3) * 2.0).equals({2, 4, 6}), "multiplicacion escalar");
+static_assert((Vector3(1, 2, 3) / 2.0).equals({0.5, 1.0, 1.5}), "division escalar");
+
+// Expresion del demo de vector3.cpp, completa en compilacion
+static_assert(((Y_AXIS + Y_AXIS) * (Z_AXIS - X_AXIS)).equals({2, 0, 2}), "expresion mixta");
+
+// Norma y raiz cuadrada en constexpr
+static_assert(Vector3(3, 4, 0).norm_constexpr() == 5.0, "norma 3-4-5");
+static_assert(Vector3::sqrt_constexpr(0.0) == 0.0, "raiz de cero");
+static_assert(Vector3::abs_constexpr(Vector3::sqrt_constexpr(2.0) * Vector3::sqrt_constexpr(2.0) - 2.0) < 1e-15, "raiz de dos");
+static_assert(Vector3::abs_constexpr(Vector3::sqrt_constexpr(1e-12) - 1e-6) < 1e-18, "raiz de numero pequeno");
+static_assert(Vector3::sqrt_constexpr(-1.0) != Vector3::sqrt_constexpr(-1.0), "raiz de negativo es NaN");
+
+// equals con tolerancia
+static_assert(Vector3(1, 2, 3).equals({1.0000005, 2.0000005, 3.0000005}), "equals dentro de eps");
+static_assert(!Vector3(1, 2, 3).equals({1.1, 2.1, 3.1}), "equals fuera de eps");
+static_assert(Vector3(1, 2, 3).equals({1.1, 2.1, 3.1}, 0.2), "equals con eps propio");
+
+// Todo es noexcept
+static_assert(noexcept(X_AXIS + Y_AXIS), "suma noexcept");
+static_assert(noexcept(X_AXIS * Y_AXIS), "cruz noexcept");
+static_assert(noexcept(X_AXIS % Y_AXIS), "punto noexcept");
+static_assert(noexcept(&X_AXIS), "norma noexcept");
+static_assert(noexcept(X_AXIS.equals(Y_AXIS)), "equals noexcept");
+
+// Tabla generada en compilacion: direcciones de un octaedro normalizadas
+struct DirectionTable {
+    Vector3 dirs[8];
+};
+
+constexpr DirectionTable make_octant_table() {
+    DirectionTable t{};
+    for (int i = 0; i < 8; i++) {
+        Vector3 d((i & 1) ? -1.0 : 1.0, (i & 2) ? -1.0 : 1.0, (i & 4) ? -1.0 : 1.0);
+        t.dirs[i] = d / d.norm_constexpr();
+    }
+    return t;
+}
+
+constexpr DirectionTable OCTANTS = make_octant_table();
+static_assert(Vector3::abs_constexpr(OCTANTS.dirs[0].norm_constexpr() - 1.0) < 1e-15, "tabla normalizada");
+static_assert(OCTANTS.dirs[7].equals(OCTANTS.dirs[0] * -1.0), "octantes opuestos");
+
+// Comparacion con la norma de tiempo de ejecucion
+void test_constexpr_matches_runtime() {
+    const double values[] = {0.0, 1e-300, 1e-12, 0.5, 2.0, 3.0, 1e6, 1e300};
+    for (double v : values) {
+        assert(Vector3::sqrt_constexpr(v) == std::sqrt(v) ||
+               std::fabs(Vector3::sqrt_constexpr(v) - std::sqrt(v)) <= std::sqrt(v) * 1e-15);
+    }
+    Vector3 a(1, 2, 3);
+    assert(std::fabs(a.norm_constexpr() - &a) < EPS);
+    for (const Vector3& d : OCTANTS.dirs) {
+        assert(std::fabs(&d - 1.0) < EPS);
+    }
+    std::cout << "Constexpr coincide con tiempo de ejecucion\n";
+}
+
+int main() {
+    test_constexpr_matches_runtime();
+
+    std::cout << "\nTodas las pruebas constexpr pasaron correctamente\n";
+    return 0;
+}
@@ -0,0 +1,152 @@
+#include "../src/vector3_expr.hpp"
+#include <cassert>
+#include <iostream>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+#define EPS 1e-6 // Misma tolerancia que las pruebas de Vector3
+
+// Llena un lote con valores deterministas
+Vector3Batch make_batch(std::size_t n, double seed) {
+    Vector3Batch b;
+    for (std::size_t i = 0; i < n; i++) {
+        double t = seed + i * 0.61;
+        b.push_back({std::cos(t) * 3, t * 0.5 - 4, std::sin(t * 2.1) * 7});
+    }
+    return b;
+}
+
+// Prueba de la expresion del demo: (b + b) * (c - a)
+void test_expr_demo() {
+    Vector3 a(1, 0, 0);
+    Vector3 b(0, 1, 0);
+    Vector3 c(0, 0, 1);
+    Vector3 lazy_result = (lazy(b) + b) * (lazy(c) - a);
+    Vector3 eager_result = (b + b) * (c - a);
+    assert(lazy_result.equals(eager_result, EPS));
+    assert(lazy_result.equals({2, 0, 2}, EPS));
+    std::cout << "Expresion del demo correcta\n";
+}
+
+// Prueba de operaciones con escalares y mezcla de Vector3 con expresiones
+void test_expr_scalars() {
+    Vector3 a(1, 2, 3);
+    Vector3 b(4, 5, 6);
+    Vector3 r = lazy(a) * 2.0 + b / 2.0;
+    assert(r.equals(a * 2.0 + b / 2.0, EPS));
+    r = (lazy(a) + 3.0) - 1.0;
+    assert(r.equals({3, 4, 5}, EPS));
+    r = a - lazy(b) / 4.0;
+    assert(r.equals(a - b / 4.0, EPS));
+    std::cout << "Escalares en expresiones correctos\n";
+}
+
+// Prueba de producto punto y norma perezosos
+void test_expr_dot_norm() {
+    Vector3 a(1, 2, 3);
+    Vector3 b(4, -5, 6);
+    double dot = (lazy(a) + b) % (lazy(b) - a);
+    assert(std::fabs(dot - ((a + b) % (b - a))) < EPS);
+    double norm = &(lazy(a) * b);
+    assert(std::fabs(norm - &(a * b)) < EPS);
+    // Un escalar perezoso tambien puede escalar un vector
+    Vector3 unit = lazy(a) / &lazy(a);
+    assert(unit.equals(a / &a, EPS));
+    assert(std::fabs(eval(lazy(a) % a + 1.0) - 15.0) < EPS);
+    std::cout << "Punto y norma perezosos correctos\n";
+}
+
+// Prueba de expresiones sobre lotes completos
+void test_expr_batch() {
+    const std::size_t sizes[] = {0, 1, 5, 8, 17, 300};
+    Vector3 offset(0.5, -1, 2);
+    for (std::size_t n : sizes) {
+        Vector3Batch a = make_batch(n, 0.2), b = make_batch(n, 1.7), out;
+        assign(out, (lazy(a) + b) * (lazy(b) - offset) * 0.5);
+        assert(out.size() == n);
+        for (std::size_t i = 0; i < n; i++) {
+            Vector3 expected = (a.get(i) + b.get(i)) * (b.get(i) - offset) * 0.5;
+            assert(out.get(i).equals(expected, EPS));
+        }
+
+        std::vector<double> dots(n);
+        assign(dots.data(), (lazy(a) * b) % offset / &lazy(a));
+        for (std::size_t i = 0; i < n; i++) {
+            double expected = ((a.get(i) * b.get(i)) % offset) / &a.get(i);
+            assert(std::fabs(dots[i] - expected) < EPS);
+        }
+
+        // La salida puede ser una de las entradas
+        Vector3Batch a2 = a;
+        assign(a2, lazy(a2) * b + a2);
+        for (std::size_t i = 0; i < n; i++) {
+            assert(a2.get(i).equals(a.get(i) * b.get(i) + a.get(i), EPS));
+        }
+    }
+    std::cout << "Expresiones sobre lotes correctas\n";
+}
+
+// Los tamanos se validan tambien sin asserts (compilando con NDEBUG)
+void test_expr_batch_sizes() {
+    Vector3Batch a = make_batch(5, 0.2), b = make_batch(8, 1.7), out;
+    bool threw = false;
+    try {
+        assign(out, lazy(a) + b);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw && out.empty());
+
+    threw = false;
+    std::vector<double> dots(8);
+    try {
+        assign(dots.data(), lazy(a) % b);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw);
+
+    // Una salida con otro tamano no se achica ni se agranda
+    out = make_batch(3, 0.9);
+    threw = false;
+    try {
+        assign(out, lazy(a) * 2.0);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw && out.size() == 3);
+
+    // Sin lotes en la expresion, el valor se repite en toda la salida
+    Vector3 offset(0.5, -1, 2);
+    out = make_batch(7, 0.9);
+    assign(out, lazy(offset) * 2.0 + Vector3(1, 1, 1));
+    assert(out.size() == 7);
+    for (std::size_t i = 0; i < out.size(); i++) {
+        assert(out.get(i).equals(Vector3(2, -1, 5), EPS));
+    }
+    std::cout << "Tamanos de lotes validados\n";
+}
+
+// Los operadores normales de Vector3 siguen devolviendo Vector3
+void test_expr_does_not_change_eager_ops() {
+    Vector3 a(1, 2, 3);
+    Vector3 b(4, 5, 6);
+    auto sum = a + b;
+    auto cross = a * b;
+    static_assert(std::is_same<decltype(sum), Vector3>::value, "a + b debe ser Vector3");
+    static_assert(std::is_same<decltype(cross), Vector3>::value, "a * b debe ser Vector3");
+    std::cout << "Operadores normales intactos\n";
+}
+
+int main() {
+    test_expr_demo();
+    test_expr_scalars();
+    test_expr_dot_norm();
+    test_expr_batch();
+    test_expr_batch_sizes();
+    test_expr_does_not_change_eager_ops();
+
+    std::cout << "\nTodas las pruebas de expresiones pasaron correctamente\n";
+    return 0;
+}
@@ -0,0 +1,102 @@
+#include "../src/vector3_io.hpp"
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+// Prueba que el texto vuelve exactamente al mismo vector
+void test_text_roundtrip() {
+    const Vector3 vs[] = {{1, 2, 3}, {0.1, -2.5e-300, 1e308}, {1.0 / 3, -0.0, 123456789.125}};
+    for (const Vector3& v : vs) {
+        char buf[128];
+        char* end = geom::to_chars(buf, buf + sizeof(buf), v);
+        assert(end != nullptr);
+        Vector3 back;
+        assert(geom::from_chars(buf, end, back) == end);
+        assert(back.x == v.x && back.y == v.y && back.z == v.z);
+    }
+    char buf[32];
+    assert(std::strncmp(buf, "1 2 3", (geom::to_chars(buf, buf + sizeof(buf), Vector3(1, 2, 3)) - buf)) == 0);
+    // Sin espacio suficiente no escribe de mas
+    assert(geom::to_chars(buf, buf + 4, Vector3(1, 2, 3)) == nullptr);
+    std::cout << "Texto ida y vuelta correcto\n";
+}
+
+// Prueba el parseo de varias lineas y el reporte de errores
+void test_parse_text() {
+    const char text[] = "1 2 3\n\n  4\t5 6\r\n-1.5 0 2e3\n7 8 x\n";
+    Vector3 out[8];
+    const char* end = nullptr;
+    std::size_t n = geom::parse_text(text, text + std::strlen(text), out, 8, &end);
+    assert(n == 3);
+    assert(out[1].equals({4, 5, 6}));
+    assert(out[2].equals({-1.5, 0, 2000}));
+    assert(std::strncmp(end, "7 8 x", 5) == 0); // se detuvo en la linea mala
+    // Respeta la capacidad del buffer
+    assert(geom::parse_text(text, text + std::strlen(text), out, 2) == 2);
+    Vector3f f;
+    assert(geom::from_chars("0.5 1 -2", "0.5 1 -2" + 8, f) != nullptr && f.equals({0.5f, 1, -2}));
+    std::cout << "Parseo de texto correcto\n";
+}
+
+// Prueba write_text contra parse_text con suficientes vectores para vaciar el buffer varias veces
+void test_write_text() {
+    std::vector<Vector3> vs;
+    for (int i = 0; i < 5000; i++) vs.push_back({i * 0.1, -i / 7.0, 1e10 / (i + 1)});
+    std::FILE* f = std::tmpfile();
+    assert(geom::write_text(f, vs.data(), vs.size()) == vs.size());
+    long size = std::ftell(f);
+    std::vector<char> text(size);
+    std::rewind(f);
+    assert(std::fread(text.data(), 1, size, f) == static_cast<std::size_t>(size));
+    std::fclose(f);
+    std::vector<Vector3> back(vs.size());
+    assert(geom::parse_text(text.data(), text.data() + size, back.data(), back.size()) == vs.size());
+    for (std::size_t i = 0; i < vs.size(); i++) {
+        assert(back[i].x == vs[i].x && back[i].y == vs[i].y && back[i].z == vs[i].z);
+    }
+    std::cout << "Escritura de texto en bloque correcta\n";
+}
+
+// Prueba el formato binario con lectura normal y con mmap
+void test_binary() {
+    const char* path = "vector3_io_test.bin";
+    std::vector<Vector3> vs;
+    for (int i = 0; i < 1000; i++) vs.push_back({i * 1.5, -i * 0.25, i / 3.0});
+    assert(geom::write_binary(path, vs.data(), vs.size()));
+
+    std::vector<Vector3> back(vs.size());
+    assert(geom::read_binary(path, back.data(), back.size()) == 1000);
+    assert(std::memcmp(back.data(), vs.data(), vs.size() * sizeof(Vector3)) == 0);
+    // Otro tipo de componente no se acepta
+    Vector3f wrong[1];
+    assert(geom::read_binary(path, wrong, 1) == -1);
+
+#ifdef VECTOR3_IO_HAS_MMAP
+    {
+        geom::MappedVector3File<double> file(path);
+        assert(file.is_open());
+        assert(file.size() == vs.size());
+        assert(reinterpret_cast<std::uintptr_t>(file.data()) % 64 == 0);
+        std::size_t i = 0;
+        for (const Vector3& v : file) assert(v.equals(vs[i++]));
+        geom::MappedVector3File<float> as_float(path);
+        assert(!as_float.is_open() && std::strlen(as_float.error()) > 0);
+    }
+    geom::MappedVector3File<double> missing("no_existe.bin");
+    assert(!missing.is_open());
+#endif
+    std::remove(path);
+    std::cout << "Formato binario correcto\n";
+}
+
+int main() {
+    test_text_roundtrip();
+    test_parse_text();
+    test_write_text();
+    test_binary();
+
+    std::cout << "\nTodas las pruebas de entrada/salida pasaron correctamente\n";
+    return 0;
+}
@@ -0,0 +1,97 @@
+#include "../src/vector3_reduce.hpp"
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+// Datos con valores que no se suman exactos, para notar si cambia el orden
+static std::vector<Vector3> make_points(std::size_t n) {
+    std::vector<Vector3> v(n);
+    for (std::size_t i = 0; i < n; i++) {
+        double t = double(i);
+        v[i] = Vector3(0.1 * t, std::sin(t) * 3.7, 1.0 / (t + 1.0));
+    }
+    return v;
+}
+
+static bool same_bits(const Vector3& a, const Vector3& b) {
+    // operator& es la norma: la direccion se toma con std::addressof
+    return std::memcmp(std::addressof(a), std::addressof(b), sizeof(Vector3)) == 0;
+}
+
+// Prueba suma y promedio contra valores conocidos
+void test_sum_mean() {
+    std::vector<Vector3> v = {{1, 2, 3}, {4, 5, 6}, {-2, 0, 1}};
+    assert(geom::reduce_sum(v.data(), v.size()).equals({3, 7, 10}));
+    assert(geom::reduce_mean(v.data(), v.size()).equals({1, 7.0 / 3, 10.0 / 3}));
+    assert(geom::reduce_sum(v.data(), 0).equals({0, 0, 0}));
+    assert(geom::reduce_mean(v.data(), 0).equals({0, 0, 0}));
+    // Muchos 0.1: la suma por pares queda mucho mas cerca que el ciclo simple
+    std::vector<Vector3> tenths(1000000, Vector3(0.1, 0.1, 0.1));
+    Vector3 naive;
+    for (const Vector3& p : tenths) naive = naive + p;
+    Vector3 s = geom::reduce_sum(tenths.data(), tenths.size());
+    assert(std::fabs(s.x - 100000.0) < 1e-8);
+    assert(std::fabs(s.x - 100000.0) < std::fabs(naive.x - 100000.0));
+    std::cout << "Suma y promedio correctos\n";
+}
+
+// Prueba que el resultado no depende de la cantidad de hilos
+void test_thread_independence() {
+    std::vector<Vector3> v = make_points(100003);
+    Vector3 s1 = geom::reduce_sum(v.data(), v.size(), 1);
+    double d1 = geom::reduce_dot(v.data(), v.data() + 1, v.size() - 1, 1);
+    for (unsigned t : {2u, 3u, 7u, 16u, 0u}) {
+        assert(same_bits(geom::reduce_sum(v.data(), v.size(), t), s1));
+        assert(geom::reduce_dot(v.data(), v.data() + 1, v.size() - 1, t) == d1);
+    }
+    std::cout << "Resultados iguales con cualquier cantidad de hilos\n";
+}
+
+// Prueba caja envolvente y normas extremas
+void test_bounds_norms() {
+    std::vector<Vector3> v = make_points(50000);
+    v[31337] = Vector3(-100, 0, 0);
+    v[40000] = Vector3(0, 0, 1e6);
+    geom::AABB<double> box = geom::reduce_bounds(v.data(), v.size(), 4);
+    assert(box.min.x == -100 && box.max.z == 1e6);
+    for (const Vector3& p : v) assert(box.contains(p));
+    assert(geom::reduce_bounds(v.data(), 0).empty());
+
+    geom::NormRange<double> r = geom::reduce_norm_range(v.data(), v.size(), 3);
+    assert(r.max_index == 40000 && r.max == 1e6);
+    std::size_t min_i = 0;
+    for (std::size_t i = 1; i < v.size(); i++) {
+        if (v[i].norm_squared() < v[min_i].norm_squared()) min_i = i;
+    }
+    assert(r.min_index == min_i && r.min == &v[min_i]);
+    // Empate: se queda con el primer indice
+    std::vector<Vector3> ties(10000, Vector3(1, 0, 0));
+    r = geom::reduce_norm_range(ties.data(), ties.size(), 4);
+    assert(r.min_index == 0 && r.max_index == 0);
+    std::cout << "Caja envolvente y normas extremas correctas\n";
+}
+
+// Prueba el producto punto acumulado y las reducciones con otros tipos
+void test_dot_types() {
+    std::vector<Vector3> a = {{1, 2, 3}, {4, 5, 6}}, b = {{1, 0, 0}, {0, 1, 1}};
+    assert(geom::reduce_dot(a.data(), b.data(), 2) == 1 + 11);
+    std::vector<Vector3f> f(9000, Vector3f(0.5f, 1, 2));
+    assert(geom::reduce_sum(f.data(), f.size(), 2).equals({4500, 9000, 18000}));
+    std::vector<Vector3x> x(5000, Vector3x(0.25, -1, 2));
+    assert(geom::reduce_sum(x.data(), x.size(), 2).equals({1250, -5000, 10000}));
+    assert(geom::reduce_bounds(x.data(), x.size()).max.equals({0.25, -1, 2}));
+    std::cout << "Producto punto y otros tipos correctos\n";
+}
+
+int main() {
+    test_sum_mean();
+    test_thread_independence();
+    test_bounds_norms();
+    test_dot_types();
+
+    std::cout << "\nTodas las pruebas de reducciones pasaron correctamente\n";
+    return 0;
+}
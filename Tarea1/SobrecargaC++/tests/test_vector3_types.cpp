@@ -0,0 +1,95 @@
+#include "../src/vector3_batch.hpp"
+#include <cassert>
+#include <iostream>
+#include <cmath>
+#include <type_traits>
+#include <vector>
+
+// Vector3 sigue siendo el de doubles
+static_assert(std::is_same<Vector3, geom::Vector3<double>>::value, "Vector3 es Vector3<double>");
+static_assert(sizeof(Vector3f) == 3 * sizeof(float), "Vector3f sin relleno");
+static_assert(sizeof(Vector3x) == 3 * sizeof(std::int32_t), "Vector3x sin relleno");
+
+// Prueba de operaciones con float
+void test_float_vectors() {
+    Vector3f a(1, 2, 3);
+    Vector3f b(4, -5, 6);
+    assert((a + b).equals({5, -3, 9}));
+    assert((a * b).equals({27, 6, -13}));
+    assert(std::fabs((a % b) - 12.0f) < 1e-4f);
+    assert(std::fabs(&Vector3f(3, 4, 0) - 5.0f) < 1e-4f);
+    // La tolerancia por defecto de float es mas grande que la de double
+    assert(Vector3f(1, 2, 3).equals({1.00005f, 2.00005f, 3.00005f}));
+    assert(!Vector3(1, 2, 3).equals({1.00005, 2.00005, 3.00005}));
+    std::cout << "Vectores float correctos\n";
+}
+
+// Prueba de operaciones con punto fijo Q16.16
+void test_fixed_vectors() {
+    Vector3x a(1.5, 2, -3);
+    Vector3x b(0.25, 4, 1);
+    assert((a + b).equals({1.75, 6, -2}));
+    assert((a - b).equals({1.25, -2, -4}));
+    assert((a * 2).equals({3, 4, -6}));
+    assert((a / 2).equals({0.75, 1, -1.5}));
+    assert((a * b).equals({14, -2.25, 5.5}));       // producto cruz
+    assert((a % b).to_double() == 0.375 + 8 - 3);   // producto punto exacto
+    assert((&Vector3x(3, 4, 0)).to_double() == 5.0);
+    // La norma no desborda aunque x*x no entre en 32 bits
+    assert(std::fabs((&Vector3x(300, 400, 0)).to_double() - 500.0) < 1e-3);
+    assert(Vector3x(1, 2, 3).equals(Vector3x(1, 2, 3) + geom::Fixed32::from_raw(3)));
+    assert(!Vector3x(1, 2, 3).equals(Vector3x(1, 2, 3) + geom::Fixed32::from_raw(4)));
+    // Dividir por cero satura en vez de abortar; el vector cero normaliza a cero
+    using geom::Fixed32;
+    assert(Fixed32(3) / Fixed32() == Fixed32::from_raw(INT32_MAX));
+    assert(Fixed32(-3) / Fixed32() == Fixed32::from_raw(INT32_MIN));
+    assert(Fixed32() / Fixed32() == Fixed32());
+    assert(Fixed32(20000) / Fixed32(0.5) == Fixed32::from_raw(INT32_MAX));
+    assert(Vector3x().normalized().equals(Vector3x()));
+    assert(Vector3x().normalized_approx().equals(Vector3x()));
+    assert(Vector3x().norm_approx() == Fixed32());
+    geom::Vector3Batch<Fixed32> zeros(5), units;
+    batch_normalize(zeros, units);
+    for (std::size_t i = 0; i < units.size(); i++) assert(units.get(i).equals(Vector3x()));
+    std::cout << "Vectores de punto fijo correctos\n";
+}
+
+// Constexpr sigue funcionando con cada tipo
+static_assert((Vector3f(1, 0, 0) * Vector3f(0, 1, 0)).equals({0, 0, 1}), "cruz float");
+static_assert(Vector3f(3, 4, 0).norm_constexpr() == 5.0f, "norma float");
+static_assert(Vector3x(3, 4, 0).norm_constexpr() == geom::Fixed32(5), "norma fija");
+static_assert(geom::sqrt(geom::Fixed32(2.25)) == geom::Fixed32(1.5), "raiz fija");
+// Justo en el borde del formato la norma entra; pasado el borde satura
+static_assert(Vector3x(18918, 18918, 18918).norm_constexpr() > geom::Fixed32(32766), "norma en el borde");
+static_assert(Vector3x(30000, 30000, 30000).norm_constexpr() == Vector3x::traits::max_value(), "norma satura");
+static_assert(Vector3x(-32768, 0, 0).norm_constexpr() == Vector3x::traits::max_value(), "norma de -32768");
+static_assert(geom::sqrt(geom::Fixed32::from_raw(INT32_MAX)) > geom::Fixed32(181), "raiz del maximo");
+
+// Prueba de lotes con cada tipo contra el operador por objeto
+template <typename T>
+void check_batch_type(const char* name) {
+    geom::Vector3Batch<T> a, b, out;
+    for (int i = 0; i < 37; i++) {
+        a.push_back({T(i * 0.25), T(1 - i * 0.5), T(3)});
+        b.push_back({T(2), T(i * 0.125), T(-1 - i * 0.25)});
+    }
+    batch_cross(a, b, out);
+    std::vector<T> norms(a.size());
+    batch_norm(a, norms.data());
+    for (std::size_t i = 0; i < a.size(); i++) {
+        assert(out.get(i).equals(a.get(i) * b.get(i)));
+        assert(geom::Vector3<T>::abs_constexpr(norms[i] - &a.get(i)) < geom::Vector3Traits<T>::default_eps());
+    }
+    std::cout << "Lote de " << name << " correcto\n";
+}
+
+int main() {
+    test_float_vectors();
+    test_fixed_vectors();
+    check_batch_type<double>("double");
+    check_batch_type<float>("float");
+    check_batch_type<geom::Fixed32>("punto fijo");
+
+    std::cout << "\nTodas las pruebas de tipos pasaron correctamente\n";
+    return 0;
+}